@@ -0,0 +1,221 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QRandomGenerator>
+#include <QSet>
+#include <QTest>
+
+#include "../core/allocatedpixmapindex_p.h"
+#include "../core/observer.h"
+
+#include <list>
+
+class TestObserver : public Okular::DocumentObserver
+{
+public:
+    bool canUnloadPixmap(int page) const override
+    {
+        return !pinnedPages.contains(page);
+    }
+
+    QSet<int> pinnedPages;
+};
+
+// What DocumentPrivate::searchLowestPriorityPixmap used to do before the index
+static AllocatedPixmap *linearFarthestFrom(const std::list<AllocatedPixmap *> &pixmaps, int page, bool unloadableOnly, const Okular::DocumentObserver *observer)
+{
+    AllocatedPixmap *farthest = nullptr;
+    int maxDistance = -1;
+    for (AllocatedPixmap *p : pixmaps) {
+        if (observer == nullptr || p->observer == observer) {
+            const int distance = qAbs(p->page - page);
+            if (maxDistance < distance && (!unloadableOnly || p->observer->canUnloadPixmap(p->page))) {
+                maxDistance = distance;
+                farthest = p;
+            }
+        }
+    }
+    return farthest;
+}
+
+class AllocatedPixmapIndexTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testInsertFindRemove();
+    void testRemoveObserver();
+    void testFarthestFrom();
+    void testFarthestFromUnloadableOnly();
+    void testFarthestFromMatchesLinearScan();
+    void benchmarkLinearEviction();
+    void benchmarkIndexedEviction();
+
+private:
+    static constexpr int BenchmarkPixmaps = 10000;
+};
+
+void AllocatedPixmapIndexTest::testInsertFindRemove()
+{
+    TestObserver observer1;
+    TestObserver observer2;
+    Okular::AllocatedPixmapIndex index;
+    QVERIFY(index.isEmpty());
+
+    auto *p1 = new AllocatedPixmap(&observer1, 3, 100);
+    auto *p2 = new AllocatedPixmap(&observer2, 3, 200);
+    index.insert(p1);
+    index.insert(p2);
+    QCOMPARE(index.count(), 2);
+    QCOMPARE(index.find(&observer1, 3), p1);
+    QCOMPARE(index.find(&observer2, 3), p2);
+    QCOMPARE(index.find(&observer1, 4), nullptr);
+
+    index.remove(p1);
+    QCOMPARE(index.count(), 1);
+    QCOMPARE(index.find(&observer1, 3), nullptr);
+    QCOMPARE(index.find(&observer2, 3), p2);
+    delete p1;
+
+    index.clear();
+    QVERIFY(index.isEmpty());
+}
+
+void AllocatedPixmapIndexTest::testRemoveObserver()
+{
+    TestObserver observer1;
+    TestObserver observer2;
+    Okular::AllocatedPixmapIndex index;
+    for (int page = 0; page < 10; ++page) {
+        index.insert(new AllocatedPixmap(&observer1, page, 10));
+        index.insert(new AllocatedPixmap(&observer2, page, 1));
+    }
+
+    QCOMPARE(index.removeObserver(&observer1), qulonglong(100));
+    QCOMPARE(index.count(), 10);
+    QCOMPARE(index.find(&observer1, 5), nullptr);
+    QVERIFY(index.find(&observer2, 5));
+    QCOMPARE(index.farthestFrom(0, false, &observer1), nullptr);
+    QCOMPARE(index.farthestFrom(0, false)->observer, &observer2);
+    QCOMPARE(index.removeObserver(&observer1), qulonglong(0));
+}
+
+void AllocatedPixmapIndexTest::testFarthestFrom()
+{
+    TestObserver observer1;
+    TestObserver observer2;
+    Okular::AllocatedPixmapIndex index;
+    QCOMPARE(index.farthestFrom(0, false), nullptr);
+
+    for (int page : {2, 5, 8}) {
+        index.insert(new AllocatedPixmap(&observer1, page, 1));
+    }
+    index.insert(new AllocatedPixmap(&observer2, 20, 1));
+
+    QCOMPARE(index.farthestFrom(6, false)->page, 20);
+    QCOMPARE(index.farthestFrom(6, false, &observer1)->page, 2);
+    QCOMPARE(index.farthestFrom(3, false, &observer1)->page, 8);
+    // same distance on both sides, the lower page wins
+    QCOMPARE(index.farthestFrom(5, false, &observer1)->page, 2);
+}
+
+void AllocatedPixmapIndexTest::testFarthestFromUnloadableOnly()
+{
+    TestObserver observer;
+    Okular::AllocatedPixmapIndex index;
+    for (int page = 0; page < 10; ++page) {
+        index.insert(new AllocatedPixmap(&observer, page, 1));
+    }
+
+    observer.pinnedPages = {0, 1, 9};
+    QCOMPARE(index.farthestFrom(6, false)->page, 0);
+    QCOMPARE(index.farthestFrom(6, true)->page, 2);
+    QCOMPARE(index.farthestFrom(2, true)->page, 8);
+
+    for (int page = 0; page < 10; ++page) {
+        observer.pinnedPages.insert(page);
+    }
+    QCOMPARE(index.farthestFrom(6, true), nullptr);
+}
+
+void AllocatedPixmapIndexTest::testFarthestFromMatchesLinearScan()
+{
+    TestObserver observer1;
+    TestObserver observer2;
+    Okular::AllocatedPixmapIndex index;
+    std::list<AllocatedPixmap *> reference;
+    QRandomGenerator random(42);
+
+    for (int page = 0; page < 500; ++page) {
+        const int roll = random.bounded(4);
+        if (roll & 1) {
+            auto *p = new AllocatedPixmap(&observer1, page, 1);
+            index.insert(p);
+            reference.push_back(p);
+        }
+        if (roll & 2) {
+            auto *p = new AllocatedPixmap(&observer2, page, 1);
+            index.insert(p);
+            reference.push_back(p);
+        }
+        if (random.bounded(5) == 0) {
+            observer1.pinnedPages.insert(page);
+        }
+    }
+
+    // Distances are compared rather than descriptors since the two break ties differently
+    auto distance = [](const AllocatedPixmap *p, int page) { return p ? qAbs(p->page - page) : -1; };
+    for (int page = 0; page < 500; page += 7) {
+        for (const Okular::DocumentObserver *observer : {static_cast<Okular::DocumentObserver *>(nullptr), static_cast<Okular::DocumentObserver *>(&observer1)}) {
+            for (bool unloadableOnly : {false, true}) {
+                AllocatedPixmap *indexed = index.farthestFrom(page, unloadableOnly, observer);
+                AllocatedPixmap *linear = linearFarthestFrom(reference, page, unloadableOnly, observer);
+                QCOMPARE(distance(indexed, page), distance(linear, page));
+                if (indexed && unloadableOnly) {
+                    QVERIFY(indexed->observer->canUnloadPixmap(indexed->page));
+                }
+            }
+        }
+    }
+}
+
+void AllocatedPixmapIndexTest::benchmarkLinearEviction()
+{
+    TestObserver observer;
+    std::list<AllocatedPixmap *> pixmaps;
+    for (int page = 0; page < BenchmarkPixmaps; ++page) {
+        pixmaps.push_back(new AllocatedPixmap(&observer, page, 1));
+    }
+
+    int viewportPage = 0;
+    QBENCHMARK {
+        AllocatedPixmap *p = linearFarthestFrom(pixmaps, viewportPage, true, nullptr);
+        pixmaps.remove(p);
+        pixmaps.push_back(p);
+        viewportPage = (viewportPage + 97) % BenchmarkPixmaps;
+    }
+
+    qDeleteAll(pixmaps);
+}
+
+void AllocatedPixmapIndexTest::benchmarkIndexedEviction()
+{
+    TestObserver observer;
+    Okular::AllocatedPixmapIndex index;
+    for (int page = 0; page < BenchmarkPixmaps; ++page) {
+        index.insert(new AllocatedPixmap(&observer, page, 1));
+    }
+
+    int viewportPage = 0;
+    QBENCHMARK {
+        AllocatedPixmap *p = index.farthestFrom(viewportPage, true);
+        index.remove(p);
+        index.insert(p);
+        viewportPage = (viewportPage + 97) % BenchmarkPixmaps;
+    }
+}
+
+QTEST_MAIN(AllocatedPixmapIndexTest)
+#include "allocatedpixmapindextest.moc"
@@ -0,0 +1,248 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QImage>
+#include <QRandomGenerator>
+#include <QTest>
+
+#include "../gui/colorfilters.h"
+
+#include <functional>
+
+// The plain per pixel loops the filters used before they were vectorized, as reference
+
+static void referenceRecolor(QRgb *data, qsizetype count, const QColor &foreground, const QColor &background)
+{
+    const float scaleRed = background.redF() - foreground.redF();
+    const float scaleGreen = background.greenF() - foreground.greenF();
+    const float scaleBlue = background.blueF() - foreground.blueF();
+
+    for (qsizetype i = 0; i < count; ++i) {
+        const int lightness = qGray(data[i]);
+        const float r = scaleRed * lightness + foreground.red();
+        const float g = scaleGreen * lightness + foreground.green();
+        const float b = scaleBlue * lightness + foreground.blue();
+        data[i] = qRgba(r, g, b, qAlpha(data[i]));
+    }
+}
+
+static void referenceBlackWhite(QRgb *data, qsizetype count, int contrast, int threshold)
+{
+    const int thr = 255 - threshold;
+    for (qsizetype i = 0; i < count; ++i) {
+        int val = qGray(data[i]);
+        if (val > thr) {
+            val = 128 + (127 * (val - thr)) / (255 - thr);
+        } else if (val < thr) {
+            val = (128 * val) / thr;
+        }
+        if (contrast > 2) {
+            val = qBound(0, thr + (val - thr) * contrast / 2, 255);
+        }
+        data[i] = qRgba(val, val, val, qAlpha(data[i]));
+    }
+}
+
+static void referenceInvertLightness(QRgb *data, qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        uchar R = qRed(data[i]);
+        uchar G = qGreen(data[i]);
+        uchar B = qBlue(data[i]);
+        const uchar m = qMin(R, qMin(G, B));
+        R -= m;
+        G -= m;
+        B -= m;
+        const uchar C = qMax(R, qMax(G, B));
+        const uchar m_ = 255 - C - m;
+        data[i] = qRgba(R + m_, G + m_, B + m_, qAlpha(data[i]));
+    }
+}
+
+static void referenceInvertLuma(QRgb *data, qsizetype count, float Y_R, float Y_G, float Y_B)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        uchar R = qRed(data[i]);
+        uchar G = qGreen(data[i]);
+        uchar B = qBlue(data[i]);
+        ColorFilters::invertLumaPixel(R, G, B, Y_R, Y_G, Y_B);
+        data[i] = qRgba(R, G, B, qAlpha(data[i]));
+    }
+}
+
+static void referenceHueShiftPositive(QRgb *data, qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        data[i] = qRgba(qBlue(data[i]), qRed(data[i]), qGreen(data[i]), qAlpha(data[i]));
+    }
+}
+
+static void referenceHueShiftNegative(QRgb *data, qsizetype count)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        data[i] = qRgba(qGreen(data[i]), qBlue(data[i]), qRed(data[i]), qAlpha(data[i]));
+    }
+}
+
+using Filter = std::function<void(QRgb *, qsizetype)>;
+Q_DECLARE_METATYPE(Filter)
+Q_DECLARE_METATYPE(ColorFilters::Kernels)
+
+// every row runs with each of them, the ones the build or the CPU doesn't have are skipped
+static const QList<ColorFilters::Kernels> allKernels = {ColorFilters::PlainKernels, ColorFilters::Sse2Kernels, ColorFilters::Avx2Kernels, ColorFilters::NeonKernels};
+
+static const char *kernelsName(ColorFilters::Kernels kernels)
+{
+    switch (kernels) {
+    case ColorFilters::PlainKernels:
+        return "plain";
+    case ColorFilters::Sse2Kernels:
+        return "SSE2";
+    case ColorFilters::Avx2Kernels:
+        return "AVX2";
+    case ColorFilters::NeonKernels:
+        return "NEON";
+    }
+    return "";
+}
+
+class ColorFiltersTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testMatchesReference_data();
+    void testMatchesReference();
+    void benchmarkFilter_data();
+    void benchmarkFilter();
+    void benchmarkReference_data();
+    void benchmarkReference();
+
+private:
+    static void addFilters(const QList<ColorFilters::Kernels> &kernels);
+};
+
+// A page like image: runs of white and gray text pixels, with some colored pixels in between
+static QImage testImage(int width, int height)
+{
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    QRgb *data = reinterpret_cast<QRgb *>(image.bits());
+    QRandomGenerator random(42);
+    for (qsizetype i = 0; i < qsizetype(width) * height; ++i) {
+        const quint32 r = random.generate();
+        if (r % 64 == 0) {
+            data[i] = 0xff000000 | (r >> 8);
+        } else if (r % 64 < 8) {
+            data[i] = qRgb(r >> 24, r >> 24, r >> 24);
+        } else {
+            data[i] = qRgb(255, 255, 255);
+        }
+    }
+    // the special colors land at the start of the image, where the vector kernels see them
+    const QRgb special[] = {qRgb(0, 0, 0), qRgb(255, 255, 255), qRgb(255, 0, 0), qRgb(0, 255, 0), qRgb(0, 0, 255), qRgb(255, 255, 0), qRgb(1, 2, 3), qRgb(254, 253, 255), 0, qRgba(0, 0, 0, 128)};
+    for (qsizetype i = 0; i < qsizetype(std::size(special)) && i < qsizetype(width) * height; ++i) {
+        data[i] = special[i];
+    }
+    return image;
+}
+
+void ColorFiltersTest::addFilters(const QList<ColorFilters::Kernels> &kernels)
+{
+    QTest::addColumn<Filter>("filter");
+    QTest::addColumn<Filter>("reference");
+    QTest::addColumn<ColorFilters::Kernels>("kernels");
+
+    const QColor foreground(20, 40, 200);
+    const QColor background(250, 240, 180);
+    const std::pair<const char *, std::pair<Filter, Filter>> filters[] = {
+        {"recolor",
+         {[=](QRgb *data, qsizetype count) { ColorFilters::recolor(data, count, foreground, background); },
+          [=](QRgb *data, qsizetype count) { referenceRecolor(data, count, foreground, background); }}},
+        {"blackWhite", {[](QRgb *data, qsizetype count) { ColorFilters::blackWhite(data, count, 6, 100); }, [](QRgb *data, qsizetype count) { referenceBlackWhite(data, count, 6, 100); }}},
+        {"invertLightness", {ColorFilters::invertLightness, referenceInvertLightness}},
+        {"invertLuma",
+         {[](QRgb *data, qsizetype count) { ColorFilters::invertLuma(data, count, 0.2126, 0.7152, 0.0722); },
+          [](QRgb *data, qsizetype count) { referenceInvertLuma(data, count, 0.2126, 0.7152, 0.0722); }}},
+        {"hueShiftPositive", {ColorFilters::hueShiftPositive, referenceHueShiftPositive}},
+        {"hueShiftNegative", {ColorFilters::hueShiftNegative, referenceHueShiftNegative}},
+    };
+    for (const auto &[name, filter] : filters) {
+        for (const ColorFilters::Kernels k : kernels) {
+            QTest::addRow("%s %s", name, kernelsName(k)) << filter.first << filter.second << k;
+        }
+    }
+}
+
+void ColorFiltersTest::testMatchesReference_data()
+{
+    addFilters(allKernels);
+}
+
+void ColorFiltersTest::testMatchesReference()
+{
+    QFETCH(Filter, filter);
+    QFETCH(Filter, reference);
+    QFETCH(ColorFilters::Kernels, kernels);
+    if (!ColorFilters::setKernels(kernels)) {
+        QSKIP("This build or CPU doesn't have these kernels");
+    }
+
+    // odd sizes, so the plain loops have to finish what the vector kernels leave over
+    for (const int width : {1, 7, 33, 517}) {
+        QImage image = testImage(width, 13);
+        QImage expected = image.copy();
+        const qsizetype count = qsizetype(width) * 13;
+        filter(reinterpret_cast<QRgb *>(image.bits()), count);
+        reference(reinterpret_cast<QRgb *>(expected.bits()), count);
+
+        const QRgb *result = reinterpret_cast<const QRgb *>(image.constBits());
+        const QRgb *expectedResult = reinterpret_cast<const QRgb *>(expected.constBits());
+        for (qsizetype i = 0; i < count; ++i) {
+            QVERIFY2(result[i] == expectedResult[i], qPrintable(QStringLiteral("pixel %1: %2 instead of %3").arg(i).arg(result[i], 8, 16).arg(expectedResult[i], 8, 16)));
+        }
+    }
+}
+
+void ColorFiltersTest::benchmarkFilter_data()
+{
+    addFilters(allKernels);
+}
+
+void ColorFiltersTest::benchmarkFilter()
+{
+    QFETCH(Filter, filter);
+    QFETCH(ColorFilters::Kernels, kernels);
+    if (!ColorFilters::setKernels(kernels)) {
+        QSKIP("This build or CPU doesn't have these kernels");
+    }
+
+    // a 4K page, filtered once per frame
+    QImage image = testImage(3840, 2160);
+    QRgb *data = reinterpret_cast<QRgb *>(image.bits());
+    const qsizetype count = qsizetype(image.width()) * image.height();
+    QBENCHMARK {
+        filter(data, count);
+    }
+}
+
+void ColorFiltersTest::benchmarkReference_data()
+{
+    addFilters({ColorFilters::PlainKernels});
+}
+
+void ColorFiltersTest::benchmarkReference()
+{
+    QFETCH(Filter, reference);
+
+    QImage image = testImage(3840, 2160);
+    QRgb *data = reinterpret_cast<QRgb *>(image.bits());
+    const qsizetype count = qsizetype(image.width()) * image.height();
+    QBENCHMARK {
+        reference(data, count);
+    }
+}
+
+QTEST_MAIN(ColorFiltersTest)
+#include "colorfilterstest.moc"
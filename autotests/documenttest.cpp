@@ -8,6 +8,7 @@
 */
 
 #include <QMimeDatabase>
+#include <QPixmap>
 #include <QTemporaryFile>
 #include <QTest>
 
@@ -31,6 +32,8 @@ private Q_SLOTS:
     void testDocdataMigration();
     void testEvaluateKeystrokeEventChange_data();
     void testEvaluateKeystrokeEventChange();
+    void testDerivablePixmap();
+    void testPixmapRequestQueueStatistics();
 };
 
 // Test that we don't crash if the document is closed while a RotationJob
@@ -177,5 +180,63 @@ void DocumentTest::testEvaluateKeystrokeEventChange()
     QCOMPARE(Okular::DocumentPrivate::evaluateKeystrokeEventChange(oldVal, newVal, selStart, selEnd), expectedDiff);
 }
 
+// Test which of the pixmaps other observers have of a page a request gets scaled down from
+void DocumentTest::testDerivablePixmap()
+{
+    const QPixmap small(100, 150);
+    const QPixmap medium(200, 300);
+    const QPixmap large(400, 600);
+    const QPixmap landscape(600, 400);
+    const QPixmap roundedDown(201, 301);
+
+    // the smallest one that isn't smaller than the request
+    QCOMPARE(Okular::DocumentPrivate::derivablePixmap({&large, &medium, &small}, 150, 225), &medium);
+    QCOMPARE(Okular::DocumentPrivate::derivablePixmap({&large, &medium, &small}, 200, 300), &medium);
+    QCOMPARE(Okular::DocumentPrivate::derivablePixmap({&large, &medium, &small}, 100, 150), &small);
+
+    // never scaled up
+    QCOMPARE(Okular::DocumentPrivate::derivablePixmap({&medium, &small}, 300, 450), nullptr);
+
+    // the aspect ratio has to be the same, up to the rounding of the sizes
+    QCOMPARE(Okular::DocumentPrivate::derivablePixmap({&landscape}, 60, 40), &landscape);
+    QCOMPARE(Okular::DocumentPrivate::derivablePixmap({&landscape}, 40, 60), nullptr);
+    QCOMPARE(Okular::DocumentPrivate::derivablePixmap({&landscape, &large}, 40, 60), &large);
+    QCOMPARE(Okular::DocumentPrivate::derivablePixmap({&roundedDown}, 100, 150), &roundedDown);
+    QCOMPARE(Okular::DocumentPrivate::derivablePixmap({&medium}, 100, 120), nullptr);
+
+    QCOMPARE(Okular::DocumentPrivate::derivablePixmap({}, 100, 150), nullptr);
+}
+
+void DocumentTest::testPixmapRequestQueueStatistics()
+{
+    Okular::SettingsCore::instance(QStringLiteral("documenttest"));
+    Okular::Document document(nullptr);
+    const QString testFile = QStringLiteral(KDESRCDIR "data/file1.pdf");
+    QMimeDatabase db;
+    const QMimeType mime = db.mimeTypeForFile(testFile);
+
+    Okular::DocumentObserver observer;
+    document.addObserver(&observer);
+    QCOMPARE(document.openDocument(testFile, QUrl(), mime), Okular::Document::OpenSuccess);
+
+    // A synchronous request is sent right away
+    document.requestPixmaps({new Okular::PixmapRequest(&observer, 0, 100, 100, qApp->devicePixelRatio(), 1, Okular::PixmapRequest::NoFeature)});
+    QTRY_VERIFY(document.page(0)->hasPixmap(&observer));
+
+    QVariantMap statistics = document.metaData(QStringLiteral("PixmapRequestQueueStatistics")).toMap();
+    QCOMPARE(statistics.value(QStringLiteral("sent")).toULongLong(), qulonglong(1));
+    QCOMPARE(statistics.value(QStringLiteral("queued")).toInt(), 0);
+    QCOMPARE(statistics.value(QStringLiteral("peakQueued")).toInt(), 1);
+    QVERIFY(statistics.contains(QStringLiteral("discarded")));
+    QVERIFY(statistics.contains(QStringLiteral("maxWaitMs")));
+
+    // They describe the open document
+    document.closeDocument();
+    statistics = document.metaData(QStringLiteral("PixmapRequestQueueStatistics")).toMap();
+    QCOMPARE(statistics.value(QStringLiteral("sent")).toULongLong(), qulonglong(0));
+
+    document.removeObserver(&observer);
+}
+
 QTEST_MAIN(DocumentTest)
 #include "documenttest.moc"
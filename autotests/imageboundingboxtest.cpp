@@ -0,0 +1,135 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QImage>
+#include <QRandomGenerator>
+#include <QTest>
+
+#include "../core/area.h"
+#include "../core/utils.h"
+#include "../settings_core.h"
+
+// The bounding box of the non white pixels, the slow and obvious way
+static Okular::NormalizedRect referenceBoundingBox(const QImage &image)
+{
+    QRect box;
+    for (int y = 0; y < image.height(); ++y) {
+        for (int x = 0; x < image.width(); ++x) {
+            if ((image.pixel(x, y) & 0xFFFFFF) != 0xFFFFFF) {
+                box |= QRect(x, y, 1, 1);
+            }
+        }
+    }
+    if (box.isNull()) {
+        return Okular::NormalizedRect(0, 0, 0, 0);
+    }
+    return Okular::NormalizedRect(box, image.width(), image.height());
+}
+
+class ImageBoundingBoxTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void testBlank();
+    void testSinglePixel_data();
+    void testSinglePixel();
+    void testRandom_data();
+    void testRandom();
+    void benchmarkPage();
+};
+
+void ImageBoundingBoxTest::initTestCase()
+{
+    Okular::SettingsCore::instance(QStringLiteral("imageboundingboxtest"));
+}
+
+void ImageBoundingBoxTest::testBlank()
+{
+    QImage image(101, 57, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+    QCOMPARE(Okular::Utils::imageBoundingBox(&image), Okular::NormalizedRect(0, 0, 0, 0));
+    QCOMPARE(Okular::Utils::imageBoundingBox(nullptr), Okular::NormalizedRect());
+}
+
+void ImageBoundingBoxTest::testSinglePixel_data()
+{
+    QTest::addColumn<QPoint>("point");
+
+    QTest::newRow("top left") << QPoint(0, 0);
+    QTest::newRow("bottom right") << QPoint(100, 56);
+    QTest::newRow("middle") << QPoint(50, 20);
+    QTest::newRow("odd column") << QPoint(51, 33);
+}
+
+void ImageBoundingBoxTest::testSinglePixel()
+{
+    QFETCH(QPoint, point);
+
+    QImage image(101, 57, QImage::Format_RGB32);
+    image.fill(Qt::white);
+    image.setPixel(point, qRgb(0, 0, 0));
+    QCOMPARE(Okular::Utils::imageBoundingBox(&image), Okular::NormalizedRect(QRect(point, QSize(1, 1)), image.width(), image.height()));
+}
+
+void ImageBoundingBoxTest::testRandom_data()
+{
+    QTest::addColumn<QImage::Format>("format");
+
+    QTest::newRow("RGB32") << QImage::Format_RGB32;
+    QTest::newRow("ARGB32") << QImage::Format_ARGB32;
+    QTest::newRow("ARGB32_Premultiplied") << QImage::Format_ARGB32_Premultiplied;
+    QTest::newRow("RGB888") << QImage::Format_RGB888;
+    QTest::newRow("Grayscale8") << QImage::Format_Grayscale8;
+}
+
+void ImageBoundingBoxTest::testRandom()
+{
+    QFETCH(QImage::Format, format);
+
+    QRandomGenerator random(7);
+    for (int i = 0; i < 500; ++i) {
+        QImage image(1 + random.bounded(40), 1 + random.bounded(40), QImage::Format_ARGB32);
+        image.fill(Qt::white);
+        const int marks = random.bounded(5);
+        for (int m = 0; m < marks; ++m) {
+            // include transparent white and translucent pixels, alpha is not looked at
+            const QRgb colors[] = {qRgb(0, 0, 0), qRgba(255, 255, 255, 0), qRgba(255, 255, 255, 128), qRgba(10, 20, 30, 128), random.generate()};
+            image.setPixel(random.bounded(image.width()), random.bounded(image.height()), colors[random.bounded(5)]);
+        }
+        image = image.convertToFormat(format);
+        QCOMPARE(Okular::Utils::imageBoundingBox(&image), referenceBoundingBox(image));
+    }
+}
+
+void ImageBoundingBoxTest::benchmarkPage()
+{
+    // a letter page at 300 dpi, with lines of text of different lengths
+    QImage image(2550, 3300, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+    QRandomGenerator random(11);
+    for (int y = 300; y < 3000; y += 40) {
+        const int left = 300 + random.bounded(100);
+        const int right = 2250 - random.bounded(600);
+        for (int line = y; line < y + 20; ++line) {
+            QRgb *pixels = reinterpret_cast<QRgb *>(image.scanLine(line));
+            for (int x = left; x < right; ++x) {
+                if (random.bounded(3) == 0) {
+                    pixels[x] = qRgb(0, 0, 0);
+                }
+            }
+        }
+    }
+
+    Okular::NormalizedRect bbox;
+    QBENCHMARK {
+        bbox = Okular::Utils::imageBoundingBox(&image);
+    }
+    QCOMPARE(bbox, referenceBoundingBox(image));
+}
+
+QTEST_MAIN(ImageBoundingBoxTest)
+#include "imageboundingboxtest.moc"
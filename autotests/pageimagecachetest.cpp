@@ -0,0 +1,262 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTemporaryFile>
+#include <QTest>
+
+#include "../core/documenthash_p.h"
+#include "../core/pageimagecache_p.h"
+
+class PageImageCacheTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void init();
+    void testDocumentHash();
+    void testStoreAndLoad();
+    void testExcludedPages();
+    void testRenderSettingsInvalidate();
+    void testEviction();
+    void testMissingEntries();
+
+private:
+    static QString documentDirectory();
+    static QImage testImage();
+    static QImage loadEntry(Okular::PageImageCache *cache, const QString &entry);
+    void setDocument(Okular::PageImageCache *cache) const;
+
+    QTemporaryFile m_document;
+    QByteArray m_documentHash;
+};
+
+void PageImageCacheTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+
+    QVERIFY(m_document.open());
+    m_document.write("%PDF-1.4 not really a document");
+    m_document.flush();
+    m_documentHash = QCryptographicHash::hash("%PDF-1.4 not really a document", QCryptographicHash::Sha1);
+}
+
+void PageImageCacheTest::init()
+{
+    QDir(Okular::PageImageCache::cacheDirectory()).removeRecursively();
+}
+
+QString PageImageCacheTest::documentDirectory()
+{
+    return Okular::PageImageCache::cacheDirectory() + QStringLiteral("/30.document.pdf.pagecache");
+}
+
+QImage PageImageCacheTest::testImage()
+{
+    QImage image(60, 80, QImage::Format_RGB32);
+    image.fill(Qt::white);
+    for (int y = 20; y < 30; ++y) {
+        for (int x = 10; x < 50; ++x) {
+            image.setPixel(x, y, qRgb(0, 0, 0));
+        }
+    }
+    return image;
+}
+
+void PageImageCacheTest::setDocument(Okular::PageImageCache *cache) const
+{
+    cache->setDocument(documentDirectory(), QStringLiteral("settings"));
+    cache->setDocumentHash(m_documentHash);
+}
+
+void PageImageCacheTest::testDocumentHash()
+{
+    Okular::DocumentHash hash(m_document.fileName());
+    QSignalSpy finishedSpy(&hash, &Okular::DocumentHash::finished);
+    QVERIFY(finishedSpy.wait());
+    QVERIFY(hash.isFinished());
+    QCOMPARE(hash.result(), m_documentHash);
+    QCOMPARE(finishedSpy.at(0).at(0).toByteArray(), m_documentHash);
+
+    // A file that can't be read has no hash, and nothing is cached for it
+    Okular::DocumentHash missingHash(QStringLiteral("/nonexistent/document.pdf"));
+    QSignalSpy missingSpy(&missingHash, &Okular::DocumentHash::finished);
+    QVERIFY(missingSpy.wait());
+    QVERIFY(missingHash.result().isEmpty());
+}
+
+QImage PageImageCacheTest::loadEntry(Okular::PageImageCache *cache, const QString &entry)
+{
+    QImage loadedImage;
+    bool done = false;
+    const QMetaObject::Connection connection = connect(cache, &Okular::PageImageCache::loaded, cache, [&](Okular::PixmapRequest *, const QImage &image) {
+        loadedImage = image;
+        done = true;
+    });
+    cache->load(nullptr, entry, false);
+    QTest::qWaitFor([&done] { return done; });
+    disconnect(connection);
+    return loadedImage;
+}
+
+void PageImageCacheTest::testStoreAndLoad()
+{
+    const QString entry = Okular::PageImageCache::entryName(3, 60, 80, Okular::Rotation0, Okular::NormalizedRect());
+    const QString tileEntry = Okular::PageImageCache::entryName(3, 60, 80, Okular::Rotation0, Okular::NormalizedRect(0, 0, 0.5, 0.5));
+    QVERIFY(entry != tileEntry);
+
+    {
+        Okular::PageImageCache cache;
+        cache.setMaximumSize(1024 * 1024);
+        setDocument(&cache);
+        QVERIFY(cache.isActive(3));
+        QVERIFY(!cache.contains(entry));
+
+        cache.store(3, entry, testImage());
+        QVERIFY(cache.contains(entry));
+        QVERIFY(!cache.contains(tileEntry));
+    }
+
+    // A new session finds what the previous one stored
+    Okular::PageImageCache cache;
+    cache.setMaximumSize(1024 * 1024);
+    setDocument(&cache);
+    QVERIFY(cache.contains(entry));
+
+    const QImage image = loadEntry(&cache, entry);
+    QCOMPARE(image.convertToFormat(QImage::Format_RGB32), testImage());
+
+    // Missing entries load as a null image so the page gets rendered
+    QVERIFY(loadEntry(&cache, tileEntry).isNull());
+
+    // Synchronous requests read the entry right away
+    Okular::NormalizedRect boundingBox;
+    QCOMPARE(cache.read(entry, true, &boundingBox).convertToFormat(QImage::Format_RGB32), testImage());
+    QCOMPARE(boundingBox, Okular::NormalizedRect(QRect(10, 20, 40, 10), 60, 80));
+}
+
+void PageImageCacheTest::testExcludedPages()
+{
+    Okular::PageImageCache cache;
+    cache.setMaximumSize(1024 * 1024);
+    QVERIFY(!cache.isActive(0));
+
+    // nothing is looked up nor stored before the file is hashed, and what is excluded meanwhile stays excluded
+    cache.setDocument(documentDirectory(), QStringLiteral("settings"));
+    QVERIFY(!cache.isActive(0));
+    cache.excludePage(1);
+    cache.setDocumentHash(m_documentHash);
+    QVERIFY(cache.isActive(0));
+    QVERIFY(!cache.isActive(1));
+
+    const QString entry = Okular::PageImageCache::entryName(1, 60, 80, Okular::Rotation0, Okular::NormalizedRect());
+    cache.store(1, entry, testImage());
+    QVERIFY(!cache.contains(entry));
+
+    cache.setDocument(documentDirectory(), QString());
+    cache.setDocumentHash(m_documentHash);
+    QVERIFY(!cache.isActive(0));
+}
+
+void PageImageCacheTest::testRenderSettingsInvalidate()
+{
+    const QString entry = Okular::PageImageCache::entryName(0, 60, 80, Okular::Rotation90, Okular::NormalizedRect());
+    {
+        Okular::PageImageCache cache;
+        cache.setMaximumSize(1024 * 1024);
+        setDocument(&cache);
+        cache.store(0, entry, testImage());
+        QVERIFY(cache.contains(entry));
+
+        cache.setRenderSettings(QStringLiteral("other settings"));
+        QVERIFY(!cache.contains(entry));
+    }
+
+    Okular::PageImageCache cache;
+    setDocument(&cache);
+    QVERIFY(!cache.contains(entry));
+}
+
+void PageImageCacheTest::testEviction()
+{
+    const QString entry = Okular::PageImageCache::entryName(0, 60, 80, Okular::Rotation0, Okular::NormalizedRect());
+    {
+        Okular::PageImageCache cache;
+        setDocument(&cache);
+        cache.store(0, entry, testImage());
+    }
+    // The other files kept about the documents are not the cache's
+    const QString cacheDirectory = Okular::PageImageCache::cacheDirectory();
+    const QString otherFilePath = cacheDirectory + QStringLiteral("/other.png");
+    QImage(60, 80, QImage::Format_RGB32).save(otherFilePath);
+    QVERIFY(QDir(cacheDirectory).mkdir(QStringLiteral("other")));
+    {
+        Okular::PageImageCache cache;
+        setDocument(&cache);
+        QVERIFY(cache.contains(entry));
+
+        // Opening a document trims the cache
+        cache.setMaximumSize(10);
+        setDocument(&cache);
+    }
+
+    // Everything went over the limit, so everything was evicted
+    Okular::PageImageCache cache;
+    setDocument(&cache);
+    QVERIFY(!cache.contains(entry));
+    QVERIFY(QFile::exists(otherFilePath));
+    QVERIFY(QFileInfo(cacheDirectory + QStringLiteral("/other")).isDir());
+
+    // The entries evicted while the document is open are forgotten, so they get stored again
+    cache.setMaximumSize(1024 * 1024);
+    cache.store(0, entry, testImage());
+    QVERIFY(cache.contains(entry));
+    cache.setMaximumSize(10);
+    cache.store(1, Okular::PageImageCache::entryName(1, 60, 80, Okular::Rotation0, Okular::NormalizedRect()), testImage());
+    QTRY_VERIFY(!cache.contains(entry));
+}
+
+void PageImageCacheTest::testMissingEntries()
+{
+    const QString entry = Okular::PageImageCache::entryName(2, 60, 80, Okular::Rotation0, Okular::NormalizedRect());
+    const auto storeEntry = [this, &entry] {
+        Okular::PageImageCache cache;
+        cache.setMaximumSize(1024 * 1024);
+        setDocument(&cache);
+        cache.store(2, entry, testImage());
+    };
+    // The file goes away, e.g. evicted by another instance
+    const auto removeEntryFile = [] {
+        QDirIterator it(documentDirectory(), {QStringLiteral("*.png")}, QDir::Files, QDirIterator::Subdirectories);
+        return it.hasNext() && QFile::remove(it.next());
+    };
+
+    storeEntry();
+    Okular::PageImageCache cache;
+    cache.setMaximumSize(1024 * 1024);
+    setDocument(&cache);
+    QVERIFY(cache.contains(entry));
+    QVERIFY(removeEntryFile());
+    QVERIFY(loadEntry(&cache, entry).isNull());
+    QVERIFY(!cache.contains(entry));
+
+    storeEntry();
+    setDocument(&cache);
+    QVERIFY(cache.contains(entry));
+    QVERIFY(removeEntryFile());
+    Okular::NormalizedRect boundingBox;
+    QVERIFY(cache.read(entry, false, &boundingBox).isNull());
+    QVERIFY(!cache.contains(entry));
+}
+
+QTEST_MAIN(PageImageCacheTest)
+#include "pageimagecachetest.moc"
@@ -115,6 +115,8 @@ private Q_SLOTS:
     void testZoomInFacingPages();
     void testLinkWithCrop();
     void testFieldFormatting();
+    void testLateLoadedMovieAnnotation();
+    void testLazyFormWidgets();
 
 private:
     void simulateMouseSelection(double startX, double startY, double endX, double endY, QWidget *target);
@@ -2582,6 +2584,79 @@ void PartTest::testFieldFormatting()
     QCOMPARE(ff_sum->text(), QStringLiteral("1124469.1340000000782310962677002"));
 }
 
+void PartTest::testLateLoadedMovieAnnotation()
+{
+    // Big enough for the annotations to be loaded in the background and for the widgets of the pages to be created lazily
+    const QString testFile = QStringLiteral(KDESRCDIR "data/many_pages_with_movie.pdf");
+    Okular::Part part(nullptr, QVariantList());
+    part.openDocument(testFile);
+    part.widget()->resize(800, 600);
+    part.widget()->show();
+    if (qgetenv("KDECI_CANNOT_CREATE_WINDOWS") == "1") {
+        QSKIP("KDE CI can't create a window on this platform, skipping some gui tests");
+    }
+
+    QVERIFY(QTest::qWaitForWindowExposed(part.widget()));
+
+    const auto videoWidgetCount = [&part] {
+        const QList<QWidget *> children = part.m_pageView->viewport()->findChildren<QWidget *>(QString(), Qt::FindDirectChildrenOnly);
+        return static_cast<int>(std::count_if(children.cbegin(), children.cend(), [](const QWidget *w) { return w->inherits("VideoWidget"); }));
+    };
+    QCOMPARE(videoWidgetCount(), 0);
+
+    // The movie annotation is on the last page, the widgets of the page are created before it is loaded
+    const int lastPage = part.m_document->pages() - 1;
+    part.m_document->setViewportPage(lastPage);
+
+    QTRY_COMPARE(part.m_document->page(lastPage)->annotations().count(), 1);
+    QCOMPARE(part.m_document->page(lastPage)->annotations().constFirst()->subType(), Okular::Annotation::AMovie);
+    QTRY_COMPARE(videoWidgetCount(), 1);
+}
+
+void PartTest::testLazyFormWidgets()
+{
+    // Big enough for the widgets of the pages to be created lazily, each page has a text field
+    const QString testFile = QStringLiteral(KDESRCDIR "data/many_pages_with_forms.pdf");
+    Okular::Part part(nullptr, QVariantList());
+    part.openDocument(testFile);
+    part.widget()->resize(800, 600);
+    part.widget()->show();
+    if (qgetenv("KDECI_CANNOT_CREATE_WINDOWS") == "1") {
+        QSKIP("KDE CI can't create a window on this platform, skipping some gui tests");
+    }
+
+    QVERIFY(QTest::qWaitForWindowExposed(part.widget()));
+
+    // the fields of the pages without widgets yet are counted
+    QVERIFY(part.actionCollection()->action(QStringLiteral("view_toggle_forms"))->isEnabled());
+
+    const auto fieldWidget = [&part](int page) -> QLineEdit * {
+        const QList<QLineEdit *> lineEdits = part.m_pageView->viewport()->findChildren<QLineEdit *>(QString(), Qt::FindDirectChildrenOnly);
+        for (QLineEdit *lineEdit : lineEdits) {
+            if (lineEdit->text() == QStringLiteral("text %1").arg(page)) {
+                return lineEdit;
+            }
+        }
+        return nullptr;
+    };
+    QTRY_VERIFY(fieldWidget(0));
+    const int lastPage = part.m_document->pages() - 1;
+    QVERIFY(!fieldWidget(lastPage));
+
+    part.m_document->setViewportPage(lastPage);
+    QTRY_VERIFY(fieldWidget(lastPage));
+
+    // the widget of the far page can be filled
+    part.actionCollection()->action(QStringLiteral("view_toggle_forms"))->trigger();
+    QLineEdit *lineEdit = fieldWidget(lastPage);
+    QTRY_VERIFY(lineEdit->isVisible());
+    QVERIFY(!lineEdit->isReadOnly());
+    lineEdit->setFocus();
+    lineEdit->selectAll();
+    QTest::keyClicks(lineEdit, QStringLiteral("filled"));
+    QTRY_COMPARE(static_cast<Okular::FormFieldText *>(part.m_document->page(lastPage)->formFields().constFirst())->text(), QStringLiteral("filled"));
+}
+
 } // namespace Okular
 
 int main(int argc, char *argv[])
@@ -0,0 +1,166 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include "../core/generator.h"
+#include "../core/observer.h"
+#include "../core/pixmaprequestqueue_p.h"
+
+class PixmapRequestQueueTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testPriorityOrder();
+    void testNext();
+    void testDiscardObserverRequests();
+    void testDiscardObserverPages();
+    void testStatistics();
+
+private:
+    static Okular::PixmapRequest *request(Okular::DocumentObserver *observer, int page, int priority);
+};
+
+Okular::PixmapRequest *PixmapRequestQueueTest::request(Okular::DocumentObserver *observer, int page, int priority)
+{
+    return new Okular::PixmapRequest(observer, page, 100, 100, 1, priority, Okular::PixmapRequest::Asynchronous);
+}
+
+void PixmapRequestQueueTest::testPriorityOrder()
+{
+    Okular::DocumentObserver observer;
+    Okular::PixmapRequestQueue queue;
+    QCOMPARE(queue.top(), nullptr);
+
+    Okular::PixmapRequest *preload1 = request(&observer, 1, 3);
+    Okular::PixmapRequest *preload2 = request(&observer, 2, 3);
+    Okular::PixmapRequest *visible1 = request(&observer, 3, 0);
+    Okular::PixmapRequest *visible2 = request(&observer, 4, 0);
+    Okular::PixmapRequest *lowPriority = request(&observer, 5, 1);
+    for (Okular::PixmapRequest *r : {preload1, preload2, visible1, visible2, lowPriority}) {
+        queue.push(r);
+    }
+    QCOMPARE(queue.count(), 5);
+
+    // the newest priority zero request first, then the others oldest first
+    const QList<Okular::PixmapRequest *> expected = {visible2, visible1, lowPriority, preload1, preload2};
+    for (Okular::PixmapRequest *r : expected) {
+        QCOMPARE(queue.top(), r);
+        queue.take(r);
+        delete r;
+    }
+    QVERIFY(queue.isEmpty());
+}
+
+void PixmapRequestQueueTest::testNext()
+{
+    Okular::DocumentObserver observer;
+    Okular::PixmapRequestQueue queue;
+    Okular::PixmapRequest *preload = request(&observer, 1, 3);
+    Okular::PixmapRequest *visible = request(&observer, 2, 0);
+    Okular::PixmapRequest *lowPriority = request(&observer, 3, 1);
+    for (Okular::PixmapRequest *r : {preload, visible, lowPriority}) {
+        queue.push(r);
+    }
+
+    // the requests in the order top() gives them
+    QCOMPARE(queue.next(visible), lowPriority);
+    QCOMPARE(queue.next(lowPriority), preload);
+    QCOMPARE(queue.next(preload), nullptr);
+
+    // skipping a request leaves it queued, the one after it is taken
+    queue.take(lowPriority);
+    delete lowPriority;
+    QCOMPARE(queue.next(visible), preload);
+    QCOMPARE(queue.top(), visible);
+
+    Okular::PixmapRequest *notQueued = request(&observer, 4, 0);
+    QCOMPARE(queue.next(notQueued), nullptr);
+    delete notQueued;
+}
+
+void PixmapRequestQueueTest::testDiscardObserverRequests()
+{
+    Okular::DocumentObserver observer1;
+    Okular::DocumentObserver observer2;
+    Okular::PixmapRequestQueue queue;
+    for (int page = 0; page < 10; ++page) {
+        queue.push(request(&observer1, page, 0));
+        queue.push(request(&observer2, page, 1));
+    }
+
+    queue.discardRequests(&observer1);
+    QCOMPARE(queue.count(), 10);
+    QCOMPARE(queue.top()->observer(), &observer2);
+
+    queue.discardRequests(&observer1);
+    QCOMPARE(queue.count(), 10);
+}
+
+void PixmapRequestQueueTest::testDiscardObserverPages()
+{
+    Okular::DocumentObserver observer1;
+    Okular::DocumentObserver observer2;
+    Okular::PixmapRequestQueue queue;
+    for (int page = 0; page < 10; ++page) {
+        queue.push(request(&observer1, page, 1));
+        queue.push(request(&observer2, page, 1));
+    }
+    // tiles can queue several requests for the same page
+    queue.push(request(&observer1, 4, 1));
+
+    queue.discardRequests(&observer1, {4, 5, 42});
+    QCOMPARE(queue.count(), 18);
+    QVERIFY(!queue.hasRequests(&observer1, 4));
+    QVERIFY(queue.hasRequests(&observer1, 6));
+    QVERIFY(queue.hasRequests(&observer2, 4));
+
+    int observer1Requests = 0;
+    while (Okular::PixmapRequest *r = queue.top()) {
+        if (r->observer() == &observer1) {
+            QVERIFY(r->pageNumber() != 4 && r->pageNumber() != 5);
+            ++observer1Requests;
+        }
+        queue.discard(r);
+    }
+    QCOMPARE(observer1Requests, 8);
+}
+
+void PixmapRequestQueueTest::testStatistics()
+{
+    Okular::DocumentObserver observer;
+    Okular::PixmapRequestQueue queue;
+    for (int page = 0; page < 3; ++page) {
+        queue.push(request(&observer, page, 1));
+    }
+    QCOMPARE(queue.statistics().peakCount, 3);
+
+    QTest::qWait(20);
+    Okular::PixmapRequest *r = queue.top();
+    const qint64 wait = queue.take(r);
+    delete r;
+    QVERIFY(wait >= 10);
+    QCOMPARE(queue.statistics().takenCount, qulonglong(1));
+    QCOMPARE(queue.statistics().maxWait, wait);
+
+    // discarded requests don't count as sent
+    queue.discard(queue.top());
+    QCOMPARE(queue.statistics().takenCount, qulonglong(1));
+    QCOMPARE(queue.statistics().discardedCount, qulonglong(1));
+    QCOMPARE(queue.count(), 1);
+
+    queue.discardRequests(&observer);
+    QCOMPARE(queue.statistics().discardedCount, qulonglong(2));
+
+    queue.resetStatistics();
+    QCOMPARE(queue.statistics().peakCount, 0);
+    QCOMPARE(queue.statistics().takenCount, qulonglong(0));
+    QCOMPARE(queue.statistics().discardedCount, qulonglong(0));
+    QCOMPARE(queue.statistics().maxWait, qint64(0));
+}
+
+QTEST_MAIN(PixmapRequestQueueTest)
+#include "pixmaprequestqueuetest.moc"
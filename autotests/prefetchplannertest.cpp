@@ -0,0 +1,100 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QTest>
+
+#include "../part/prefetchplanner.h"
+
+class PrefetchPlannerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testIdle();
+    void testScrollingDown();
+    void testScrollingUp();
+    void testFastScrolling();
+    void testStop();
+};
+
+void PrefetchPlannerTest::testIdle()
+{
+    PrefetchPlanner planner;
+    QCOMPARE(planner.marginBefore(512), 512);
+    QCOMPARE(planner.marginAfter(512), 512);
+
+    planner.update(1000, 0);
+    planner.update(1000, 16);
+    QCOMPARE(planner.velocity(), 0.0);
+    QCOMPARE(planner.marginBefore(512), 512);
+    QCOMPARE(planner.marginAfter(512), 512);
+}
+
+void PrefetchPlannerTest::testScrollingDown()
+{
+    PrefetchPlanner planner;
+    for (int i = 0; i < 10; ++i) {
+        planner.update(i * 16, i * 16);
+    }
+    QCOMPARE(planner.velocity(), 1.0);
+    QCOMPARE(planner.marginAfter(512), 1012);
+    QCOMPARE(planner.marginBefore(512), 256);
+
+    // several events in the same msec are measured together with the next one
+    planner.update(150, 144);
+    QCOMPARE(planner.velocity(), 1.0);
+    planner.update(160, 160);
+    QCOMPARE(planner.velocity(), 1.0);
+}
+
+void PrefetchPlannerTest::testScrollingUp()
+{
+    PrefetchPlanner planner;
+    for (int i = 0; i < 10; ++i) {
+        planner.update(10000 - i * 16, i * 16);
+    }
+    QCOMPARE(planner.velocity(), -1.0);
+    QCOMPARE(planner.marginBefore(512), 1012);
+    QCOMPARE(planner.marginAfter(512), 256);
+
+    // turning around is followed right away
+    planner.update(10000 - 9 * 16 + 8, 10 * 16);
+    QCOMPARE(planner.velocity(), 0.5);
+    QVERIFY(planner.marginAfter(512) > 512);
+}
+
+void PrefetchPlannerTest::testFastScrolling()
+{
+    PrefetchPlanner planner;
+    for (int i = 0; i < 10; ++i) {
+        planner.update(i * 800, i * 16);
+    }
+    QCOMPARE(planner.velocity(), 50.0);
+    QCOMPARE(planner.marginBefore(512), 0);
+    // the margin ahead is bounded
+    QCOMPARE(planner.marginAfter(512), 512 * 11);
+}
+
+void PrefetchPlannerTest::testStop()
+{
+    PrefetchPlanner planner;
+    for (int i = 0; i < 10; ++i) {
+        planner.update(i * 16, i * 16);
+    }
+    QVERIFY(planner.velocity() > 0);
+
+    // a long pause means the view stopped in between
+    planner.update(200, 1000);
+    QCOMPARE(planner.velocity(), 0.0);
+    QCOMPARE(planner.marginAfter(512), 512);
+
+    planner.update(216, 1016);
+    planner.reset();
+    QCOMPARE(planner.velocity(), 0.0);
+    QCOMPARE(planner.marginBefore(512), 512);
+}
+
+QTEST_MAIN(PrefetchPlannerTest)
+#include "prefetchplannertest.moc"
@@ -6,12 +6,15 @@
 
 // clazy:excludeall=qstring-allocations
 
+#include <QFile>
 #include <QMimeDatabase>
 #include <QSignalSpy>
+#include <QTemporaryDir>
 #include <QTest>
 
 #include "../core/document.h"
 #include "../core/page.h"
+#include "../core/searchindex_p.h"
 #include "../core/textpage.h"
 #include "../settings_core.h"
 
@@ -41,15 +44,21 @@ private Q_SLOTS:
     void initTestCase();
     void testNextAndPrevious();
     void test311232();
+    void testRefinedSearch();
     void test323262();
     void test323263();
     void test430243();
     void testDottedI();
+    void testPartialMatches();
     void testHyphenAtEndOfLineWithoutYOverlap();
     void testHyphenWithYOverlap();
     void testHyphenAtEndOfPage();
+    void testSearchIndexTerms();
+    void testSearchIndexCandidatePages();
+    void testSearchIndexFile();
     void testOneColumn();
     void testTwoColumns();
+    void benchmarkCorrectTextOrder();
 };
 
 void SearchTest::initTestCase()
@@ -182,6 +191,39 @@ void SearchTest::test311232()
     QCOMPARE(receiver.m_status, Okular::Document::NoMatchFound);
 }
 
+void SearchTest::testRefinedSearch()
+{
+    Okular::Document d(nullptr);
+    SearchFinishedReceiver receiver;
+    QSignalSpy spy(&d, &Okular::Document::searchFinished);
+
+    QObject::connect(&d, &Okular::Document::searchFinished, &receiver, &SearchFinishedReceiver::searchFinished);
+
+    const QString testFile = QStringLiteral(KDESRCDIR "data/file1.pdf");
+    QMimeDatabase db;
+    const QMimeType mime = db.mimeTypeForFile(testFile);
+    d.openDocument(testFile, QUrl(), mime);
+
+    // each text contains the previous one, so it's only looked for on the pages the previous one matched
+    const int searchId = 0;
+    d.searchText(searchId, QStringLiteral("i"), true, Qt::CaseSensitive, Okular::Document::AllDocument, false, QColor(Qt::yellow));
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(receiver.m_status, Okular::Document::MatchFound);
+
+    d.searchText(searchId, QStringLiteral(" i "), true, Qt::CaseSensitive, Okular::Document::AllDocument, false, QColor(Qt::yellow));
+    QTRY_COMPARE(spy.count(), 2);
+    QCOMPARE(receiver.m_status, Okular::Document::MatchFound);
+
+    d.searchText(searchId, QStringLiteral(" i xyzzy"), true, Qt::CaseSensitive, Okular::Document::AllDocument, false, QColor(Qt::yellow));
+    QTRY_COMPARE(spy.count(), 3);
+    QCOMPARE(receiver.m_status, Okular::Document::NoMatchFound);
+
+    // going back to a shorter text searches the whole document again
+    d.searchText(searchId, QStringLiteral("i"), true, Qt::CaseSensitive, Okular::Document::AllDocument, false, QColor(Qt::yellow));
+    QTRY_COMPARE(spy.count(), 4);
+    QCOMPARE(receiver.m_status, Okular::Document::MatchFound);
+}
+
 void SearchTest::test323262()
 {
     QList<QString> text;
@@ -269,6 +311,38 @@ void SearchTest::testDottedI()
     delete page;
 }
 
+void SearchTest::testPartialMatches()
+{
+    // A match can start right after the start of a failed one, and span several words
+    QList<QString> text;
+    text << QStringLiteral("aa") << QStringLiteral("ab") << QStringLiteral(" ") << QStringLiteral("AAB");
+
+    QList<Okular::NormalizedRect> rect;
+    rect << Okular::NormalizedRect(0.1, 0.1, 0.2, 0.2) << Okular::NormalizedRect(0.2, 0.1, 0.3, 0.2) << Okular::NormalizedRect(0.3, 0.1, 0.4, 0.2) << Okular::NormalizedRect(0.4, 0.1, 0.5, 0.2);
+
+    CREATE_PAGE;
+
+    const QString searchString = QStringLiteral("aab");
+    const auto countMatches = [&](Okular::SearchDirection first, Okular::SearchDirection next, Qt::CaseSensitivity caseSensitivity) {
+        int count = 0;
+        Okular::RegularAreaRect *result = tp->findText(0, searchString, first, caseSensitivity, nullptr);
+        while (result) {
+            ++count;
+            Okular::RegularAreaRect *nextResult = tp->findText(0, searchString, next, caseSensitivity, result);
+            delete result;
+            result = nextResult;
+        }
+        return count;
+    };
+
+    QCOMPARE(countMatches(Okular::FromTop, Okular::NextResult, Qt::CaseSensitive), 1);
+    QCOMPARE(countMatches(Okular::FromTop, Okular::NextResult, Qt::CaseInsensitive), 2);
+    QCOMPARE(countMatches(Okular::FromBottom, Okular::PreviousResult, Qt::CaseSensitive), 1);
+    QCOMPARE(countMatches(Okular::FromBottom, Okular::PreviousResult, Qt::CaseInsensitive), 2);
+
+    delete page;
+}
+
 void SearchTest::testHyphenAtEndOfLineWithoutYOverlap()
 {
     QList<QString> text;
@@ -379,6 +453,111 @@ void SearchTest::testHyphenAtEndOfPage()
     delete page;
 }
 
+void SearchTest::testSearchIndexTerms()
+{
+    QList<QString> text;
+    text << QStringLiteral("Super-") << QStringLiteral("cali-\n") << QStringLiteral("fragilistic") << QStringLiteral(" ") << QStringLiteral("\uFB01ne");
+
+    QList<Okular::NormalizedRect> rect;
+    rect << Okular::NormalizedRect(0.4, 0.0, 0.9, 0.1) << Okular::NormalizedRect(0.0, 0.1, 0.6, 0.2) << Okular::NormalizedRect(0.0, 0.2, 0.8, 0.3) << Okular::NormalizedRect(0.8, 0.2, 0.9, 0.3) << Okular::NormalizedRect(0.0, 0.3, 0.8, 0.4);
+
+    CREATE_PAGE;
+
+    // the words split at the end of a line are terms too, the text is normalized and case folded like the searches do
+    const QSet<QString> pageTerms = Okular::SearchIndex::pageTerms(tp);
+    QVERIFY(pageTerms.contains(QStringLiteral("super")));
+    QVERIFY(pageTerms.contains(QStringLiteral("cali")));
+    QVERIFY(pageTerms.contains(QStringLiteral("supercalifragilistic")));
+    QVERIFY(pageTerms.contains(QStringLiteral("fine")));
+
+    QCOMPARE(Okular::SearchIndex::terms(QStringLiteral("Cali-Fragilistic  FINE")), QSet<QString>({QStringLiteral("cali"), QStringLiteral("fragilistic"), QStringLiteral("fine")}));
+    QVERIFY(Okular::SearchIndex::terms(QStringLiteral(" - ")).isEmpty());
+
+    delete page;
+}
+
+void SearchTest::testSearchIndexCandidatePages()
+{
+    // pages far apart so their differences take several varint bytes
+    const int pageCount = 20010;
+    const QList<QSet<QString>> indexedPageTerms = {
+        {QStringLiteral("supercalifragilistic"), QStringLiteral("fine")},
+        {QStringLiteral("fine")},
+    };
+
+    Okular::SearchIndex::Data data;
+    for (int page = 0; page < 20000; ++page) {
+        Okular::SearchIndex::addPage(data, page == 0 || page == 130 || page == 19000 ? indexedPageTerms.at(0) : page == 129 ? indexedPageTerms.at(1) : QSet<QString>());
+    }
+    QCOMPARE(data.indexedPages, 20000);
+
+    // the pages after the indexed ones are always candidates
+    const QList<int> unindexedPages = [] {
+        QList<int> pages;
+        for (int page = 20000; page < pageCount; ++page) {
+            pages << page;
+        }
+        return pages;
+    }();
+
+    // a term of the text can be part of a term of the page
+    QCOMPARE(Okular::SearchIndex::candidatePages(data, pageCount, {QStringLiteral("FRAGILISTIC")}, true), QList<int>({0, 130, 19000}) + unindexedPages);
+    QCOMPARE(Okular::SearchIndex::candidatePages(data, pageCount, {QStringLiteral("fine")}, true), QList<int>({0, 129, 130, 19000}) + unindexedPages);
+    QCOMPARE(Okular::SearchIndex::candidatePages(data, pageCount, {QStringLiteral("nowhere")}, true), unindexedPages);
+
+    // all the terms of a text have to be in the page
+    QCOMPARE(Okular::SearchIndex::candidatePages(data, pageCount, {QStringLiteral("fine cali")}, true), QList<int>({0, 130, 19000}) + unindexedPages);
+
+    // all the texts, or any of them
+    const QStringList texts = {QStringLiteral("cali"), QStringLiteral("fine")};
+    QCOMPARE(Okular::SearchIndex::candidatePages(data, pageCount, texts, true), QList<int>({0, 130, 19000}) + unindexedPages);
+    QCOMPARE(Okular::SearchIndex::candidatePages(data, pageCount, texts, false), QList<int>({0, 129, 130, 19000}) + unindexedPages);
+    QCOMPARE(Okular::SearchIndex::candidatePages(data, pageCount, {QStringLiteral("nowhere"), QStringLiteral("cali")}, false), QList<int>({0, 130, 19000}) + unindexedPages);
+
+    // a text without words can match anywhere
+    QCOMPARE(Okular::SearchIndex::candidatePages(data, pageCount, {QStringLiteral(" - ")}, true).count(), pageCount);
+
+    // nothing indexed yet, every page is a candidate
+    QCOMPARE(Okular::SearchIndex::candidatePages(Okular::SearchIndex::Data(), 3, {QStringLiteral("fine")}, true), QList<int>({0, 1, 2}));
+}
+
+void SearchTest::testSearchIndexFile()
+{
+    Okular::SearchIndex::Data data;
+    Okular::SearchIndex::addPage(data, {QStringLiteral("fine")});
+    Okular::SearchIndex::addPage(data, {});
+    Okular::SearchIndex::addPage(data, {QStringLiteral("fine"), QStringLiteral("cali")});
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString indexFilePath = dir.filePath(QStringLiteral("document.searchindex"));
+    const QByteArray documentHash = QByteArray(20, 'a');
+    QFile file(indexFilePath);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(Okular::SearchIndex::encodedIndex(data, documentHash, 5));
+    file.close();
+
+    const Okular::SearchIndex::Data readData = Okular::SearchIndex::readIndex(indexFilePath, documentHash, 5);
+    QCOMPARE(readData.indexedPages, 3);
+    QCOMPARE(readData.terms.count(), 2);
+    QCOMPARE(Okular::SearchIndex::candidatePages(readData, 5, {QStringLiteral("fine")}, true), QList<int>({0, 2, 3, 4}));
+    QCOMPARE(Okular::SearchIndex::candidatePages(readData, 5, {QStringLiteral("cali")}, true), QList<int>({2, 3, 4}));
+
+    // the index of another version of the document is not used
+    const Okular::SearchIndex::Data otherHashData = Okular::SearchIndex::readIndex(indexFilePath, QByteArray(20, 'b'), 5);
+    QCOMPARE(otherHashData.indexedPages, 0);
+    QVERIFY(otherHashData.terms.isEmpty());
+    const Okular::SearchIndex::Data otherPageCountData = Okular::SearchIndex::readIndex(indexFilePath, documentHash, 6);
+    QCOMPARE(otherPageCountData.indexedPages, 0);
+    QVERIFY(otherPageCountData.terms.isEmpty());
+
+    // nor is a truncated one
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() - 2));
+    file.close();
+    QVERIFY(Okular::SearchIndex::readIndex(indexFilePath, documentHash, 5).terms.isEmpty());
+}
+
 void SearchTest::testOneColumn()
 {
     // Tests that the layout analysis algorithm does not create too many columns.
@@ -426,5 +605,35 @@ void SearchTest::testTwoColumns()
     delete page;
 }
 
+void SearchTest::benchmarkCorrectTextOrder()
+{
+    // A dense table of 20000 characters, 100 lines of 40 words of 5 characters, given from the last line
+    constexpr int lineCount = 100;
+    constexpr int lineLength = 200;
+    QList<QString> text;
+    QList<Okular::NormalizedRect> rect;
+    for (int line = lineCount - 1; line >= 0; --line) {
+        for (int c = 0; c < lineLength; ++c) {
+            const double left = (c + c / 5) / 250.0;
+            const double top = line / 110.0;
+            text << QString(QLatin1Char('a' + c % 26));
+            rect << Okular::NormalizedRect(left, top, left + 1 / 250.0, top + 1 / 120.0);
+        }
+    }
+
+    QBENCHMARK {
+        CREATE_PAGE;
+        delete page;
+    }
+
+    CREATE_PAGE;
+
+    Okular::RegularAreaRect *result = tp->findText(0, QStringLiteral("abcde fghij klmno"), Okular::FromTop, Qt::CaseSensitive, nullptr);
+    QVERIFY(result);
+    delete result;
+
+    delete page;
+}
+
 QTEST_MAIN(SearchTest)
 #include "searchtest.moc"
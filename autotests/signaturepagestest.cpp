@@ -0,0 +1,147 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include <QMimeDatabase>
+#include <QStandardPaths>
+#include <QTemporaryFile>
+#include <QTest>
+
+#include <algorithm>
+
+#include "../settings_core.h"
+#include "core/document.h"
+#include <core/form.h>
+#include <core/page.h>
+
+class SignaturePagesTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void testPagelessSignatures();
+    void benchmarkManySignatures();
+
+private:
+    // A document whose first signatureCount pages have a signature field each, plus pagelessCount signatures on no page
+    static QByteArray generatePdf(int pageCount, int signatureCount, int pagelessCount);
+    static bool writeFile(QTemporaryFile *file, const QByteArray &contents);
+    int signatureCount(int page) const;
+
+    Okular::Document *m_document;
+    QMimeType m_pdfMime;
+};
+
+void SignaturePagesTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    Okular::SettingsCore::instance(QStringLiteral("signaturepagestest"));
+    m_document = new Okular::Document(nullptr);
+    m_pdfMime = QMimeDatabase().mimeTypeForName(QStringLiteral("application/pdf"));
+}
+
+void SignaturePagesTest::cleanupTestCase()
+{
+    delete m_document;
+}
+
+QByteArray SignaturePagesTest::generatePdf(int pageCount, int signatureCount, int pagelessCount)
+{
+    // 1 catalog, 2 page tree, 3 form, then the pages, the signatures on pages and the page-less ones
+    const int firstPage = 4;
+    const int firstSignature = firstPage + pageCount;
+    const int firstPagelessSignature = firstSignature + signatureCount;
+    const int objectCount = firstPagelessSignature + pagelessCount;
+
+    QList<QByteArray> objects(objectCount);
+    objects[1] = "<< /Type /Catalog /Pages 2 0 R /AcroForm 3 0 R >>";
+
+    QByteArray kids;
+    for (int i = 0; i < pageCount; ++i) {
+        kids += QByteArray::number(firstPage + i) + " 0 R ";
+    }
+    objects[2] = "<< /Type /Pages /Kids [" + kids + "] /Count " + QByteArray::number(pageCount) + " >>";
+
+    QByteArray fields;
+    for (int i = firstSignature; i < objectCount; ++i) {
+        fields += QByteArray::number(i) + " 0 R ";
+    }
+    objects[3] = "<< /Fields [" + fields + "] /SigFlags 1 >>";
+
+    for (int i = 0; i < pageCount; ++i) {
+        QByteArray page = "<< /Type /Page /Parent 2 0 R /MediaBox [0 0 200 200]";
+        if (i < signatureCount) {
+            page += " /Annots [" + QByteArray::number(firstSignature + i) + " 0 R]";
+        }
+        objects[firstPage + i] = page + " >>";
+    }
+    for (int i = 0; i < signatureCount; ++i) {
+        objects[firstSignature + i] = "<< /Type /Annot /Subtype /Widget /FT /Sig /T (signature" + QByteArray::number(i) + ") /Rect [10 10 60 30] /F 4 /P " + QByteArray::number(firstPage + i) + " 0 R >>";
+    }
+    for (int i = 0; i < pagelessCount; ++i) {
+        objects[firstPagelessSignature + i] = "<< /Type /Annot /Subtype /Widget /FT /Sig /T (pageless" + QByteArray::number(i) + ") /Rect [0 0 0 0] /F 4 >>";
+    }
+
+    QByteArray pdf = "%PDF-1.7\n";
+    QList<qsizetype> offsets(objectCount);
+    for (int i = 1; i < objectCount; ++i) {
+        offsets[i] = pdf.size();
+        pdf += QByteArray::number(i) + " 0 obj\n" + objects[i] + "\nendobj\n";
+    }
+
+    const qsizetype xrefOffset = pdf.size();
+    pdf += "xref\n0 " + QByteArray::number(objectCount) + "\n0000000000 65535 f \n";
+    for (int i = 1; i < objectCount; ++i) {
+        pdf += QByteArray::number(offsets[i]).rightJustified(10, '0') + " 00000 n \n";
+    }
+    pdf += "trailer\n<< /Size " + QByteArray::number(objectCount) + " /Root 1 0 R >>\nstartxref\n" + QByteArray::number(xrefOffset) + "\n%%EOF\n";
+    return pdf;
+}
+
+bool SignaturePagesTest::writeFile(QTemporaryFile *file, const QByteArray &contents)
+{
+    return file->open() && file->write(contents) == contents.size() && file->flush();
+}
+
+int SignaturePagesTest::signatureCount(int page) const
+{
+    const QList<Okular::FormField *> fields = m_document->page(page)->formFields();
+    return std::ranges::count(fields, Okular::FormField::FormSignature, &Okular::FormField::type);
+}
+
+void SignaturePagesTest::testPagelessSignatures()
+{
+    QTemporaryFile file(QStringLiteral("XXXXXX.pdf"));
+    QVERIFY(writeFile(&file, generatePdf(20, 10, 3)));
+    QCOMPARE(m_document->openDocument(file.fileName(), QUrl(), m_pdfMime), Okular::Document::OpenSuccess);
+    QCOMPARE(m_document->pages(), 20u);
+
+    // The page-less signatures go to the first page, the others stay where they are and aren't duplicated
+    QCOMPARE(signatureCount(0), 1 + 3);
+    for (int page = 1; page < 10; ++page) {
+        QCOMPARE(signatureCount(page), 1);
+    }
+    for (int page = 10; page < 20; ++page) {
+        QCOMPARE(signatureCount(page), 0);
+    }
+
+    m_document->closeDocument();
+}
+
+void SignaturePagesTest::benchmarkManySignatures()
+{
+    QTemporaryFile file(QStringLiteral("XXXXXX.pdf"));
+    QVERIFY(writeFile(&file, generatePdf(3000, 500, 50)));
+
+    QBENCHMARK {
+        QCOMPARE(m_document->openDocument(file.fileName(), QUrl(), m_pdfMime), Okular::Document::OpenSuccess);
+        m_document->closeDocument();
+    }
+}
+
+QTEST_MAIN(SignaturePagesTest)
+#include "signaturepagestest.moc"
@@ -5,7 +5,10 @@
 
 #include <QTest>
 
+#include <climits>
+
 #include "../core/area.h"
+#include "../core/layoutblockindex_p.h"
 #include "../core/misc.h"
 #include "../core/page.h"
 #include "../core/textpage.h"
@@ -31,6 +34,7 @@ private Q_SLOTS:
     void testCrossBlockSelectionWithFullWidthBlocks();
     void testCrossBlockSelectionReadingOrderJump();
     void testCrossBlockSelectionLinePrecision();
+    void testLayoutBlockIndex();
 };
 
 void TextPageBlockTest::testLayoutBlockDefaultConstructor()
@@ -619,5 +623,43 @@ void TextPageBlockTest::testCrossBlockSelectionLinePrecision()
     }
 }
 
+void TextPageBlockTest::testLayoutBlockIndex()
+{
+    // A grid of 20x20 blocks, with every fifth one covering the block at its right too
+    QList<Okular::LayoutBlock> blocks;
+    for (int row = 0; row < 20; ++row) {
+        for (int column = 0; column < 20; ++column) {
+            const int order = row * 20 + column;
+            const double right = (order % 5 == 0) ? (column + 2) / 20.0 : (column + 1) / 20.0;
+            blocks.append(Okular::LayoutBlock(QString::number(order), 0, Okular::NormalizedRect(column / 20.0, row / 20.0, right, (row + 1) / 20.0), QStringLiteral("TEXT"), order, 1.0));
+        }
+    }
+    blocks.append(Okular::LayoutBlock(QStringLiteral("outside"), 0, Okular::NormalizedRect(1.2, 1.2, 1.5, 1.5), QStringLiteral("TEXT"), 400, 1.0));
+
+    const Okular::LayoutBlockIndex index(blocks);
+
+    // The same blocks as going through all of them, the first one in the list when several contain the point
+    const auto firstContaining = [&blocks](double x, double y, int minOrder, int maxOrder) -> qsizetype {
+        for (qsizetype i = 0; i < blocks.count(); ++i) {
+            if (blocks.at(i).readingOrder >= minOrder && blocks.at(i).readingOrder <= maxOrder && blocks.at(i).contains(Okular::NormalizedPoint(x, y))) {
+                return i;
+            }
+        }
+        return -1;
+    };
+    for (int i = -10; i <= 310; ++i) {
+        const double x = i / 200.0;
+        const double y = (i * 37 % 320 - 10) / 200.0;
+        QCOMPARE(index.blockContaining(x, y), firstContaining(x, y, INT_MIN, INT_MAX));
+        QCOMPARE(index.blockContaining(x, y, 101, 250), firstContaining(x, y, 101, 250));
+    }
+    QCOMPARE(index.blockContaining(1.3, 1.3), qsizetype(400));
+    QCOMPARE(index.blockContaining(0.025, 1.3), qsizetype(-1));
+
+    QCOMPARE(index.blockWithReadingOrder(42), qsizetype(42));
+    QCOMPARE(index.blockWithReadingOrder(401), qsizetype(-1));
+    QCOMPARE(Okular::LayoutBlockIndex().blockContaining(0.5, 0.5), qsizetype(-1));
+}
+
 QTEST_MAIN(TextPageBlockTest)
 #include "textpageblocktest.moc"
@@ -0,0 +1,138 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "allocatedpixmapindex_p.h"
+
+#include "observer.h"
+
+#include <iterator>
+
+using namespace Okular;
+
+/* Returns the pixmap of [begin, end) (sorted by page, with size elements)
+ * farthest from page. Since the distance to page is convex along a sorted
+ * range, the farthest element is at one of the ends; when it is rejected
+ * because it can't be unloaded we move that end inward and look again.
+ */
+template<typename Iterator>
+static AllocatedPixmap *farthestInRange(Iterator begin, Iterator end, size_t size, int page, bool unloadableOnly)
+{
+    if (size == 0) {
+        return nullptr;
+    }
+
+    Iterator low = begin;
+    Iterator high = std::prev(end);
+    for (size_t remaining = size; remaining > 0; --remaining) {
+        AllocatedPixmap *lowPixmap = low->second;
+        AllocatedPixmap *highPixmap = high->second;
+        // on equal distance prefer the lower page
+        const bool takeLow = qAbs(lowPixmap->page - page) >= qAbs(highPixmap->page - page);
+        AllocatedPixmap *candidate = takeLow ? lowPixmap : highPixmap;
+        if (!unloadableOnly || candidate->observer->canUnloadPixmap(candidate->page)) {
+            return candidate;
+        }
+        if (takeLow) {
+            ++low;
+        } else {
+            --high;
+        }
+    }
+
+    return nullptr;
+}
+
+AllocatedPixmapIndex::AllocatedPixmapIndex()
+{
+}
+
+AllocatedPixmapIndex::~AllocatedPixmapIndex()
+{
+    clear();
+}
+
+void AllocatedPixmapIndex::insert(AllocatedPixmap *pixmap)
+{
+    Q_ASSERT(!find(pixmap->observer, pixmap->page));
+    m_byPage.emplace(std::make_pair(pixmap->page, quintptr(pixmap->observer)), pixmap);
+    m_byObserver[pixmap->observer].emplace(pixmap->page, pixmap);
+}
+
+AllocatedPixmap *AllocatedPixmapIndex::find(const DocumentObserver *observer, int page) const
+{
+    const auto observerIt = m_byObserver.find(observer);
+    if (observerIt == m_byObserver.end()) {
+        return nullptr;
+    }
+
+    const auto pixmapIt = observerIt->second.find(page);
+    return pixmapIt != observerIt->second.end() ? pixmapIt->second : nullptr;
+}
+
+void AllocatedPixmapIndex::remove(AllocatedPixmap *pixmap)
+{
+    m_byPage.erase(std::make_pair(pixmap->page, quintptr(pixmap->observer)));
+
+    const auto observerIt = m_byObserver.find(pixmap->observer);
+    if (observerIt != m_byObserver.end()) {
+        observerIt->second.erase(pixmap->page);
+        if (observerIt->second.empty()) {
+            m_byObserver.erase(observerIt);
+        }
+    }
+}
+
+qulonglong AllocatedPixmapIndex::removeObserver(const DocumentObserver *observer)
+{
+    const auto observerIt = m_byObserver.find(observer);
+    if (observerIt == m_byObserver.end()) {
+        return 0;
+    }
+
+    qulonglong memory = 0;
+    for (const auto &[page, pixmap] : observerIt->second) {
+        m_byPage.erase(std::make_pair(page, quintptr(observer)));
+        memory += pixmap->memory;
+        delete pixmap;
+    }
+    m_byObserver.erase(observerIt);
+
+    return memory;
+}
+
+AllocatedPixmap *AllocatedPixmapIndex::farthestFrom(int page, bool unloadableOnly, const DocumentObserver *observer) const
+{
+    if (!observer) {
+        return farthestInRange(m_byPage.begin(), m_byPage.end(), m_byPage.size(), page, unloadableOnly);
+    }
+
+    const auto observerIt = m_byObserver.find(observer);
+    if (observerIt == m_byObserver.end()) {
+        return nullptr;
+    }
+
+    const ObserverPageMap &pages = observerIt->second;
+    return farthestInRange(pages.begin(), pages.end(), pages.size(), page, unloadableOnly);
+}
+
+void AllocatedPixmapIndex::clear()
+{
+    for (const auto &[key, pixmap] : m_byPage) {
+        delete pixmap;
+    }
+    m_byPage.clear();
+    m_byObserver.clear();
+}
+
+bool AllocatedPixmapIndex::isEmpty() const
+{
+    return m_byPage.empty();
+}
+
+int AllocatedPixmapIndex::count() const
+{
+    return static_cast<int>(m_byPage.size());
+}
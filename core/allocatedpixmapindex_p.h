@@ -0,0 +1,104 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef _OKULAR_ALLOCATEDPIXMAPINDEX_P_H_
+#define _OKULAR_ALLOCATEDPIXMAPINDEX_P_H_
+
+#include "okularcore_export.h"
+
+#include <QtGlobal>
+
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+namespace Okular
+{
+class DocumentObserver;
+}
+
+struct AllocatedPixmap {
+    // owner of the page
+    Okular::DocumentObserver *observer;
+    int page;
+    qulonglong memory;
+    // public constructor: initialize data
+    AllocatedPixmap(Okular::DocumentObserver *o, int p, qulonglong m)
+        : observer(o)
+        , page(p)
+        , memory(m)
+    {
+    }
+};
+
+namespace Okular
+{
+/**
+ * The memory allocation descriptors of the document, indexed by observer and
+ * page.
+ *
+ * Descriptors are kept sorted by page number, both globally and per observer.
+ * The pixmap farthest from a given page is always at one of the two ends of
+ * a sorted range, so lookups, removals and eviction queries are logarithmic
+ * instead of a walk over every allocated pixmap.
+ *
+ * The index owns the descriptors it holds.
+ */
+class OKULARCORE_EXPORT AllocatedPixmapIndex
+{
+public:
+    AllocatedPixmapIndex();
+    ~AllocatedPixmapIndex();
+
+    AllocatedPixmapIndex(const AllocatedPixmapIndex &) = delete;
+    AllocatedPixmapIndex &operator=(const AllocatedPixmapIndex &) = delete;
+
+    /**
+     * Adds @p pixmap to the index, there must not be a descriptor for the same observer and page already.
+     */
+    void insert(AllocatedPixmap *pixmap);
+
+    /**
+     * Returns the descriptor of @p page for @p observer, or nullptr.
+     */
+    AllocatedPixmap *find(const DocumentObserver *observer, int page) const;
+
+    /**
+     * Removes @p pixmap from the index without deleting it.
+     */
+    void remove(AllocatedPixmap *pixmap);
+
+    /**
+     * Deletes all the descriptors of @p observer and returns the memory they accounted for.
+     */
+    qulonglong removeObserver(const DocumentObserver *observer);
+
+    /**
+     * Returns the descriptor whose page is the farthest from @p page, considering only the ones of @p observer
+     * if it is not null. If @p unloadableOnly is set, only pixmaps their observer can unload are returned.
+     */
+    AllocatedPixmap *farthestFrom(int page, bool unloadableOnly, const DocumentObserver *observer = nullptr) const;
+
+    /**
+     * Deletes all the descriptors.
+     */
+    void clear();
+
+    bool isEmpty() const;
+    int count() const;
+
+private:
+    // the observer is part of the key only to tell apart pixmaps of the same page
+    typedef std::map<std::pair<int, quintptr>, AllocatedPixmap *> PageMap;
+    typedef std::map<int, AllocatedPixmap *> ObserverPageMap;
+
+    PageMap m_byPage;
+    std::unordered_map<const DocumentObserver *, ObserverPageMap> m_byObserver;
+};
+
+}
+
+#endif
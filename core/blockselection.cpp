@@ -9,7 +9,9 @@
 #include <climits>
 
 #include <QtAlgorithms>
-#include <limits>
+
+#include "blockselection_p.h"
+#include "layoutblockindex_p.h"
 
 using namespace Okular;
 
@@ -134,30 +136,8 @@ bool BlockSelectionHelper::isEntityInAnyBlock(const NormalizedRect &entityArea,
 
 const TextEntity *BlockSelectionHelper::findNearestEntityInBlock(const TextEntity::List &words, const LayoutBlock *block, const NormalizedPoint &p)
 {
-    if (!block) {
-        return nullptr;
-    }
-
-    const TextEntity *best = nullptr;
-    double bestDist = std::numeric_limits<double>::max();
-    for (auto it = words.constBegin(); it != words.constEnd(); ++it) {
-        if (!block->contains(it->area())) {
-            continue;
-        }
-
-        const NormalizedRect area = it->area();
-        const double cx = (area.left + area.right) / 2.0;
-        const double cy = (area.top + area.bottom) / 2.0;
-        const double dx = cx - p.x;
-        const double dy = cy - p.y;
-        const double dist = (dx * dx) + (dy * dy);
-        if (dist < bestDist) {
-            bestDist = dist;
-            best = &(*it);
-        }
-    }
-
-    return best;
+    const auto it = BlockSelection::findNearestEntityInBlock(words, block, p);
+    return it != words.constEnd() ? &(*it) : nullptr;
 }
 
 static bool isSameLine(const NormalizedRect &entityArea, const NormalizedRect &lineArea)
@@ -193,58 +173,13 @@ bool BlockSelectionHelper::isBeforeCursor(const NormalizedRect &entityArea, cons
 
 QString BlockSelectionHelper::extractTextInReadingOrder(const TextEntity::List &words, const QList<LayoutBlock> &blocks, const RegularAreaRect *area, bool useIntersects)
 {
-    // Collect matching entities grouped by block
-    QMap<int, QList<const TextEntity *>> entitiesByBlock; // reading order -> entities
-
-    for (auto it = words.constBegin(); it != words.constEnd(); ++it) {
-        bool matches = false;
-        if (useIntersects) {
-            matches = area->intersects(it->area());
-        } else {
-            NormalizedPoint center = it->area().center();
-            matches = area->contains(center.x, center.y);
-        }
-
-        if (matches) {
-            // Find which block this entity belongs to
-            int blockOrder = -1;
-            for (const LayoutBlock &block : blocks) {
-                if (block.contains(it->area())) {
-                    blockOrder = block.readingOrder;
-                    break;
-                }
-            }
-
-            if (blockOrder >= 0) {
-                entitiesByBlock[blockOrder].append(&(*it));
-            } else {
-                // Entity not in any block - use a very high order
-                entitiesByBlock[999999].append(&(*it));
-            }
-        }
-    }
-
-    // Sort entities within each block by geometric position (Y, then X)
-    for (auto &entities : entitiesByBlock) {
-        std::sort(entities.begin(), entities.end(), [](const TextEntity *a, const TextEntity *b) {
-            double aY = (a->area().top + a->area().bottom) / 2.0;
-            double bY = (b->area().top + b->area().bottom) / 2.0;
-            if (qAbs(aY - bY) > 0.01) {
-                return aY < bY; // Sort by Y first
-            }
-            return a->area().left < b->area().left; // Then by X
-        });
-    }
-
-    // Concatenate text in reading order
-    QString result;
-    for (auto it = entitiesByBlock.constBegin(); it != entitiesByBlock.constEnd(); ++it) {
-        for (const TextEntity *entity : it.value()) {
-            result += entity->text();
-        }
-    }
-
-    return result;
+    const LayoutBlockIndex blockIndex(blocks);
+    auto blockContaining = [&blocks, &blockIndex](const NormalizedRect &entityArea) -> const LayoutBlock * {
+        // the block containing the center of the entity
+        const qsizetype index = blockIndex.blockContaining((entityArea.left + entityArea.right) / 2.0, (entityArea.top + entityArea.bottom) / 2.0);
+        return index >= 0 ? &blocks.at(index) : nullptr;
+    };
+    return BlockSelection::extractTextInReadingOrder(words, blockContaining, area, useIntersects);
 }
 
 QStringList BlockSelectionHelper::getBlockIdsForSelection(const QList<LayoutBlock> &blocks, const NormalizedPoint &selectionStart, const NormalizedPoint &selectionEnd)
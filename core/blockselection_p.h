@@ -0,0 +1,122 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef _OKULAR_BLOCKSELECTION_P_H_
+#define _OKULAR_BLOCKSELECTION_P_H_
+
+#include <QList>
+#include <QMap>
+#include <QString>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "area.h"
+
+namespace Okular
+{
+/*
+ * The block selection helpers working on any list of words, a TextEntity::List
+ * for BlockSelectionHelper or the TextEntityStore of a text page: anything
+ * walked with constBegin()/constEnd() whose entries have area() and text().
+ */
+namespace BlockSelection
+{
+/**
+ * The word of @p words nearest to @p p within @p block, words.constEnd() if there's none.
+ */
+template<typename Words>
+auto findNearestEntityInBlock(const Words &words, const LayoutBlock *block, const NormalizedPoint &p)
+{
+    auto best = words.constEnd();
+    if (!block) {
+        return best;
+    }
+
+    double bestDist = std::numeric_limits<double>::max();
+    for (auto it = words.constBegin(); it != words.constEnd(); ++it) {
+        const NormalizedRect area = it->area();
+        if (!block->contains(area)) {
+            continue;
+        }
+
+        const double cx = (area.left + area.right) / 2.0;
+        const double cy = (area.top + area.bottom) / 2.0;
+        const double dx = cx - p.x;
+        const double dy = cy - p.y;
+        const double dist = (dx * dx) + (dy * dy);
+        if (dist < bestDist) {
+            bestDist = dist;
+            best = it;
+        }
+    }
+
+    return best;
+}
+
+/**
+ * The text of the words of @p words in @p area, block after block in reading order.
+ * @p blockContaining gives the block a word area belongs to, or nullptr.
+ */
+template<typename Words, typename BlockContaining>
+QString extractTextInReadingOrder(const Words &words, BlockContaining blockContaining, const RegularAreaRect *area, bool useIntersects)
+{
+    using ConstIterator = decltype(words.constBegin());
+
+    // Collect matching entities grouped by block
+    QMap<int, QList<ConstIterator>> entitiesByBlock; // reading order -> entities
+
+    for (auto it = words.constBegin(); it != words.constEnd(); ++it) {
+        const NormalizedRect entityArea = it->area();
+        bool matches = false;
+        if (useIntersects) {
+            matches = area->intersects(entityArea);
+        } else {
+            NormalizedPoint center = entityArea.center();
+            matches = area->contains(center.x, center.y);
+        }
+
+        if (matches) {
+            // Find which block this entity belongs to
+            const LayoutBlock *block = blockContaining(entityArea);
+            const int blockOrder = block ? block->readingOrder : -1;
+
+            // Entities not in any block use a very high order
+            entitiesByBlock[blockOrder >= 0 ? blockOrder : 999999].append(it);
+        }
+    }
+
+    // Sort entities within each block by geometric position (Y, then X)
+    for (auto &entities : entitiesByBlock) {
+        std::sort(entities.begin(), entities.end(), [](const ConstIterator &a, const ConstIterator &b) {
+            const NormalizedRect aArea = a->area();
+            const NormalizedRect bArea = b->area();
+            double aY = (aArea.top + aArea.bottom) / 2.0;
+            double bY = (bArea.top + bArea.bottom) / 2.0;
+            if (qAbs(aY - bY) > 0.01) {
+                return aY < bY; // Sort by Y first
+            }
+            return aArea.left < bArea.left; // Then by X
+        });
+    }
+
+    // Concatenate text in reading order
+    QString result;
+    for (const auto &entities : std::as_const(entitiesByBlock)) {
+        for (const ConstIterator &entity : entities) {
+            result += entity->text();
+        }
+    }
+
+    return result;
+}
+
+}
+
+}
+
+#endif
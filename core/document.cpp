@@ -13,8 +13,10 @@
 #include "documentcommands_p.h"
 
 #include <algorithm>
+#include <cmath>
 #include <limits.h>
 #include <memory>
+#include <optional>
 #ifdef Q_OS_WIN
 #include <qt_windows.h>
 #elif defined(Q_OS_FREEBSD)
@@ -72,6 +74,7 @@
 #include "bookmarkmanager.h"
 #include "chooseenginedialog_p.h"
 #include "debug_p.h"
+#include "documenthash_p.h"
 #include "form.h"
 #include "generator_p.h"
 #include "interfaces/configinterface.h"
@@ -83,12 +86,16 @@
 #include "page.h"
 #include "page_p.h"
 #include "pagecontroller_p.h"
+#include "pageimagecache_p.h"
+#include "pixmapscalejob_p.h"
 #include "script/event_p.h"
 #include "scripter.h"
+#include "searchindex_p.h"
 #include "settings_core.h"
 #include "sourcereference.h"
 #include "sourcereference_p.h"
 #include "texteditors_p.h"
+#include "textsearchjob_p.h"
 #include "tile.h"
 #include "tilesmanager_p.h"
 #include "utils.h"
@@ -104,20 +111,6 @@
 
 using namespace Okular;
 
-struct AllocatedPixmap {
-    // owner of the page
-    DocumentObserver *observer;
-    int page;
-    qulonglong memory;
-    // public constructor: initialize data
-    AllocatedPixmap(DocumentObserver *o, int p, qulonglong m)
-        : observer(o)
-        , page(p)
-        , memory(m)
-    {
-    }
-};
-
 struct ArchiveData {
     ArchiveData()
     {
@@ -140,8 +133,67 @@ struct RunningSearch {
     Qt::CaseSensitivity cachedCaseSensitivity;
     bool cachedViewportMove : 1;
     bool isCurrentlySearching : 1;
+    // whether highlightedPages are all the pages matching cachedString, once a whole document search ended
+    bool matchedPagesKnown : 1;
     QColor cachedColor;
-    int pagesDone;
+};
+
+// Whether every page with a match of text has a match of the last search of s, whose
+// matching pages are then the only ones to search, e.g. when a letter is typed after it
+static bool narrowsLastSearch(const RunningSearch *s, const QString &text, Document::SearchType type, Qt::CaseSensitivity caseSensitivity)
+{
+    if (!s->matchedPagesKnown || s->cachedType != type || (s->cachedCaseSensitivity == Qt::CaseSensitive && caseSensitivity == Qt::CaseInsensitive)) {
+        return false;
+    }
+
+    // compared like the text pages compare them, a combining character typed after a letter changes it
+    const auto normalizedWords = [type](const QString &str) {
+        QStringList words = type == Document::AllDocument ? QStringList {str} : str.split(QLatin1Char(' '), Qt::SkipEmptyParts);
+        for (QString &word : words) {
+            word = word.normalized(QString::NormalizationForm_KC);
+        }
+        return words;
+    };
+    const QStringList lastWords = normalizedWords(s->cachedString);
+    const QStringList words = normalizedWords(text);
+    const Qt::CaseSensitivity cs = s->cachedCaseSensitivity;
+
+    switch (type) {
+    case Document::AllDocument:
+        return words.first().contains(lastWords.first(), cs);
+    case Document::GoogleAll:
+        // each word of the last search is part of one of the words
+        return std::ranges::all_of(lastWords, [&words, cs](const QString &lastWord) { //
+            return std::ranges::any_of(words, [&lastWord, cs](const QString &word) { return word.contains(lastWord, cs); });
+        });
+    case Document::GoogleAny:
+        // each word contains one of the words of the last search
+        return !words.isEmpty() && std::ranges::all_of(words, [&lastWords, cs](const QString &word) { //
+            return std::ranges::any_of(lastWords, [&word, cs](const QString &lastWord) { return word.contains(lastWord, cs); });
+        });
+    default:
+        return false;
+    }
+}
+
+struct TextSearch {
+    TextSearchQuery query;
+    // the pages to search, in the order their results are processed
+    QList<int> pages;
+    // where in pages the search went past the end of the document, -1 if it doesn't
+    int wrapIndex = -1;
+    // index in pages of the next page to search, and of the next one to process the results of
+    int nextPage = 0;
+    int nextResult = 0;
+    // the results of the pages searched but not processed yet, by index in pages
+    QMap<int, QList<TextSearchMatch>> results;
+    QList<ThreadWeaver::JobPointer> jobs;
+    // pages whose highlights changed and still have to be notified
+    QSet<int> pagesToNotify;
+    bool foundAMatch = false;
+    bool cancelled = false;
+    bool finished = false;
+    bool continueScheduled = false;
 };
 
 #define foreachObserver(cmd)                                                                                                                                                                                                                   \
@@ -254,6 +306,8 @@ qulonglong DocumentPrivate::calculateMemoryToFree()
     // [MEM] choose memory parameters based on configuration profile
     qulonglong clipValue = 0;
     qulonglong memoryToFree = 0;
+    // text pages are under the same memory pressure as pixmaps
+    const qulonglong allocatedMemory = m_allocatedPixmapsTotalMemory + m_allocatedTextPagesTotalMemory;
 
     switch (SettingsCore::memoryLevel()) {
     case SettingsCore::EnumMemoryLevel::Low:
@@ -263,26 +317,26 @@ qulonglong DocumentPrivate::calculateMemoryToFree()
     case SettingsCore::EnumMemoryLevel::Normal: {
         qulonglong thirdTotalMemory = getTotalMemory() / 3;
         qulonglong freeMemory = getFreeMemory();
-        if (m_allocatedPixmapsTotalMemory > thirdTotalMemory) {
-            memoryToFree = m_allocatedPixmapsTotalMemory - thirdTotalMemory;
+        if (allocatedMemory > thirdTotalMemory) {
+            memoryToFree = allocatedMemory - thirdTotalMemory;
         }
-        if (m_allocatedPixmapsTotalMemory > freeMemory) {
-            clipValue = (m_allocatedPixmapsTotalMemory - freeMemory) / 2;
+        if (allocatedMemory > freeMemory) {
+            clipValue = (allocatedMemory - freeMemory) / 2;
         }
     } break;
 
     case SettingsCore::EnumMemoryLevel::Aggressive: {
         qulonglong freeMemory = getFreeMemory();
-        if (m_allocatedPixmapsTotalMemory > freeMemory) {
-            clipValue = (m_allocatedPixmapsTotalMemory - freeMemory) / 2;
+        if (allocatedMemory > freeMemory) {
+            clipValue = (allocatedMemory - freeMemory) / 2;
         }
     } break;
     case SettingsCore::EnumMemoryLevel::Greedy: {
         qulonglong freeSwap;
         qulonglong freeMemory = getFreeMemory(&freeSwap);
         const qulonglong memoryLimit = qMin(qMax(freeMemory, getTotalMemory() / 2), freeMemory + freeSwap);
-        if (m_allocatedPixmapsTotalMemory > memoryLimit) {
-            clipValue = (m_allocatedPixmapsTotalMemory - memoryLimit) / 2;
+        if (allocatedMemory > memoryLimit) {
+            clipValue = (allocatedMemory - memoryLimit) / 2;
         }
     } break;
     }
@@ -343,7 +397,7 @@ void DocumentPrivate::cleanupPixmapMemory(qulonglong memoryToFree)
 
     // Store pages that weren't completely removed
 
-    std::list<AllocatedPixmap *> pixmapsToKeep;
+    QList<AllocatedPixmap *> pixmapsToKeep;
     while (memoryToFree > 0) {
         int clean_hits = 0;
         for (DocumentObserver *observer : std::as_const(m_observers)) {
@@ -385,7 +439,12 @@ void DocumentPrivate::cleanupPixmapMemory(qulonglong memoryToFree)
         }
     }
 
-    m_allocatedPixmaps.splice(m_allocatedPixmaps.end(), pixmapsToKeep);
+    for (AllocatedPixmap *p : std::as_const(pixmapsToKeep)) {
+        m_allocatedPixmaps.insert(p);
+    }
+
+    // If we're still on low memory, free the text pages not used for the longest time
+    cleanupTextPageMemory(memoryToFree);
     Q_UNUSED(pagesFreed);
     // p--rintf("freeMemory A:[%d -%d = %d] \n", m_allocatedPixmaps.count() + pagesFreed, pagesFreed, m_allocatedPixmaps.count() );
 }
@@ -397,34 +456,16 @@ void DocumentPrivate::cleanupPixmapMemory(qulonglong memoryToFree)
  */
 AllocatedPixmap *DocumentPrivate::searchLowestPriorityPixmap(bool unloadableOnly, bool thenRemoveIt, DocumentObserver *observer)
 {
-    auto pIt = m_allocatedPixmaps.begin();
-    auto pEnd = m_allocatedPixmaps.end();
-    auto farthestPixmap = pEnd;
-    const int currentViewportPage = m_viewportIterator->pageNumber;
-
     /* Find the pixmap that is farthest from the current viewport */
-    int maxDistance = -1;
-    while (pIt != pEnd) {
-        const AllocatedPixmap *p = *pIt;
-        // Filter by observer
-        if (observer == nullptr || p->observer == observer) {
-            const int distance = qAbs(p->page - currentViewportPage);
-            if (maxDistance < distance && (!unloadableOnly || p->observer->canUnloadPixmap(p->page))) {
-                maxDistance = distance;
-                farthestPixmap = pIt;
-            }
-        }
-        ++pIt;
-    }
+    AllocatedPixmap *selectedPixmap = m_allocatedPixmaps.farthestFrom(m_viewportIterator->pageNumber, unloadableOnly, observer);
 
     /* No pixmap to remove */
-    if (farthestPixmap == pEnd) {
+    if (!selectedPixmap) {
         return nullptr;
     }
 
-    AllocatedPixmap *selectedPixmap = *farthestPixmap;
     if (thenRemoveIt) {
-        m_allocatedPixmaps.erase(farthestPixmap);
+        m_allocatedPixmaps.remove(selectedPixmap);
     }
     return selectedPixmap;
 }
@@ -1346,11 +1387,17 @@ void DocumentPrivate::saveDocumentInfo() const
 void DocumentPrivate::slotTimedMemoryCheck()
 {
     // [MEM] clean memory (for 'free mem dependent' profiles only)
-    if (SettingsCore::memoryLevel() != SettingsCore::EnumMemoryLevel::Low && m_allocatedPixmapsTotalMemory > 1024 * 1024) {
+    if (SettingsCore::memoryLevel() != SettingsCore::EnumMemoryLevel::Low && m_allocatedPixmapsTotalMemory + m_allocatedTextPagesTotalMemory > 1024 * 1024) {
         cleanupPixmapMemory();
     }
 }
 
+// Unlike NormalizedRect::intersects() tiles sharing an edge don't overlap
+static bool tilesOverlap(const NormalizedRect &a, const NormalizedRect &b)
+{
+    return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+}
+
 void DocumentPrivate::sendGeneratorPixmapRequest()
 {
     /* If the pixmap cache will have to be cleaned in order to make room for the
@@ -1367,15 +1414,16 @@ void DocumentPrivate::sendGeneratorPixmapRequest()
         }
     }
 
+    const bool parallelRendering = m_generator->hasFeature(Generator::ParallelRendering);
+
     // find a request
     PixmapRequest *request = nullptr;
     m_pixmapRequestsMutex.lock();
-    while (!m_pixmapRequestsStack.empty() && !request) {
-        PixmapRequest *r = m_pixmapRequestsStack.back();
-        if (!r) {
-            m_pixmapRequestsStack.pop_back();
-            continue;
-        }
+    PixmapRequest *next = m_pixmapRequestsStack.top();
+    while (next && !request) {
+        PixmapRequest *r = next;
+        // taken before r may be discarded, the requests after it stay in the queue
+        next = m_pixmapRequestsStack.next(r);
 
         QRect requestRect = r->isTile() ? r->normalizedRect().geometry(r->width(), r->height()) : QRect(0, 0, r->width(), r->height());
         TilesManager *tilesManager = r->d->tilesManager();
@@ -1397,22 +1445,31 @@ void DocumentPrivate::sendGeneratorPixmapRequest()
 
         // If it's a preload but the generator is not threaded no point in trying to preload
         if (r->preload() && !m_generator->hasFeature(Generator::Threaded)) {
-            m_pixmapRequestsStack.pop_back();
-            delete r;
+            m_pixmapRequestsStack.discard(r);
         }
         // request only if page isn't already present and request has valid id
         else if ((!r->d->mForce && r->page()->hasPixmap(r->observer(), r->width(), r->height(), r->normalizedRect())) || !m_observers.contains(r->observer())) {
-            m_pixmapRequestsStack.pop_back();
-            delete r;
+            m_pixmapRequestsStack.discard(r);
         } else if (!r->d->mForce && r->preload() && qAbs(r->pageNumber() - currentViewportPage) >= maxDistance) {
-            m_pixmapRequestsStack.pop_back();
             // qCDebug(OkularCoreDebug) << "Ignoring request that doesn't fit in cache";
-            delete r;
-        }
-        // Ignore requests for pixmaps that are already being generated
-        else if (tilesManager && tilesManager->isRequesting(r->normalizedRect(), r->width(), r->height())) {
-            m_pixmapRequestsStack.pop_back();
-            delete r;
+            m_pixmapRequestsStack.discard(r);
+        }
+        // Ignore requests for pixmaps that are already being generated. When rendering in parallel
+        // the tiles being rendered stay requested while others go, so outdated ones are rendered again
+        else if (tilesManager && !(parallelRendering && r->d->mForce) && tilesManager->isRequesting(r->normalizedRect(), r->width(), r->height())) {
+            m_pixmapRequestsStack.discard(r);
+        }
+        // When rendering in parallel don't start a second rendering of the same page for the same observer,
+        // leave this one queued for requestDone() of the executing one and look at the next ones.
+        // Other tiles of the page can go already
+        else if (parallelRendering && std::ranges::any_of(m_executingPixmapRequests, [r](const PixmapRequest *executing) { //
+                     if (executing->observer() != r->observer() || executing->pageNumber() != r->pageNumber() || executing->shouldAbortRender()) {
+                         return false;
+                     }
+                     const bool otherTile = executing->isTile() && r->isTile() && executing->width() == r->width() && executing->height() == r->height();
+                     return !otherTile || tilesOverlap(executing->normalizedRect(), r->normalizedRect());
+                 })) {
+            continue;
         }
         // If the requested area is above 4*screenSize pixels, and we're not rendering most of the page,  switch on the tile manager
         else if (!tilesManager && m_generator->hasFeature(Generator::TiledRendering) && (long)r->width() * (long)r->height() > 4L * screenSize && normalizedArea < 0.75) {
@@ -1438,8 +1495,10 @@ void DocumentPrivate::sendGeneratorPixmapRequest()
             // visible tiles.
             if (!r->normalizedRect().isNull()) {
                 NormalizedRect tilesRect;
+                QList<NormalizedRect> tileRects;
                 const auto tiles = tilesManager->tilesAt(r->normalizedRect(), TilesManager::TerminalTile);
                 for (const Tile &tile : tiles) {
+                    tileRects << tile.rect();
                     if (tilesRect.isNull()) {
                         tilesRect = tile.rect();
                     } else {
@@ -1447,15 +1506,28 @@ void DocumentPrivate::sendGeneratorPixmapRequest()
                     }
                 }
 
-                r->setNormalizedRect(tilesRect);
+                // [PARALLEL TILES] send the tile nearest to the center now, queue the others
+                if (r->asynchronous() && tileRects.count() > 1 && rendersTilesInParallel()) {
+                    tilesManager->setRequest(NormalizedRect(), r->width(), r->height());
+                    QList<PixmapRequest *> tileRequests = splitTileRequest(r, tileRects);
+                    tileRequests.removeFirst();
+                    // the queue takes the newest of the priority 0 requests first, the oldest of the others
+                    if (r->priority() == 0) {
+                        std::ranges::reverse(tileRequests);
+                    }
+                    for (PixmapRequest *tileRequest : std::as_const(tileRequests)) {
+                        m_pixmapRequestsStack.push(tileRequest);
+                    }
+                } else {
+                    r->setNormalizedRect(tilesRect);
+                }
                 request = r;
             } else {
                 // Discard request if normalizedRect is null. This happens in
                 // preload requests issued by PageView if the requested page is
                 // not visible and the user has just switched from a non-tiled
                 // zoom level to a tiled one
-                m_pixmapRequestsStack.pop_back();
-                delete r;
+                m_pixmapRequestsStack.discard(r);
             }
         }
         // If the requested area is below 3*screenSize pixels, switch off the tile manager
@@ -1468,13 +1540,12 @@ void DocumentPrivate::sendGeneratorPixmapRequest()
 
             request = r;
         } else if ((long)requestRect.width() * (long)requestRect.height() > 100L * screenSize && (SettingsCore::memoryLevel() != SettingsCore::EnumMemoryLevel::Greedy)) {
-            m_pixmapRequestsStack.pop_back();
             if (!m_warnedOutOfMemory) {
                 qCWarning(OkularCoreDebug).nospace() << "Running out of memory on page " << r->pageNumber() << " (" << r->width() << "x" << r->height() << " px);";
                 qCWarning(OkularCoreDebug) << "this message will be reported only once.";
                 m_warnedOutOfMemory = true;
             }
-            delete r;
+            m_pixmapRequestsStack.discard(r);
         } else {
             request = r;
         }
@@ -1499,17 +1570,36 @@ void DocumentPrivate::sendGeneratorPixmapRequest()
         cleanupPixmapMemory(memoryToFree /* previously calculated value */);
     }
 
+    // images already rendered in a previous session don't need the generator
+    const QString cacheEntry = pageImageCacheEntry(request, false);
+    const bool cached = !cacheEntry.isEmpty() && m_pageImageCache->contains(cacheEntry);
+
+    // nor do the pages another observer shows bigger already, e.g. thumbnails of the pages in view
+    const QPixmap *derivableFrom = cached ? nullptr : derivablePixmap(request);
+
     // submit the request to the generator
-    if (m_generator->canGeneratePixmap()) {
+    if (cached || derivableFrom || m_generator->canGeneratePixmap()) {
+        // [PROGRESSIVE] nothing to show yet for a big page, render a quick preview first
+        // and leave the request queued, it replaces the preview once done
+        if (PixmapRequest *preview = cached || derivableFrom ? nullptr : createPreviewRequest(request)) {
+            qCDebug(OkularCoreDebug).nospace() << "Rendering a " << preview->width() << "x" << preview->height() << " preview of page " << request->pageNumber() << " first";
+            request->d->mPreviewSent = true;
+            request = preview;
+        }
+
         QRect requestRect = !request->isTile() ? QRect(0, 0, request->width(), request->height()) : request->normalizedRect().geometry(request->width(), request->height());
+        const qint64 waitTime = m_pixmapRequestsStack.take(request);
         qCDebug(OkularCoreDebug).nospace() << "sending request observer=" << request->observer() << " " << requestRect.width() << "x" << requestRect.height() << "@" << request->pageNumber() << " async == " << request->asynchronous()
-                                           << " isTile == " << request->isTile();
-        m_pixmapRequestsStack.remove(request);
+                                           << " isTile == " << request->isTile() << " waited " << waitTime << "ms, " << m_pixmapRequestsStack.count() << " still queued";
 
-        if (tm) {
+        if (tm && parallelRendering && request->isTile()) {
+            tm->addRequest(request->normalizedRect(), request->width(), request->height());
+        } else if (tm) {
             tm->setRequest(request->normalizedRect(), request->width(), request->height());
         }
 
+        // the size in the current rotation, like the pixmaps a derived one is scaled from
+        const QSize rotatedSize(request->width(), request->height());
         if ((int)m_rotation % 2) {
             request->d->swap();
         }
@@ -1519,16 +1609,62 @@ void DocumentPrivate::sendGeneratorPixmapRequest()
         }
 
         // If set elsewhere we already know we want it to be partial
+        // A preview is quick enough without partial updates, and shown when the request after it is partially done
         if (!request->partialUpdatesWanted()) {
-            request->setPartialUpdatesWanted(request->asynchronous() && !request->page()->hasPixmap(request->observer()));
+            request->setPartialUpdatesWanted(request->asynchronous() && !request->isPreview() && !request->page()->hasPixmap(request->observer()));
         }
 
         // we always have to unlock _before_ the generatePixmap() because
         // a sync generation would end with requestDone() -> deadlock, and
         // we can not really know if the generator can do async requests
+        request->d->mFromPageImageCache = cached;
         m_executingPixmapRequests.push_back(request);
+        const bool hasMoreRequests = !m_pixmapRequestsStack.isEmpty();
         m_pixmapRequestsMutex.unlock();
+
+        if (cached || derivableFrom) {
+            if (cached) {
+                const bool calcBoundingBox = !request->isTile() && !request->page()->isBoundingBoxKnown();
+                if (request->asynchronous()) {
+                    m_pageImageCache->load(request, cacheEntry, calcBoundingBox);
+                } else {
+                    // e.g. the presentation mode, it expects the pixmap to be there once this returns
+                    NormalizedRect boundingBox;
+                    const QImage image = m_pageImageCache->read(cacheEntry, calcBoundingBox, &boundingBox);
+                    cachedPixmapLoaded(request, image, boundingBox, calcBoundingBox);
+                }
+            } else {
+                // the pixmap can't be used out of the GUI thread
+                const QImage derivableImage = derivableFrom->toImage();
+                if (request->asynchronous()) {
+                    PixmapScaleJob *job = new PixmapScaleJob(request, derivableImage, rotatedSize.width(), rotatedSize.height(), m_rotation);
+                    QObject::connect(job, &PixmapScaleJob::done, m_parent, [this](const ThreadWeaver::JobPointer &j) {
+                        const PixmapScaleJob *scaleJob = static_cast<const PixmapScaleJob *>(j.data());
+                        derivedPixmapDone(scaleJob->request(), scaleJob->image(), scaleJob->rotation());
+                    });
+                    m_pixmapScaleWeaver.enqueue(ThreadWeaver::JobPointer(job));
+                } else {
+                    derivedPixmapDone(request, PixmapScaleJob::scaled(derivableImage, rotatedSize.width(), rotatedSize.height()), m_rotation);
+                }
+            }
+            // The generator is still free for the next request
+            if (hasMoreRequests) {
+                QTimer::singleShot(0, m_parent, [this] { sendGeneratorPixmapRequest(); });
+            }
+            return;
+        }
+
         m_generator->generatePixmap(request);
+
+        // Keep feeding the generator while it has free rendering threads
+        if (parallelRendering && m_generator->canGeneratePixmap()) {
+            m_pixmapRequestsMutex.lock();
+            const bool hasPendingRequests = !m_pixmapRequestsStack.isEmpty();
+            m_pixmapRequestsMutex.unlock();
+            if (hasPendingRequests) {
+                sendGeneratorPixmapRequest();
+            }
+        }
     } else {
         m_pixmapRequestsMutex.unlock();
         // pino (7/4/2006): set the polling interval from 10 to 30
@@ -1593,7 +1729,6 @@ void DocumentPrivate::slotGeneratorConfigChanged()
         }
 
         // [MEM] remove allocation descriptors
-        qDeleteAll(m_allocatedPixmaps);
         m_allocatedPixmaps.clear();
         m_allocatedPixmapsTotalMemory = 0;
 
@@ -1601,8 +1736,11 @@ void DocumentPrivate::slotGeneratorConfigChanged()
         foreachObserverD(notifyContentsCleared(DocumentObserver::Pixmap));
     }
 
+    updatePageImageCache(false);
+    updateSearchIndex(false);
+
     // free memory if in 'low' profile
-    if (SettingsCore::memoryLevel() == SettingsCore::EnumMemoryLevel::Low && !m_allocatedPixmaps.empty() && !m_pagesVector.isEmpty()) {
+    if (SettingsCore::memoryLevel() == SettingsCore::EnumMemoryLevel::Low && !m_allocatedPixmaps.isEmpty() && !m_pagesVector.isEmpty()) {
         cleanupPixmapMemory();
     }
 }
@@ -1614,6 +1752,11 @@ void DocumentPrivate::refreshPixmaps(int pageNumber)
         return;
     }
 
+    // the page doesn't look like in the file anymore
+    if (m_pageImageCache) {
+        m_pageImageCache->excludePage(pageNumber);
+    }
+
     QList<Okular::PixmapRequest *> pixmapsToRequest;
     for (const auto &[key, value] : page->d->m_pixmaps.asKeyValueRange()) {
         const QSize size = value.m_pixmap->size();
@@ -1665,78 +1808,196 @@ void DocumentPrivate::refreshPixmaps(int pageNumber)
 void DocumentPrivate::_o_configChanged()
 {
     // free text pages if needed
-    calculateMaxTextPages();
-    while (m_allocatedTextPagesFifo.count() > m_maxAllocatedTextPages) {
-        int pageToKick = m_allocatedTextPagesFifo.takeFirst();
-        m_pagesVector.at(pageToKick)->setTextPage(nullptr); // deletes the textpage
+    calculateMaxTextPagesMemory();
+    if (m_allocatedTextPagesTotalMemory > m_maxAllocatedTextPagesMemory) {
+        cleanupTextPageMemory(m_allocatedTextPagesTotalMemory - m_maxAllocatedTextPagesMemory);
     }
 }
 
-void DocumentPrivate::doContinueDirectionMatchSearch(DoContinueDirectionMatchSearchStruct *searchStruct)
+void DocumentPrivate::doContinueTextSearch(const std::shared_ptr<TextSearch> &textSearch)
 {
-    RunningSearch *search = m_searches.value(searchStruct->searchID);
+    if (textSearch->finished) {
+        return;
+    }
 
-    if ((m_searchCancelled && !searchStruct->match) || !search) {
-        // if the user cancelled but he just got a match, give him the match!
-        QApplication::restoreOverrideCursor();
+    // text pages made in this thread are made for this long before giving the event loop a chance to run
+    constexpr int searchTimeSlice = 20;
 
-        if (search) {
-            search->isCurrentlySearching = false;
+    const int searchID = textSearch->query.searchID;
+    RunningSearch *search = m_searches.value(searchID);
+    const bool wholeDocument = textSearch->query.type != Document::NextMatch && textSearch->query.type != Document::PreviousMatch;
+    const bool parallel = m_generator->hasFeature(Generator::Threaded) && m_generator->hasFeature(Generator::ParallelRendering);
+    const int maxJobs = 2 * m_textSearchWeaver.maximumNumberOfThreads();
+
+    QElapsedTimer sliceTimer;
+    sliceTimer.start();
+
+    while (true) {
+        // the search was cancelled, or removed by resetSearch()
+        if (textSearch->cancelled || !search) {
+            stopTextSearch(textSearch);
+            QApplication::restoreOverrideCursor();
+            if (search) {
+                search->isCurrentlySearching = false;
+            }
+            Q_EMIT m_parent->searchFinished(searchID, Document::SearchCancelled);
+            return;
         }
 
-        Q_EMIT m_parent->searchFinished(searchStruct->searchID, Document::SearchCancelled);
-        delete searchStruct->pagesToNotify;
-        delete searchStruct;
-        return;
-    }
+        // 1. process the results in the order of the pages, as far as they are known
+        while (textSearch->results.contains(textSearch->nextResult)) {
+            const int index = textSearch->nextResult++;
+            const int pageNumber = textSearch->pages.at(index);
+            const QList<TextSearchMatch> matches = textSearch->results.take(index);
+
+            if (index == textSearch->wrapIndex) {
+                if (textSearch->query.type == Document::NextMatch) {
+                    Q_EMIT m_parent->notice(i18n("Continuing search from beginning"), 3000);
+                } else {
+                    Q_EMIT m_parent->notice(i18n("Continuing search from bottom"), 3000);
+                }
+            }
+
+            if (matches.isEmpty()) {
+                continue;
+            }
 
-    const bool forward = search->cachedType == Document::NextMatch;
-    bool doContinue = false;
-    // if no match found, loop through the whole doc, starting from currentPage
-    if (!searchStruct->match) {
-        const int pageCount = m_pagesVector.count();
-        if (search->pagesDone < pageCount) {
-            doContinue = true;
-            if (searchStruct->currentPage >= pageCount) {
-                searchStruct->currentPage = 0;
-                Q_EMIT m_parent->notice(i18n("Continuing search from beginning"), 3000);
-            } else if (searchStruct->currentPage < 0) {
-                searchStruct->currentPage = pageCount - 1;
-                Q_EMIT m_parent->notice(i18n("Continuing search from bottom"), 3000);
+            // the first match is the one looked for, the pages after it are not needed
+            if (!wholeDocument) {
+                stopTextSearch(textSearch);
+                doProcessSearchMatch(matches.first().first, search, textSearch->pagesToNotify, pageNumber, searchID, search->cachedViewportMove, search->cachedColor);
+                return;
+            }
+
+            // show the highlights of each page as soon as it's searched
+            Page *page = m_pagesVector.at(pageNumber);
+            for (const auto &[area, color] : matches) {
+                page->d->setHighlight(*area, color, searchID);
+                delete area;
             }
+            search->highlightedPages.insert(pageNumber);
+            textSearch->pagesToNotify.remove(pageNumber);
+            textSearch->foundAMatch = true;
+            foreachObserverD(notifyPageChanged(pageNumber, DocumentObserver::Highlights));
         }
-    }
 
-    if (doContinue) {
-        // get page
-        const Page *page = m_pagesVector[searchStruct->currentPage];
-        // request search page if needed
-        if (!page->hasTextPage()) {
-            m_parent->requestTextPage(page->number());
+        // 2. all the pages are searched
+        if (textSearch->nextResult == textSearch->pages.count()) {
+            stopTextSearch(textSearch);
+
+            if (!wholeDocument) {
+                doProcessSearchMatch(nullptr, search, textSearch->pagesToNotify, -1, searchID, search->cachedViewportMove, search->cachedColor);
+                return;
+            }
+
+            // reset cursor to previous shape
+            QApplication::restoreOverrideCursor();
+            search->isCurrentlySearching = false;
+
+            // send page lists to update observers (since some filter on bookmarks)
+            foreachObserverD(notifySetup(m_pagesVector, 0));
+
+            // notify observers about the pages whose highlights were removed
+            for (int pageNumber : std::as_const(textSearch->pagesToNotify)) {
+                foreachObserverD(notifyPageChanged(pageNumber, DocumentObserver::Highlights));
+            }
+
+            search->matchedPagesKnown = true;
+            Q_EMIT m_parent->searchFinished(searchID, textSearch->foundAMatch ? Document::MatchFound : Document::NoMatchFound);
+            return;
         }
 
-        // if found a match on the current page, end the loop
-        searchStruct->match = page->findText(searchStruct->searchID, search->cachedString, forward ? FromTop : FromBottom, search->cachedCaseSensitivity);
-        if (!searchStruct->match) {
-            if (forward) {
-                searchStruct->currentPage++;
-            } else {
-                searchStruct->currentPage--;
+        // 3. search the next page, the last ones are already being searched otherwise
+        if (textSearch->nextPage == textSearch->pages.count()) {
+            return;
+        }
+
+        const int index = textSearch->nextPage;
+        Page *page = m_pagesVector.at(textSearch->pages.at(index));
+        if (page->hasTextPage() || !parallel) {
+            if (sliceTimer.elapsed() >= searchTimeSlice) {
+                scheduleTextSearch(textSearch);
+                return;
+            }
+
+            // request search page if needed
+            if (!page->hasTextPage()) {
+                m_parent->requestTextPage(page->number());
             }
-            search->pagesDone++;
+            page->d->textPageUsed();
+            textSearch->results.insert(index, searchTextPage(page->d->m_text, textSearch->query));
+            page->d->textPageMemoryChanged();
+        } else if (textSearch->jobs.count() < maxJobs) {
+            TextSearchJob *job = new TextSearchJob(m_generator, page, textSearch->query, index);
+            QObject::connect(job, &TextSearchJob::done, m_parent, [this, textSearch](const ThreadWeaver::JobPointer &j) { textSearchJobDone(textSearch, j); });
+            const ThreadWeaver::JobPointer jobPointer(job);
+            textSearch->jobs.append(jobPointer);
+            m_textSearchWeaver.enqueue(jobPointer);
         } else {
-            search->pagesDone = 1;
+            // continued when a job is done
+            return;
         }
+        textSearch->nextPage++;
+    }
+}
 
-        // Both of the previous if branches need to call doContinueDirectionMatchSearch
-        QTimer::singleShot(0, m_parent, [this, searchStruct] { doContinueDirectionMatchSearch(searchStruct); });
-    } else {
-        doProcessSearchMatch(searchStruct->match, search, searchStruct->pagesToNotify, searchStruct->currentPage, searchStruct->searchID, search->cachedViewportMove, search->cachedColor);
-        delete searchStruct;
+void DocumentPrivate::scheduleTextSearch(const std::shared_ptr<TextSearch> &textSearch)
+{
+    if (textSearch->continueScheduled) {
+        return;
     }
+
+    textSearch->continueScheduled = true;
+    QTimer::singleShot(0, m_parent, [this, textSearch] {
+        textSearch->continueScheduled = false;
+        doContinueTextSearch(textSearch);
+    });
 }
 
-void DocumentPrivate::doProcessSearchMatch(RegularAreaRect *match, RunningSearch *search, QSet<int> *pagesToNotify, int currentPage, int searchID, bool moveViewport, const QColor &color)
+void DocumentPrivate::textSearchJobDone(const std::shared_ptr<TextSearch> &textSearch, const ThreadWeaver::JobPointer &j)
+{
+    // the job deletes what it made when the search doesn't need it anymore
+    if (textSearch->finished) {
+        return;
+    }
+
+    TextSearchJob *job = static_cast<TextSearchJob *>(j.data());
+    textSearch->jobs.removeOne(j);
+
+    // keep the text page for the next searches, unless the page got one meanwhile
+    if (TextPage *textPage = job->takeTextPage()) {
+        Page *page = job->page();
+        if (page->hasTextPage()) {
+            delete textPage;
+        } else {
+            page->d->setPreparedTextPage(textPage);
+            textGenerationDone(page);
+        }
+    }
+
+    textSearch->results.insert(job->index(), job->takeMatches());
+    doContinueTextSearch(textSearch);
+}
+
+void DocumentPrivate::stopTextSearch(const std::shared_ptr<TextSearch> &textSearch)
+{
+    textSearch->finished = true;
+    m_textSearches.removeOne(textSearch);
+
+    for (const ThreadWeaver::JobPointer &job : std::as_const(textSearch->jobs)) {
+        static_cast<TextSearchJob *>(job.data())->abort();
+    }
+    textSearch->jobs.clear();
+
+    for (const QList<TextSearchMatch> &matches : std::as_const(textSearch->results)) {
+        for (const TextSearchMatch &match : matches) {
+            delete match.first;
+        }
+    }
+    textSearch->results.clear();
+}
+
+void DocumentPrivate::doProcessSearchMatch(RegularAreaRect *match, RunningSearch *search, QSet<int> pagesToNotify, int currentPage, int searchID, bool moveViewport, const QColor &color)
 {
     // reset cursor to previous shape
     QApplication::restoreOverrideCursor();
@@ -1756,7 +2017,7 @@ void DocumentPrivate::doProcessSearchMatch(RegularAreaRect *match, RunningSearch
         m_pagesVector[currentPage]->d->setHighlight(*match, color, searchID);
 
         // ..queue page for notifying changes..
-        pagesToNotify->insert(currentPage);
+        pagesToNotify.insert(currentPage);
 
         // Create a normalized rectangle around the search match that includes a 5% buffer on all sides.
         const Okular::NormalizedRect matchRectWithBuffer = Okular::NormalizedRect(match->first().left - 0.05, match->first().top - 0.05, match->first().right + 0.05, match->first().bottom + 0.05);
@@ -1775,7 +2036,7 @@ void DocumentPrivate::doProcessSearchMatch(RegularAreaRect *match, RunningSearch
     }
 
     // notify observers about highlights changes
-    for (int pageNumber : std::as_const(*pagesToNotify)) {
+    for (int pageNumber : std::as_const(pagesToNotify)) {
         for (DocumentObserver *observer : std::as_const(m_observers)) {
             observer->notifyPageChanged(pageNumber, DocumentObserver::Highlights);
         }
@@ -1786,219 +2047,6 @@ void DocumentPrivate::doProcessSearchMatch(RegularAreaRect *match, RunningSearch
     } else {
         Q_EMIT m_parent->searchFinished(searchID, Document::NoMatchFound);
     }
-
-    delete pagesToNotify;
-}
-
-void DocumentPrivate::doContinueAllDocumentSearch(QSet<int> *pagesToNotify, QHash<Page *, QList<RegularAreaRect *>> *pageMatches, int currentPage, int searchID)
-{
-    RunningSearch *search = m_searches.value(searchID);
-
-    if (m_searchCancelled || !search) {
-        typedef QList<RegularAreaRect *> Matches;
-
-        QApplication::restoreOverrideCursor();
-
-        if (search) {
-            search->isCurrentlySearching = false;
-        }
-
-        Q_EMIT m_parent->searchFinished(searchID, Document::SearchCancelled);
-        for (const Matches &mv : std::as_const(*pageMatches)) {
-            qDeleteAll(mv);
-        }
-        delete pageMatches;
-        delete pagesToNotify;
-        return;
-    }
-
-    if (currentPage < m_pagesVector.count()) {
-        // get page (from the first to the last)
-        Page *page = m_pagesVector.at(currentPage);
-
-        // request search page if needed
-        if (!page->hasTextPage()) {
-            int pageNumber = page->number(); // redundant? is it == currentPage ?
-            m_parent->requestTextPage(pageNumber);
-        }
-
-        // loop on a page adding highlights for all found items
-        RegularAreaRect *lastMatch = nullptr;
-        while (true) {
-            if (lastMatch) {
-                lastMatch = page->findText(searchID, search->cachedString, NextResult, search->cachedCaseSensitivity, lastMatch);
-            } else {
-                lastMatch = page->findText(searchID, search->cachedString, FromTop, search->cachedCaseSensitivity);
-            }
-
-            if (!lastMatch) {
-                break;
-            }
-
-            // add highlight rect to the matches map
-            (*pageMatches)[page].append(lastMatch);
-        }
-        delete lastMatch;
-
-        QTimer::singleShot(0, m_parent, [this, pagesToNotify, pageMatches, currentPage, searchID] { doContinueAllDocumentSearch(pagesToNotify, pageMatches, currentPage + 1, searchID); });
-    } else {
-        // reset cursor to previous shape
-        QApplication::restoreOverrideCursor();
-
-        search->isCurrentlySearching = false;
-        bool foundAMatch = pageMatches->count() != 0;
-        for (auto [key, value] : pageMatches->asKeyValueRange()) {
-            for (RegularAreaRect *&match : value) {
-                key->d->setHighlight(*match, search->cachedColor, searchID);
-                delete match;
-                match = nullptr;
-            }
-            search->highlightedPages.insert(key->number());
-            pagesToNotify->insert(key->number());
-        }
-
-        for (DocumentObserver *observer : std::as_const(m_observers)) {
-            observer->notifySetup(m_pagesVector, 0);
-        }
-
-        // notify observers about highlights changes
-        for (int pageNumber : std::as_const(*pagesToNotify)) {
-            for (DocumentObserver *observer : std::as_const(m_observers)) {
-                observer->notifyPageChanged(pageNumber, DocumentObserver::Highlights);
-            }
-        }
-
-        if (foundAMatch) {
-            Q_EMIT m_parent->searchFinished(searchID, Document::MatchFound);
-        } else {
-            Q_EMIT m_parent->searchFinished(searchID, Document::NoMatchFound);
-        }
-
-        delete pageMatches;
-        delete pagesToNotify;
-    }
-}
-
-void DocumentPrivate::doContinueGooglesDocumentSearch(QSet<int> *pagesToNotify, QHash<Page *, QList<MatchColor>> *pageMatches, int currentPage, int searchID, const QStringList &words)
-{
-    RunningSearch *search = m_searches.value(searchID);
-
-    if (m_searchCancelled || !search) {
-        using Matches = QList<MatchColor>;
-
-        QApplication::restoreOverrideCursor();
-
-        if (search) {
-            search->isCurrentlySearching = false;
-        }
-
-        Q_EMIT m_parent->searchFinished(searchID, Document::SearchCancelled);
-
-        for (Matches &mv : *pageMatches) {
-            for (auto &[area, color] : mv) {
-                delete area;
-                area = nullptr;
-            }
-        }
-        delete pageMatches;
-        delete pagesToNotify;
-        return;
-    }
-
-    const int wordCount = words.count();
-    const int hueStep = (wordCount > 1) ? (60 / (wordCount - 1)) : 60;
-    int baseHue, baseSat, baseVal;
-    search->cachedColor.getHsv(&baseHue, &baseSat, &baseVal);
-
-    if (currentPage < m_pagesVector.count()) {
-        // get page (from the first to the last)
-        Page *page = m_pagesVector.at(currentPage);
-
-        // request search page if needed
-        if (!page->hasTextPage()) {
-            int pageNumber = page->number(); // redundant? is it == currentPage ?
-            m_parent->requestTextPage(pageNumber);
-        }
-
-        // loop on a page adding highlights for all found items
-        bool allMatched = wordCount > 0, anyMatched = false;
-        for (int w = 0; w < wordCount; w++) {
-            const QString &word = words[w];
-            int newHue = baseHue - w * hueStep;
-            if (newHue < 0) {
-                newHue += 360;
-            }
-            QColor wordColor = QColor::fromHsv(newHue, baseSat, baseVal);
-            RegularAreaRect *lastMatch = nullptr;
-            // add all highlights for current word
-            bool wordMatched = false;
-            while (true) {
-                if (lastMatch) {
-                    lastMatch = page->findText(searchID, word, NextResult, search->cachedCaseSensitivity, lastMatch);
-                } else {
-                    lastMatch = page->findText(searchID, word, FromTop, search->cachedCaseSensitivity);
-                }
-
-                if (!lastMatch) {
-                    break;
-                }
-
-                // add highlight rect to the matches map
-                (*pageMatches)[page].append(MatchColor(lastMatch, wordColor));
-                wordMatched = true;
-            }
-            allMatched = allMatched && wordMatched;
-            anyMatched = anyMatched || wordMatched;
-        }
-
-        // if not all words are present in page, remove partial highlights
-        const bool matchAll = search->cachedType == Document::GoogleAll;
-        if (!allMatched && matchAll) {
-            auto &matches = (*pageMatches)[page];
-            for (auto &[area, color] : matches) {
-                delete area;
-                area = nullptr;
-            }
-            pageMatches->remove(page);
-        }
-
-        QTimer::singleShot(0, m_parent, [this, pagesToNotify, pageMatches, currentPage, searchID, words] { doContinueGooglesDocumentSearch(pagesToNotify, pageMatches, currentPage + 1, searchID, words); });
-    } else {
-        // reset cursor to previous shape
-        QApplication::restoreOverrideCursor();
-
-        search->isCurrentlySearching = false;
-        bool foundAMatch = pageMatches->count() != 0;
-        for (auto [page, matches] : pageMatches->asKeyValueRange()) {
-            for (auto &[area, color] : matches) {
-                page->d->setHighlight(*area, color, searchID);
-                delete area;
-            }
-            search->highlightedPages.insert(page->number());
-            pagesToNotify->insert(page->number());
-        }
-
-        // send page lists to update observers (since some filter on bookmarks)
-        for (DocumentObserver *observer : std::as_const(m_observers)) {
-            observer->notifySetup(m_pagesVector, 0);
-        }
-
-        // notify observers about highlights changes
-        for (int pageNumber : std::as_const(*pagesToNotify)) {
-            for (DocumentObserver *observer : std::as_const(m_observers)) {
-                observer->notifyPageChanged(pageNumber, DocumentObserver::Highlights);
-            }
-        }
-
-        if (foundAMatch) {
-            Q_EMIT m_parent->searchFinished(searchID, Document::MatchFound);
-        } else {
-            Q_EMIT m_parent->searchFinished(searchID, Document::NoMatchFound);
-        }
-
-        delete pageMatches;
-        delete pagesToNotify;
-    }
 }
 
 QVariant DocumentPrivate::documentMetaData(const Generator::DocumentMetaDataKey key, const QVariant &option) const
@@ -2170,7 +2218,6 @@ void DocumentPrivate::loadSyncFile(const QString &filePath)
 void DocumentPrivate::clearAndWaitForRequests()
 {
     m_pixmapRequestsMutex.lock();
-    qDeleteAll(m_pixmapRequestsStack);
     m_pixmapRequestsStack.clear();
     m_pixmapRequestsMutex.unlock();
 
@@ -2230,6 +2277,8 @@ Document::Document(QWidget *widget)
     d->m_viewportIterator = d->m_viewportHistory.insert(d->m_viewportHistory.end(), DocumentViewport());
     d->m_undoStack = new QUndoStack(this);
 
+    d->m_textSearchWeaver.setMaximumNumberOfThreads(GeneratorPrivate::maxParallelPixmapGenerations());
+
     connect(SettingsCore::self(), &SettingsCore::configChanged, this, [this] { d->_o_configChanged(); });
     connect(d->m_undoStack, &QUndoStack::canUndoChanged, this, &Document::canUndoChanged);
     connect(d->m_undoStack, &QUndoStack::canRedoChanged, this, &Document::canRedoChanged);
@@ -2250,6 +2299,8 @@ Document::~Document()
     // delete the bookmark manager
     delete d->m_bookmarkManager;
 
+    delete d->m_pageImageCache;
+
     // delete the loaded generators
     for (auto &generator : d->m_loadedGenerators) {
         d->unloadGenerator(generator);
@@ -2505,6 +2556,9 @@ Document::OpenResult Document::openDocument(const QString &docFile, const QUrl &
 
     d->m_bookmarkManager->setUrl(d->m_url);
 
+    d->updatePageImageCache(true);
+    d->updateSearchIndex(true);
+
     // 3. setup observers internal lists and data
     foreachObserver(notifySetup(d->m_pagesVector, DocumentObserver::DocumentChanged | DocumentObserver::UrlChanged));
 
@@ -2612,6 +2666,24 @@ void Document::closeDocument()
     // remove requests left in queue
     d->clearAndWaitForRequests();
 
+    // stop the running searches, their jobs use the pages and the generator
+    const QList<std::shared_ptr<TextSearch>> textSearches = d->m_textSearches;
+    for (const std::shared_ptr<TextSearch> &textSearch : textSearches) {
+        d->stopTextSearch(textSearch);
+        QApplication::restoreOverrideCursor();
+        Q_EMIT searchFinished(textSearch->query.searchID, SearchCancelled);
+    }
+    d->m_textSearchWeaver.finish();
+
+    delete d->m_searchIndex;
+    d->m_searchIndex = nullptr;
+
+    if (d->m_pageImageCache) {
+        d->m_pageImageCache->setDocument(QString(), QString());
+    }
+    delete d->m_documentHash;
+    d->m_documentHash = nullptr;
+
     if (d->m_fontThread) {
         disconnect(d->m_fontThread, nullptr, this, nullptr);
         d->m_fontThread->stopExtraction();
@@ -2706,9 +2778,15 @@ void Document::closeDocument()
     d->m_pagesVector.clear();
 
     // clear 'memory allocation' descriptors
-    qDeleteAll(d->m_allocatedPixmaps);
     d->m_allocatedPixmaps.clear();
 
+    const PixmapRequestQueue::Statistics &queueStatistics = d->m_pixmapRequestsStack.statistics();
+    if (queueStatistics.takenCount > 0) {
+        qCDebug(OkularCoreDebug).nospace() << "Pixmap request queue: " << queueStatistics.takenCount << " requests sent, " << queueStatistics.discardedCount << " discarded, peak depth " << queueStatistics.peakCount
+                                           << ", average wait " << queueStatistics.totalWait / qint64(queueStatistics.takenCount) << "ms, max wait " << queueStatistics.maxWait << "ms";
+    }
+    d->m_pixmapRequestsStack.resetStatistics();
+
     // clear 'running searches' descriptors
     qDeleteAll(d->m_searches);
     d->m_searches.clear();
@@ -2724,7 +2802,10 @@ void Document::closeDocument()
     d->m_viewportHistory.emplace_back();
     d->m_viewportIterator = d->m_viewportHistory.begin();
     d->m_allocatedPixmapsTotalMemory = 0;
-    d->m_allocatedTextPagesFifo.clear();
+    d->m_allocatedTextPagesLru.clear();
+    d->m_allocatedTextPagesLruPositions.clear();
+    d->m_allocatedTextPagesMemory.clear();
+    d->m_allocatedTextPagesTotalMemory = 0;
     d->m_pageSize = PageSize();
     d->m_pageSizes.clear();
 
@@ -2766,17 +2847,7 @@ void Document::removeObserver(DocumentObserver *pObserver)
         }
 
         // [MEM] free observer's allocation descriptors
-        auto aIt = d->m_allocatedPixmaps.begin();
-        auto aEnd = d->m_allocatedPixmaps.end();
-        while (aIt != aEnd) {
-            AllocatedPixmap *p = *aIt;
-            if (p->observer == pObserver) {
-                aIt = d->m_allocatedPixmaps.erase(aIt);
-                delete p;
-            } else {
-                ++aIt;
-            }
-        }
+        d->m_allocatedPixmapsTotalMemory -= d->m_allocatedPixmaps.removeObserver(pObserver);
 
         for (PixmapRequest *executingRequest : std::as_const(d->m_executingPixmapRequests)) {
             if (executingRequest->observer() == pObserver) {
@@ -2806,7 +2877,6 @@ void Document::reparseConfig()
         }
 
         // [MEM] remove allocation descriptors
-        qDeleteAll(d->m_allocatedPixmaps);
         d->m_allocatedPixmaps.clear();
         d->m_allocatedPixmapsTotalMemory = 0;
 
@@ -2814,8 +2884,11 @@ void Document::reparseConfig()
         foreachObserver(notifyContentsCleared(DocumentObserver::Pixmap));
     }
 
+    d->updatePageImageCache(false);
+    d->updateSearchIndex(false);
+
     // free memory if in 'low' profile
-    if (SettingsCore::memoryLevel() == SettingsCore::EnumMemoryLevel::Low && !d->m_allocatedPixmaps.empty() && !d->m_pagesVector.isEmpty()) {
+    if (SettingsCore::memoryLevel() == SettingsCore::EnumMemoryLevel::Low && !d->m_allocatedPixmaps.isEmpty() && !d->m_pagesVector.isEmpty()) {
         d->cleanupPixmapMemory();
     }
 }
@@ -3100,6 +3173,17 @@ bool Document::historyAtEnd() const
 
 QVariant Document::metaData(const QString &key, const QVariant &option) const
 {
+    if (key == QLatin1String("PixmapRequestQueueStatistics")) {
+        QMutexLocker locker(&d->m_pixmapRequestsMutex);
+        const PixmapRequestQueue::Statistics &statistics = d->m_pixmapRequestsStack.statistics();
+        return QVariantMap {{QStringLiteral("queued"), d->m_pixmapRequestsStack.count()},
+                            {QStringLiteral("peakQueued"), statistics.peakCount},
+                            {QStringLiteral("sent"), statistics.takenCount},
+                            {QStringLiteral("discarded"), statistics.discardedCount},
+                            {QStringLiteral("totalWaitMs"), statistics.totalWait},
+                            {QStringLiteral("maxWaitMs"), statistics.maxWait}};
+    }
+
     // if option starts with "src:" assume that we are handling a
     // source reference
     if (key == QLatin1String("NamedViewport") && option.toString().startsWith(QLatin1String("src:"), Qt::CaseInsensitive) && d->m_synctex_scanner) {
@@ -3192,7 +3276,7 @@ QString Document::pageSizeString(int page) const
     return QString();
 }
 
-static bool shouldCancelRenderingBecauseOf(const PixmapRequest &executingRequest, const PixmapRequest &otherRequest)
+static bool shouldCancelRenderingBecauseOf(const PixmapRequest &executingRequest, const PixmapRequest &otherRequest, bool tilesInParallel)
 {
     // New request has higher priority -> cancel
     if (executingRequest.priority() > otherRequest.priority()) {
@@ -3217,6 +3301,12 @@ static bool shouldCancelRenderingBecauseOf(const PixmapRequest &executingRequest
         return false;
     }
 
+    // Same priority, observer, page, the executing request is a preview -> don't cancel
+    // the new request replaces it when done, until then it's better than nothing
+    if (executingRequest.isPreview()) {
+        return false;
+    }
+
     // Same priority, observer, page, different size -> cancel
     if (executingRequest.width() != otherRequest.width()) {
         return true;
@@ -3232,6 +3322,11 @@ static bool shouldCancelRenderingBecauseOf(const PixmapRequest &executingRequest
         return true;
     }
 
+    // Same priority, observer, page, another tile rendered next to this one -> don't cancel
+    if (executingRequest.isTile() && tilesInParallel && !tilesOverlap(executingRequest.normalizedRect(), otherRequest.normalizedRect())) {
+        return false;
+    }
+
     // Same priority, observer, page, different tiling -> cancel
     if (executingRequest.isTile()) {
         const NormalizedRect bothRequestsRect = executingRequest.normalizedRect() | otherRequest.normalizedRect();
@@ -3257,7 +3352,8 @@ bool DocumentPrivate::cancelRenderingBecauseOf(PixmapRequest *executingRequest,
     TilesManager *tm = executingRequest->d->tilesManager();
     if (tm) {
         tm->setPixmap(nullptr, executingRequest->normalizedRect(), true /*isPartialPixmap*/);
-        tm->setRequest(NormalizedRect(), 0, 0);
+        // the other tiles of the page may still be rendering, see sendGeneratorPixmapRequest()
+        tm->removeRequest(TilesManager::toRotatedRect(executingRequest->normalizedRect(), m_rotation));
     }
     PagePrivate::PixmapObject object = executingRequest->page()->d->m_pixmaps.take(executingRequest->observer());
     delete object.m_pixmap;
@@ -3307,38 +3403,39 @@ void Document::requestPixmaps(const QList<PixmapRequest *> &requests, PixmapRequ
     }
     const bool removeAllPrevious = reqOptions & RemoveAllPrevious;
     d->m_pixmapRequestsMutex.lock();
-    auto sIt = d->m_pixmapRequestsStack.begin();
-    auto sEnd = d->m_pixmapRequestsStack.end();
-    while (sIt != sEnd) {
-        if ((*sIt)->observer() == requesterObserver && (removeAllPrevious || requestedPages.contains((*sIt)->pageNumber()))) {
-            // delete request and remove it from stack
-            delete *sIt;
-            sIt = d->m_pixmapRequestsStack.erase(sIt);
-        } else {
-            ++sIt;
-        }
+    if (removeAllPrevious) {
+        d->m_pixmapRequestsStack.discardRequests(requesterObserver);
+    } else {
+        d->m_pixmapRequestsStack.discardRequests(requesterObserver, requestedPages);
     }
 
     // 1.B [PREPROCESS REQUESTS] tweak some values of the requests
+    QList<PixmapRequest *> validRequests;
+    validRequests.reserve(requests.size());
     for (PixmapRequest *request : requests) {
         // set the 'page field' (see PixmapRequest) and check if it is valid
         qCDebug(OkularCoreDebug).nospace() << "request observer=" << request->observer() << " " << request->width() << "x" << request->height() << "@" << request->pageNumber();
         if (d->m_pagesVector.value(request->pageNumber()) == nullptr) {
             // skip requests referencing an invalid page (must not happen)
             delete request;
-            request = nullptr;
             continue;
         }
 
         request->d->mPage = d->m_pagesVector.value(request->pageNumber());
 
+        if (!request->asynchronous()) {
+            request->d->mPriority = 0;
+        }
+
         if (request->isTile()) {
             // Change the current request rect so that only invalid tiles are
             // requested. Also make sure the rect is tile-aligned.
             NormalizedRect tilesRect;
+            QList<NormalizedRect> invalidTileRects;
             const QList<Tile> tiles = request->d->tilesManager()->tilesAt(request->normalizedRect(), TilesManager::TerminalTile);
             for (const Tile &tile : tiles) {
                 if (!tile.isValid()) {
+                    invalidTileRects << tile.rect();
                     if (tilesRect.isNull()) {
                         tilesRect = tile.rect();
                     } else {
@@ -3347,25 +3444,35 @@ void Document::requestPixmaps(const QList<PixmapRequest *> &requests, PixmapRequ
                 }
             }
 
+            // [PARALLEL TILES] request every tile on its own, they render at the same time and show up as each one is done
+            if (request->asynchronous() && invalidTileRects.count() > 1 && d->rendersTilesInParallel()) {
+                QList<PixmapRequest *> tileRequests = d->splitTileRequest(request, invalidTileRects);
+                // the queue takes the newest of the priority 0 requests first, the oldest of the others
+                if (request->priority() == 0) {
+                    std::ranges::reverse(tileRequests);
+                }
+                validRequests << tileRequests;
+                continue;
+            }
+
             request->setNormalizedRect(tilesRect);
         }
 
-        if (!request->asynchronous()) {
-            request->d->mPriority = 0;
-        }
+        validRequests << request;
     }
 
     // 1.C [CANCEL REQUESTS] cancel those requests that are running and should be cancelled because of the new requests coming in
     if (d->m_generator->hasFeature(Generator::SupportsCancelling)) {
+        const bool tilesInParallel = d->rendersTilesInParallel();
         for (PixmapRequest *executingRequest : std::as_const(d->m_executingPixmapRequests)) {
             bool newRequestsContainExecutingRequestPage = false;
             bool requestCancelled = false;
-            for (PixmapRequest *newRequest : requests) {
+            for (PixmapRequest *newRequest : std::as_const(validRequests)) {
                 if (newRequest->pageNumber() == executingRequest->pageNumber() && requesterObserver == executingRequest->observer()) {
                     newRequestsContainExecutingRequestPage = true;
                 }
 
-                if (shouldCancelRenderingBecauseOf(*executingRequest, *newRequest)) {
+                if (shouldCancelRenderingBecauseOf(*executingRequest, *newRequest, tilesInParallel)) {
                     requestCancelled = d->cancelRenderingBecauseOf(executingRequest, newRequest);
                 }
             }
@@ -3381,19 +3488,9 @@ void Document::requestPixmaps(const QList<PixmapRequest *> &requests, PixmapRequ
         }
     }
 
-    // 2. [ADD TO STACK] add requests to stack
-    for (PixmapRequest *request : requests) {
-        // add request to the 'stack' at the right place
-        if (request->priority() == 0) {
-            // add priority zero requests to the top of the stack
-            d->m_pixmapRequestsStack.push_back(request);
-        } else {
-            // insert in stack sorted by priority
-            auto it = std::ranges::find_if(d->m_pixmapRequestsStack, [&](const auto &it) { //
-                return it->priority() <= request->priority();
-            });
-            d->m_pixmapRequestsStack.insert(it, request);
-        }
+    // 2. [ADD TO STACK] add requests to stack, it keeps them sorted by priority
+    for (PixmapRequest *request : std::as_const(validRequests)) {
+        d->m_pixmapRequestsStack.push(request);
     }
     d->m_pixmapRequestsMutex.unlock();
 
@@ -3423,11 +3520,19 @@ void Document::requestTextPage(uint pageNumber)
 
 void DocumentPrivate::notifyAnnotationChanges(int page)
 {
+    if (m_pageImageCache) {
+        m_pageImageCache->excludePage(page);
+    }
+
     foreachObserverD(notifyPageChanged(page, DocumentObserver::Annotations));
 }
 
-void DocumentPrivate::notifyFormChanges(int /*page*/)
+void DocumentPrivate::notifyFormChanges(int page)
 {
+    if (m_pageImageCache) {
+        m_pageImageCache->excludePage(page);
+    }
+
     recalculateForms();
 }
 
@@ -3762,23 +3867,39 @@ void Document::setNextDocumentDestination(const QString &namedDestination)
 
 void Document::searchText(int searchID, const QString &text, bool fromStart, Qt::CaseSensitivity caseSensitivity, SearchType type, bool moveViewport, const QColor &color)
 {
-    d->m_searchCancelled = false;
-
     // safety checks: don't perform searches on empty or unsearchable docs
     if (!d->m_generator || !d->m_generator->hasFeature(Generator::TextExtraction) || d->m_pagesVector.isEmpty()) {
         Q_EMIT searchFinished(searchID, NoMatchFound);
         return;
     }
 
+    // a search still running with this id is replaced by this one
+    const QList<std::shared_ptr<TextSearch>> textSearches = d->m_textSearches;
+    for (const std::shared_ptr<TextSearch> &textSearch : textSearches) {
+        if (textSearch->query.searchID == searchID) {
+            d->stopTextSearch(textSearch);
+            QApplication::restoreOverrideCursor();
+        }
+    }
+
     // if searchID search not recorded, create new descriptor and init params
     auto searchIt = d->m_searches.find(searchID);
     if (searchIt == d->m_searches.end()) {
         RunningSearch *search = new RunningSearch();
         search->continueOnPage = -1;
+        search->matchedPagesKnown = false;
         searchIt = d->m_searches.insert(searchID, search);
     }
     RunningSearch *s = *searchIt;
 
+    // a refined text is only looked for on the pages the last one matched
+    std::optional<QList<int>> narrowedPages;
+    if (narrowsLastSearch(s, text, type, caseSensitivity)) {
+        narrowedPages = QList<int>(s->highlightedPages.cbegin(), s->highlightedPages.cend());
+        std::ranges::sort(*narrowedPages);
+    }
+    s->matchedPagesKnown = false;
+
     // update search structure
     bool newText = text != s->cachedString;
     s->cachedString = text;
@@ -3789,10 +3910,11 @@ void Document::searchText(int searchID, const QString &text, bool fromStart, Qt:
     s->isCurrentlySearching = true;
 
     // global data for search
-    QSet<int> *pagesToNotify = new QSet<int>;
+    std::shared_ptr<TextSearch> textSearch = std::make_shared<TextSearch>();
+    textSearch->query = {searchID, type, text, {}, caseSensitivity, color};
 
     // remove highlights from pages and queue them for notifying changes
-    *pagesToNotify += s->highlightedPages;
+    textSearch->pagesToNotify = s->highlightedPages;
     for (const int pageNumber : std::as_const(s->highlightedPages)) {
         d->m_pagesVector.at(pageNumber)->d->deleteHighlights(searchID);
     }
@@ -3801,12 +3923,24 @@ void Document::searchText(int searchID, const QString &text, bool fromStart, Qt:
     // set hourglass cursor
     QApplication::setOverrideCursor(Qt::WaitCursor);
 
-    // 1. ALLDOC - process all document marking pages
-    if (type == AllDocument) {
-        QHash<Page *, QList<RegularAreaRect *>> *pageMatches = new QHash<Page *, QList<RegularAreaRect *>>;
+    const int pageCount = d->m_pagesVector.count();
 
-        // search and highlight 'text' (as a solid phrase) on all pages
-        QTimer::singleShot(0, this, [this, pagesToNotify, pageMatches, searchID] { d->doContinueAllDocumentSearch(pagesToNotify, pageMatches, 0, searchID); });
+    // 1. ALLDOC - process all document marking pages
+    // 4. GOOGLE* - process all document marking pages, for every word in 'text'
+    if (type == AllDocument || type == GoogleAll || type == GoogleAny) {
+        if (type != AllDocument) {
+            textSearch->query.words = text.split(QLatin1Char(' '), Qt::SkipEmptyParts);
+        }
+        // the pages without the words of the text can't have a match
+        if (narrowedPages) {
+            textSearch->pages = *narrowedPages;
+        } else if (d->m_searchIndex) {
+            textSearch->pages = d->m_searchIndex->candidatePages(type == AllDocument ? QStringList {text} : textSearch->query.words, type != GoogleAny);
+        } else {
+            for (int pageNumber = 0; pageNumber < pageCount; ++pageNumber) {
+                textSearch->pages.append(pageNumber);
+            }
+        }
     }
     // 2. NEXTMATCH - find next matching item (or start from top)
     // 3. PREVMATCH - find previous matching item (or start from bottom)
@@ -3814,47 +3948,42 @@ void Document::searchText(int searchID, const QString &text, bool fromStart, Qt:
         // find out from where to start/resume search from
         const bool forward = type == NextMatch;
         const int viewportPage = (*d->m_viewportIterator).pageNumber;
-        const int fromStartSearchPage = forward ? 0 : d->m_pagesVector.count() - 1;
-        int currentPageNumber = fromStart ? fromStartSearchPage : ((s->continueOnPage != -1) ? s->continueOnPage : viewportPage);
-        const Page *lastPage = fromStart ? nullptr : d->m_pagesVector[currentPageNumber];
-        int pagesDone = 0;
+        const int fromStartSearchPage = forward ? 0 : pageCount - 1;
+        int pageNumber = fromStart ? fromStartSearchPage : ((s->continueOnPage != -1) ? s->continueOnPage : viewportPage);
+        const Page *lastPage = fromStart ? nullptr : d->m_pagesVector[pageNumber];
 
         // continue checking last TextPage first (if it is the current page)
-        RegularAreaRect *match = nullptr;
         if (lastPage && lastPage->number() == s->continueOnPage) {
+            RegularAreaRect *match = nullptr;
             if (newText) {
                 match = lastPage->findText(searchID, text, forward ? FromTop : FromBottom, caseSensitivity);
             } else {
                 match = lastPage->findText(searchID, text, forward ? NextResult : PreviousResult, caseSensitivity, &s->continueOnMatch);
             }
-            if (!match) {
-                if (forward) {
-                    currentPageNumber++;
-                } else {
-                    currentPageNumber--;
-                }
-                pagesDone++;
+            QList<TextSearchMatch> matches;
+            if (match) {
+                matches.append(TextSearchMatch(match, color));
             }
+            textSearch->results.insert(0, matches);
+            textSearch->nextPage = 1;
+        }
+
+        // loop through the whole doc, starting from the page
+        for (int i = 0; i < pageCount; ++i) {
+            if (pageNumber >= pageCount) {
+                pageNumber = 0;
+                textSearch->wrapIndex = i;
+            } else if (pageNumber < 0) {
+                pageNumber = pageCount - 1;
+                textSearch->wrapIndex = i;
+            }
+            textSearch->pages.append(pageNumber);
+            pageNumber += forward ? 1 : -1;
         }
-
-        s->pagesDone = pagesDone;
-
-        DoContinueDirectionMatchSearchStruct *searchStruct = new DoContinueDirectionMatchSearchStruct();
-        searchStruct->pagesToNotify = pagesToNotify;
-        searchStruct->match = match;
-        searchStruct->currentPage = currentPageNumber;
-        searchStruct->searchID = searchID;
-
-        QTimer::singleShot(0, this, [this, searchStruct] { d->doContinueDirectionMatchSearch(searchStruct); });
     }
-    // 4. GOOGLE* - process all document marking pages
-    else if (type == GoogleAll || type == GoogleAny) {
-        QHash<Page *, QList<QPair<RegularAreaRect *, QColor>>> *pageMatches = new QHash<Page *, QList<QPair<RegularAreaRect *, QColor>>>;
-        const QStringList words = text.split(QLatin1Char(' '), Qt::SkipEmptyParts);
 
-        // search and highlight every word in 'text' on all pages
-        QTimer::singleShot(0, this, [this, pagesToNotify, pageMatches, searchID, words] { d->doContinueGooglesDocumentSearch(pagesToNotify, pageMatches, 0, searchID, words); });
-    }
+    d->m_textSearches.append(textSearch);
+    d->scheduleTextSearch(textSearch);
 }
 
 void Document::continueSearch(int searchID)
@@ -3917,11 +4046,21 @@ void Document::resetSearch(int searchID)
     // remove search from the runningSearches list and delete it
     d->m_searches.erase(searchIt);
     delete s;
+
+    // a search still running notices it was removed and ends as cancelled
+    for (const std::shared_ptr<TextSearch> &textSearch : std::as_const(d->m_textSearches)) {
+        if (textSearch->query.searchID == searchID) {
+            d->scheduleTextSearch(textSearch);
+        }
+    }
 }
 
 void Document::cancelSearch()
 {
-    d->m_searchCancelled = true;
+    for (const std::shared_ptr<TextSearch> &textSearch : std::as_const(d->m_textSearches)) {
+        textSearch->cancelled = true;
+        d->scheduleTextSearch(textSearch);
+    }
 }
 
 void Document::undo()
@@ -4964,6 +5103,19 @@ bool Document::swapBackingFile(const QString &newFileName, const QUrl &url)
 
     d->clearAndWaitForRequests();
 
+    // stop the running searches, their jobs use the pages and the generator
+    const QList<std::shared_ptr<TextSearch>> textSearches = d->m_textSearches;
+    for (const std::shared_ptr<TextSearch> &textSearch : textSearches) {
+        d->stopTextSearch(textSearch);
+        QApplication::restoreOverrideCursor();
+        Q_EMIT searchFinished(textSearch->query.searchID, SearchCancelled);
+    }
+    d->m_textSearchWeaver.finish();
+
+    // the indexing extracts the text of the pages too, it is built again for the new file
+    delete d->m_searchIndex;
+    d->m_searchIndex = nullptr;
+
     qCDebug(OkularCoreDebug) << "Swapping backing file to" << newFileName;
     QList<Page *> newPagesVector;
     Generator::SwapBackingFileResult result = d->m_generator->swapBackingFile(newFileName, newPagesVector);
@@ -5025,6 +5177,10 @@ bool Document::swapBackingFile(const QString &newFileName, const QUrl &url)
         d->m_docFileName = newFileName;
         d->updateMetadataXmlNameAndDocSize();
         d->m_bookmarkManager->setUrl(d->m_url);
+        delete d->m_documentHash;
+        d->m_documentHash = nullptr;
+        d->updatePageImageCache(true);
+        d->updateSearchIndex(true);
         d->m_documentInfo = DocumentInfo();
         d->m_documentInfoAskedKeys.clear();
 
@@ -5044,6 +5200,8 @@ bool Document::swapBackingFile(const QString &newFileName, const QUrl &url)
 
         return true;
     } else {
+        // still the old file, index it again
+        d->updateSearchIndex(false);
         return false;
     }
 }
@@ -5543,19 +5701,15 @@ void DocumentPrivate::requestDone(PixmapRequest *req)
 
     if (!req->shouldAbortRender()) {
         // [MEM] 1.1 find and remove a previous entry for the same page and id
-        auto it = std::ranges::find_if(m_allocatedPixmaps, [&](AllocatedPixmap *const p) { //
-            return p->page == req->pageNumber() && p->observer == req->observer();
-        });
-        if (it != m_allocatedPixmaps.end()) {
-            AllocatedPixmap *p = *it;
-            m_allocatedPixmaps.erase(it);
+        if (AllocatedPixmap *p = m_allocatedPixmaps.find(req->observer(), req->pageNumber())) {
+            m_allocatedPixmaps.remove(p);
             m_allocatedPixmapsTotalMemory -= p->memory;
             delete p;
         }
 
         DocumentObserver *observer = req->observer();
         if (m_observers.contains(observer)) {
-            // [MEM] 1.2 append memory allocation descriptor to the FIFO
+            // [MEM] 1.2 add memory allocation descriptor to the index
             qulonglong memoryBytes = 0;
             const TilesManager *tm = req->d->tilesManager();
             if (tm) {
@@ -5565,9 +5719,17 @@ void DocumentPrivate::requestDone(PixmapRequest *req)
             }
 
             AllocatedPixmap *memoryPage = new AllocatedPixmap(req->observer(), req->pageNumber(), memoryBytes);
-            m_allocatedPixmaps.push_back(memoryPage);
+            m_allocatedPixmaps.insert(memoryPage);
             m_allocatedPixmapsTotalMemory += memoryBytes;
 
+            // [MEM] 1.3 keep what the generator rendered for the next time the document is opened
+            if (!req->d->mFromPageImageCache && !req->isPreview() && !req->d->mResultImage.isNull()) {
+                const QString cacheEntry = pageImageCacheEntry(req, true);
+                if (!cacheEntry.isEmpty()) {
+                    m_pageImageCache->store(req->pageNumber(), cacheEntry, req->d->mResultImage);
+                }
+            }
+
             // 2. notify an observer that its pixmap changed
             observer->notifyPageChanged(req->pageNumber(), DocumentObserver::Pixmap);
         }
@@ -5588,7 +5750,7 @@ void DocumentPrivate::requestDone(PixmapRequest *req)
 
     // 4. start a new generation if some is pending
     m_pixmapRequestsMutex.lock();
-    bool hasPixmaps = !m_pixmapRequestsStack.empty();
+    bool hasPixmaps = !m_pixmapRequestsStack.isEmpty();
     m_pixmapRequestsMutex.unlock();
     if (hasPixmaps) {
         sendGeneratorPixmapRequest();
@@ -5616,45 +5778,382 @@ void DocumentPrivate::setPageBoundingBox(int page, const NormalizedRect &boundin
     // TODO: Don't compute the bounding box if no one needs it (e.g., Trim Borders is off).
 }
 
-void DocumentPrivate::calculateMaxTextPages()
+void DocumentPrivate::pageAnnotationsLoaded(int page)
+{
+    if (!m_generator || !m_pagesVector.value(page)) {
+        return;
+    }
+
+    foreachObserverD(notifyPageChanged(page, DocumentObserver::Annotations));
+}
+
+DocumentHash *DocumentPrivate::documentHash()
 {
-    int multipliers = qMax(1, qRound(getTotalMemory() / 536870912.0)); // 512 MB
+    if (!m_documentHash) {
+        m_documentHash = new DocumentHash(m_docFileName);
+    }
+    return m_documentHash;
+}
+
+void DocumentPrivate::updatePageImageCache(bool documentChanged)
+{
+    // Documents with annotations or forms coming from docdata or an archive don't look like the file
+    QString renderSettings;
+    if (m_generator && SettingsCore::persistentPageCache() && !m_docFileName.isEmpty() && m_xmlFileName.endsWith(QLatin1String(".xml")) && !m_docdataMigrationNeeded && !m_archiveData) {
+        renderSettings = m_generator->metaData(QStringLiteral("RenderSettings"), QVariant()).toString();
+    }
+
+    if (renderSettings.isEmpty()) {
+        if (m_pageImageCache) {
+            m_pageImageCache->setDocument(QString(), QString());
+        }
+        return;
+    }
+
+    if (!m_pageImageCache) {
+        // Enabling the cache takes effect for the next opened document
+        if (!documentChanged) {
+            return;
+        }
+        m_pageImageCache = new PageImageCache();
+        QObject::connect(m_pageImageCache, &PageImageCache::loaded, m_parent, [this](PixmapRequest *request, const QImage &image, const NormalizedRect &boundingBox, bool calcBoundingBox) { //
+            cachedPixmapLoaded(request, image, boundingBox, calcBoundingBox);
+        });
+    }
+    m_pageImageCache->setMaximumSize(qint64(SettingsCore::persistentPageCacheSize()) * 1024 * 1024);
+
+    // The generator name is part of the settings since different generators render differently
+    renderSettings = m_generatorName + QLatin1Char(' ') + renderSettings;
+    if (documentChanged) {
+        // Next to the docdata file, which is named after the document
+        m_pageImageCache->setDocument(m_xmlFileName.chopped(4) + QStringLiteral(".pagecache"), renderSettings);
+
+        // Scripts and calculations can change form values right after opening
+        for (const Page *page : std::as_const(m_pagesVector)) {
+            if (!page->formFields().isEmpty()) {
+                m_pageImageCache->excludePage(page->number());
+            }
+        }
+
+        // The pages are rendered by the generator until the file is hashed
+        DocumentHash *hash = documentHash();
+        if (hash->isFinished()) {
+            m_pageImageCache->setDocumentHash(hash->result());
+        } else {
+            QObject::connect(hash, &DocumentHash::finished, m_pageImageCache, &PageImageCache::setDocumentHash);
+        }
+    } else {
+        m_pageImageCache->setRenderSettings(renderSettings);
+    }
+}
+
+void DocumentPrivate::updateSearchIndex(bool documentChanged)
+{
+    // The pages are indexed while the document is used, that needs a generator extracting text in parallel
+    const bool enabled = m_generator && SettingsCore::persistentSearchIndex() && !m_docFileName.isEmpty() && m_xmlFileName.endsWith(QLatin1String(".xml")) && m_generator->hasFeature(Generator::TextExtraction)
+        && m_generator->hasFeature(Generator::Threaded) && m_generator->hasFeature(Generator::ParallelRendering);
+
+    if (m_searchIndex && (documentChanged || !enabled)) {
+        delete m_searchIndex;
+        m_searchIndex = nullptr;
+    }
+
+    if (enabled && !m_searchIndex) {
+        // Next to the docdata file, which is named after the document
+        const QString indexFilePath = m_xmlFileName.chopped(4) + QStringLiteral(".searchindex");
+        m_searchIndex = new SearchIndex(m_generator, m_pagesVector, indexFilePath);
+
+        // the same hash as the page image cache, the file is only read once
+        DocumentHash *hash = documentHash();
+        if (hash->isFinished()) {
+            m_searchIndex->setDocumentHash(hash->result());
+        } else {
+            QObject::connect(hash, &DocumentHash::finished, m_searchIndex, &SearchIndex::setDocumentHash);
+        }
+    }
+}
+
+QString DocumentPrivate::pageImageCacheEntry(const PixmapRequest *request, bool prepared) const
+{
+    if (!m_pageImageCache || !m_pageImageCache->isActive(request->pageNumber())) {
+        return QString();
+    }
+
+    // The generator renders the unrotated page, see sendGeneratorPixmapRequest()
+    int width = request->width();
+    int height = request->height();
+    NormalizedRect tileRect = request->isTile() ? request->normalizedRect() : NormalizedRect();
+    if (!prepared) {
+        if ((int)m_rotation % 2) {
+            std::swap(width, height);
+        }
+        if (m_rotation != Rotation0 && !tileRect.isNull()) {
+            tileRect = TilesManager::fromRotatedRect(tileRect, m_rotation);
+        }
+    }
+
+    return PageImageCache::entryName(request->pageNumber(), width, height, m_rotation, tileRect);
+}
+
+void DocumentPrivate::cachedPixmapLoaded(PixmapRequest *request, const QImage &image, const NormalizedRect &boundingBox, bool calcBoundingBox)
+{
+    if (!m_generator || m_closingLoop || request->shouldAbortRender()) {
+        requestDone(request);
+        return;
+    }
+
+    // The entry went away in the meantime (e.g. evicted by another instance), render it
+    if (image.isNull()) {
+        request->d->mFromPageImageCache = false;
+        generateUncachedPixmap(request);
+        return;
+    }
+
+    // the generator didn't render the page, it may still have to fill it (e.g. with its links)
+    m_generator->preparePageFromCache(request->page());
+
+    request->d->mResultImage = image;
+    request->page()->setPixmap(request->observer(), new QPixmap(QPixmap::fromImage(image)), request->normalizedRect());
+    const int pageNumber = request->pageNumber();
+
+    requestDone(request);
+    if (calcBoundingBox) {
+        setPageBoundingBox(pageNumber, boundingBox);
+    }
+}
+
+void DocumentPrivate::generateUncachedPixmap(PixmapRequest *request)
+{
+    if (!m_generator || m_closingLoop || request->shouldAbortRender()) {
+        requestDone(request);
+        return;
+    }
+
+    if (m_generator->canGeneratePixmap()) {
+        m_generator->generatePixmap(request);
+    } else {
+        QTimer::singleShot(30, m_parent, [this, request] { generateUncachedPixmap(request); });
+    }
+}
+
+PixmapRequest *DocumentPrivate::createPreviewRequest(const PixmapRequest *request) const
+{
+    // Around a screen of pixels at most, that renders fast even on heavy pages
+    constexpr qulonglong previewPixels = 1024 * 1024;
+
+    // Tiles need pixmaps of their exact size, and a synchronous request would only block twice
+    if (!request->asynchronous() || request->preload() || request->isTile() || request->isPreview() || request->d->mPreviewSent || request->d->tilesManager() || !m_generator->hasFeature(Generator::Threaded)) {
+        return nullptr;
+    }
+
+    const qulonglong pixels = qulonglong(request->width()) * request->height();
+    if (pixels < 4 * previewPixels) {
+        return nullptr;
+    }
+
+    // Keep at least a tenth of the size so the painter still scales it up instead of showing the busy icon
+    const double scale = qBound(0.1, std::sqrt(double(previewPixels) / pixels), 0.25);
+    const int width = qMax(1, qRound(request->width() * scale));
+    const int height = qMax(1, qRound(request->height() * scale));
+
+    // Something good enough is shown already, e.g. the page at the previous zoom level
+    const QPixmap *nearestPixmap = request->page()->_o_nearestPixmap(request->observer(), request->width(), request->height());
+    if (nearestPixmap && nearestPixmap->width() >= width) {
+        return nullptr;
+    }
+
+    // width() and height() already include the device pixel ratio
+    PixmapRequest *preview = new PixmapRequest(request->observer(), request->pageNumber(), width, height, 1 /* dpr */, request->priority(), PixmapRequest::Asynchronous);
+    preview->d->mPage = request->page();
+    preview->d->mPreview = true;
+    return preview;
+}
+
+bool DocumentPrivate::rendersTilesInParallel() const
+{
+    return m_generator && m_generator->hasFeature(Generator::Threaded) && m_generator->hasFeature(Generator::ParallelRendering);
+}
+
+QList<PixmapRequest *> DocumentPrivate::splitTileRequest(PixmapRequest *request, QList<NormalizedRect> tileRects) const
+{
+    Q_ASSERT(!tileRects.isEmpty());
+
+    // The center of the requested area is the one of the viewport, or close to it
+    const NormalizedPoint center = request->normalizedRect().center();
+    std::ranges::sort(tileRects, {}, [&center](const NormalizedRect &rect) {
+        const NormalizedPoint tileCenter = rect.center();
+        return (tileCenter.x - center.x) * (tileCenter.x - center.x) + (tileCenter.y - center.y) * (tileCenter.y - center.y);
+    });
+
+    QList<PixmapRequest *> requests;
+    requests.reserve(tileRects.count());
+    request->setNormalizedRect(tileRects.first());
+    requests.append(request);
+    for (qsizetype i = 1; i < tileRects.count(); ++i) {
+        // width() and height() already include the device pixel ratio
+        PixmapRequest *tileRequest = new PixmapRequest(request->observer(), request->pageNumber(), request->width(), request->height(), 1 /* dpr */, request->priority(), PixmapRequest::NoFeature);
+        tileRequest->d->mFeatures = request->d->mFeatures;
+        tileRequest->d->mPage = request->page();
+        tileRequest->d->mForce = request->d->mForce;
+        tileRequest->d->mPartialUpdatesWanted = request->d->mPartialUpdatesWanted;
+        tileRequest->setTile(true);
+        tileRequest->setNormalizedRect(tileRects.at(i));
+        requests.append(tileRequest);
+    }
+    return requests;
+}
+
+const QPixmap *DocumentPrivate::derivablePixmap(const PixmapRequest *request) const
+{
+    // A forced request means the pixmaps of the page are outdated
+    if (request->isTile() || request->isPreview() || request->d->mForce || request->d->tilesManager()) {
+        return nullptr;
+    }
+
+    QList<const QPixmap *> pixmaps;
+    const Page *page = request->page();
+    for (const auto &[observer, object] : page->d->m_pixmaps.asKeyValueRange()) {
+        if (observer == request->observer() || object.m_isPartialPixmap || object.m_rotation != m_rotation || !m_observers.contains(observer)) {
+            continue;
+        }
+
+        // The pixmap is about to be replaced, e.g. because an annotation changed
+        if (m_pixmapRequestsStack.hasRequests(observer, page->number()) || std::ranges::any_of(m_executingPixmapRequests, [observer, page](const PixmapRequest *executing) { //
+                return executing->observer() == observer && executing->page() == page;
+            })) {
+            continue;
+        }
+
+        pixmaps << object.m_pixmap;
+    }
+
+    return derivablePixmap(pixmaps, request->width(), request->height());
+}
+
+const QPixmap *DocumentPrivate::derivablePixmap(const QList<const QPixmap *> &pixmaps, int width, int height)
+{
+    const QPixmap *bestPixmap = nullptr;
+    for (const QPixmap *pixmap : pixmaps) {
+        // Only scale down, and only pixmaps with the same aspect ratio
+        const qint64 sizeDifference = qint64(pixmap->width()) * height - qint64(pixmap->height()) * width;
+        if (pixmap->width() < width || pixmap->height() < height || qAbs(sizeDifference) > pixmap->width() + pixmap->height()) {
+            continue;
+        }
+
+        if (!bestPixmap || pixmap->width() < bestPixmap->width()) {
+            bestPixmap = pixmap;
+        }
+    }
+
+    return bestPixmap;
+}
+
+void DocumentPrivate::derivedPixmapDone(PixmapRequest *request, const QImage &image, Rotation rotation)
+{
+    // a rotation of the pages in the meantime asks for their pixmaps again
+    if (!m_generator || m_closingLoop || request->shouldAbortRender() || rotation != m_rotation) {
+        requestDone(request);
+        return;
+    }
+
+    if (image.isNull()) {
+        generateUncachedPixmap(request);
+        return;
+    }
+
+    // the image is already in the rotation of the page, unlike the ones of the generator
+    request->page()->d->setRotatedPixmap(request->observer(), new QPixmap(QPixmap::fromImage(image)));
+    requestDone(request);
+}
+
+void DocumentPrivate::calculateMaxTextPagesMemory()
+{
+    // [MEM] a text page of an average page takes about 200 KB
+    const qulonglong totalMemory = getTotalMemory();
     switch (SettingsCore::memoryLevel()) {
     case SettingsCore::EnumMemoryLevel::Low:
-        m_maxAllocatedTextPages = multipliers * 2;
+        m_maxAllocatedTextPagesMemory = totalMemory / 1024;
         break;
 
     case SettingsCore::EnumMemoryLevel::Normal:
-        m_maxAllocatedTextPages = multipliers * 50;
+        m_maxAllocatedTextPagesMemory = totalMemory / 64;
         break;
 
     case SettingsCore::EnumMemoryLevel::Aggressive:
-        m_maxAllocatedTextPages = multipliers * 250;
+        m_maxAllocatedTextPagesMemory = totalMemory / 16;
         break;
 
     case SettingsCore::EnumMemoryLevel::Greedy:
-        m_maxAllocatedTextPages = multipliers * 1250;
+        m_maxAllocatedTextPagesMemory = totalMemory / 4;
         break;
     }
 }
 
+void DocumentPrivate::cleanupTextPageMemory(qulonglong memoryToFree)
+{
+    // Free the text pages not used for the longest time, but keep the one used last
+    while (memoryToFree > 0 && m_allocatedTextPagesLru.size() > 1) {
+        const int pageToKick = m_allocatedTextPagesLru.front();
+        m_allocatedTextPagesLru.pop_front();
+        m_allocatedTextPagesLruPositions.remove(pageToKick);
+        const qulonglong memory = m_allocatedTextPagesMemory.take(pageToKick);
+        m_allocatedTextPagesTotalMemory -= memory;
+        memoryToFree = (memory < memoryToFree) ? (memoryToFree - memory) : 0;
+        m_pagesVector.at(pageToKick)->setTextPage(nullptr); // deletes the textpage
+    }
+}
+
+void DocumentPrivate::textPageUsed(int page)
+{
+    // called for each page a search goes through, moving the page to the end of the list doesn't walk it
+    const auto it = m_allocatedTextPagesLruPositions.constFind(page);
+    if (it != m_allocatedTextPagesLruPositions.constEnd()) {
+        m_allocatedTextPagesLru.splice(m_allocatedTextPagesLru.end(), m_allocatedTextPagesLru, *it);
+    }
+}
+
+void DocumentPrivate::textPageMemoryChanged(int page)
+{
+    const auto it = m_allocatedTextPagesMemory.find(page);
+    if (it == m_allocatedTextPagesMemory.end()) {
+        return;
+    }
+
+    const qulonglong memory = m_pagesVector.at(page)->d->textPageMemory();
+    if (memory == *it) {
+        return;
+    }
+    m_allocatedTextPagesTotalMemory = m_allocatedTextPagesTotalMemory - *it + memory;
+    *it = memory;
+
+    if (m_allocatedTextPagesTotalMemory > m_maxAllocatedTextPagesMemory) {
+        cleanupTextPageMemory(m_allocatedTextPagesTotalMemory - m_maxAllocatedTextPagesMemory);
+    }
+}
+
 void DocumentPrivate::textGenerationDone(Page *page)
 {
     if (!m_pageController) {
         return;
     }
 
-    // 1. If we reached the cache limit, delete the first text page from the fifo
-    if (m_allocatedTextPagesFifo.size() == m_maxAllocatedTextPages) {
-        int pageToKick = m_allocatedTextPagesFifo.takeFirst();
-        if (pageToKick != page->number()) // this should never happen but better be safe than sorry
-        {
-            m_pagesVector.at(pageToKick)->setTextPage(nullptr); // deletes the textpage
-        }
+    // 1. Add the page to the end of the list of generated text pages, as the one used last
+    const int number = page->number();
+    const auto it = m_allocatedTextPagesLruPositions.constFind(number);
+    if (it != m_allocatedTextPagesLruPositions.constEnd()) {
+        m_allocatedTextPagesLru.erase(*it);
+        m_allocatedTextPagesLruPositions.erase(it);
+        m_allocatedTextPagesTotalMemory -= m_allocatedTextPagesMemory.take(number);
     }
+    const qulonglong memory = page->d->textPageMemory();
+    m_allocatedTextPagesLruPositions.insert(number, m_allocatedTextPagesLru.insert(m_allocatedTextPagesLru.end(), number));
+    m_allocatedTextPagesMemory.insert(number, memory);
+    m_allocatedTextPagesTotalMemory += memory;
 
-    // 2. Add the page to the fifo of generated text pages
-    m_allocatedTextPagesFifo.append(page->number());
+    // 2. If we went over the cache limit, delete the text pages not used for the longest time
+    if (m_allocatedTextPagesTotalMemory > m_maxAllocatedTextPagesMemory) {
+        cleanupTextPageMemory(m_allocatedTextPagesTotalMemory - m_maxAllocatedTextPagesMemory);
+    }
 }
 
 void Document::setRotation(int r)
@@ -5706,7 +6205,6 @@ void Document::setPageSize(const PageSize &size)
         page->d->changeSize(size);
     }
     // clear 'memory allocation' descriptors
-    qDeleteAll(d->m_allocatedPixmaps);
     d->m_allocatedPixmaps.clear();
     d->m_allocatedPixmapsTotalMemory = 0;
     // notify the generator that the current page size has changed
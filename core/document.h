@@ -395,6 +395,11 @@ public:
     /**
      * Returns the meta data for the given @p key and @p option or an empty variant
      * if the key doesn't exists.
+     *
+     * Besides the keys of the generator, "PixmapRequestQueueStatistics" gives a
+     * QVariantMap with counters of the pixmap requests of the open document, to
+     * diagnose rendering delays: "queued", "peakQueued", "sent", "discarded",
+     * "totalWaitMs" and "maxWaitMs".
      */
     QVariant metaData(const QString &key, const QVariant &option = QVariant()) const;
 
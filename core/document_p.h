@@ -22,10 +22,15 @@
 #include <QMutex>
 #include <QPointer>
 #include <QUrl>
+#include <threadweaver/queue.h>
+
+#include <memory>
 
 // local includes
+#include "allocatedpixmapindex_p.h"
 #include "fontinfo.h"
 #include "generator.h"
+#include "pixmaprequestqueue_p.h"
 
 class QUndoStack;
 class QEventLoop;
@@ -34,17 +39,20 @@ class QTimer;
 class QTemporaryFile;
 class KPluginMetaData;
 
-struct AllocatedPixmap;
 struct ArchiveData;
 struct RunningSearch;
+struct TextSearch;
 
 namespace Okular
 {
 class ScriptAction;
 class ConfigInterface;
 class PageController;
+class DocumentHash;
+class PageImageCache;
 class SaveInterface;
 class Scripter;
+class SearchIndex;
 class View;
 }
 
@@ -86,13 +94,6 @@ public:
 
 class FontExtractionThread;
 
-struct DoContinueDirectionMatchSearchStruct {
-    QSet<int> *pagesToNotify;
-    RegularAreaRect *match;
-    int currentPage;
-    int searchID;
-};
-
 enum LoadDocumentInfoFlag {
     LoadNone = 0,
     LoadPageInfo = 1,    // Load annotations and forms
@@ -106,11 +107,11 @@ class DocumentPrivate
 public:
     explicit DocumentPrivate(Document *parent)
         : m_parent(parent)
-        , m_searchCancelled(false)
         , m_tempFile(nullptr)
         , m_docSize(-1)
         , m_allocatedPixmapsTotalMemory(0)
-        , m_maxAllocatedTextPages(0)
+        , m_allocatedTextPagesTotalMemory(0)
+        , m_maxAllocatedTextPagesMemory(0)
         , m_warnedOutOfMemory(false)
         , m_rotation(Rotation0)
         , m_exportCached(false)
@@ -121,6 +122,9 @@ public:
         , m_walletGenerator(nullptr)
         , m_generatorsLoaded(false)
         , m_pageController(nullptr)
+        , m_documentHash(nullptr)
+        , m_pageImageCache(nullptr)
+        , m_searchIndex(nullptr)
         , m_closingLoop(nullptr)
         , m_scripter(nullptr)
         , m_archiveData(nullptr)
@@ -131,7 +135,7 @@ public:
         , m_docdataMigrationNeeded(false)
         , m_synctex_scanner(nullptr)
     {
-        calculateMaxTextPages();
+        calculateMaxTextPagesMemory();
     }
 
     // private methods
@@ -143,7 +147,10 @@ public:
     void cleanupPixmapMemory();
     void cleanupPixmapMemory(qulonglong memoryToFree);
     AllocatedPixmap *searchLowestPriorityPixmap(bool unloadableOnly = false, bool thenRemoveIt = false, DocumentObserver *observer = nullptr /* any */);
-    void calculateMaxTextPages();
+    void calculateMaxTextPagesMemory();
+    void cleanupTextPageMemory(qulonglong memoryToFree);
+    void textPageUsed(int page);
+    void textPageMemoryChanged(int page);
     qulonglong getTotalMemory();
     qulonglong getFreeMemory(qulonglong *freeSwap = nullptr);
     bool loadDocumentInfo(LoadDocumentInfoFlags loadWhat);
@@ -197,12 +204,17 @@ public:
     void refreshPixmaps(int);
     void _o_configChanged();
 
-    typedef std::pair<RegularAreaRect *, QColor> MatchColor;
-    void doContinueDirectionMatchSearch(DoContinueDirectionMatchSearchStruct *searchStruct);
-    void doContinueAllDocumentSearch(QSet<int> *pagesToNotify, QHash<Page *, QList<RegularAreaRect *>> *pageMatches, int currentPage, int searchID);
-    void doContinueGooglesDocumentSearch(QSet<int> *pagesToNotify, QHash<Page *, QList<MatchColor>> *pageMatches, int currentPage, int searchID, const QStringList &words);
+    void doContinueTextSearch(const std::shared_ptr<TextSearch> &textSearch);
+    void scheduleTextSearch(const std::shared_ptr<TextSearch> &textSearch);
+    void textSearchJobDone(const std::shared_ptr<TextSearch> &textSearch, const ThreadWeaver::JobPointer &j);
+
+    /**
+     * Ends @p textSearch: its jobs are aborted and the results not processed yet dropped.
+     * It doesn't restore the cursor nor tell the observers.
+     */
+    void stopTextSearch(const std::shared_ptr<TextSearch> &textSearch);
 
-    void doProcessSearchMatch(RegularAreaRect *match, RunningSearch *search, QSet<int> *pagesToNotify, int currentPage, int searchID, bool moveViewport, const QColor &color);
+    void doProcessSearchMatch(RegularAreaRect *match, RunningSearch *search, QSet<int> pagesToNotify, int currentPage, int searchID, bool moveViewport, const QColor &color);
 
     /**
      * Executes a JavaScript script from the setInterval function.
@@ -222,6 +234,47 @@ public:
      * Sets the bounding box of the given @p page (in terms of upright orientation, i.e., Rotation0).
      */
     void setPageBoundingBox(int page, const NormalizedRect &boundingBox);
+    void pageAnnotationsLoaded(int page);
+
+    // persistent page cache
+    DocumentHash *documentHash();
+    void updatePageImageCache(bool documentChanged);
+    QString pageImageCacheEntry(const PixmapRequest *request, bool prepared) const;
+    void cachedPixmapLoaded(PixmapRequest *request, const QImage &image, const NormalizedRect &boundingBox, bool calcBoundingBox);
+    void generateUncachedPixmap(PixmapRequest *request);
+
+    // persistent search index
+    void updateSearchIndex(bool documentChanged);
+
+    /**
+     * Returns a new low resolution request to render before @p request,
+     * or nullptr if the page doesn't need one.
+     */
+    PixmapRequest *createPreviewRequest(const PixmapRequest *request) const;
+
+    /**
+     * Returns the pixmap of another observer that @p request can be scaled
+     * down from, or nullptr if it has to be rendered.
+     */
+    const QPixmap *derivablePixmap(const PixmapRequest *request) const;
+    /**
+     * The smallest of @p pixmaps of the whole page that a @p width x @p height
+     * pixmap of it can be scaled down from, or nullptr if none of them can.
+     */
+    OKULARCORE_EXPORT static const QPixmap *derivablePixmap(const QList<const QPixmap *> &pixmaps, int width, int height);
+    void derivedPixmapDone(PixmapRequest *request, const QImage &image, Rotation rotation);
+
+    /**
+     * Whether tile requests are split in one request per tile, rendered side by side.
+     */
+    bool rendersTilesInParallel() const;
+
+    /**
+     * Splits the tile @p request in one request per rect of @p tileRects,
+     * the tiles nearest to the center of the requested area first.
+     * @p request itself becomes the first one, the others are new.
+     */
+    QList<PixmapRequest *> splitTileRequest(PixmapRequest *request, QList<NormalizedRect> tileRects) const;
 
     /**
      * Request a particular metadata of the Document itself (ie, not something
@@ -258,7 +311,10 @@ public:
 
     // find descriptors, mapped by ID (we handle multiple searches)
     QMap<int, RunningSearch *> m_searches;
-    bool m_searchCancelled;
+    // the searches going through the pages, the text pages are extracted
+    // and searched in m_textSearchWeaver if the generator can do it in parallel
+    QList<std::shared_ptr<TextSearch>> m_textSearches;
+    ThreadWeaver::Queue m_textSearchWeaver;
 
     // needed because for remote documents docFileName is a local file and
     // we want the remote url when the document refers to relativeNames
@@ -278,14 +334,16 @@ public:
 
     // observers / requests / allocator stuff
     QSet<DocumentObserver *> m_observers;
-    // sorted by priority from lowest priority (highest number) at the head of the list to the highest priority (zero number) toward the end
-    std::list<PixmapRequest *> m_pixmapRequestsStack;
+    PixmapRequestQueue m_pixmapRequestsStack;
     std::list<PixmapRequest *> m_executingPixmapRequests;
     QMutex m_pixmapRequestsMutex;
-    std::list<AllocatedPixmap *> m_allocatedPixmaps;
+    AllocatedPixmapIndex m_allocatedPixmaps;
     qulonglong m_allocatedPixmapsTotalMemory;
-    QList<int> m_allocatedTextPagesFifo;
-    int m_maxAllocatedTextPages;
+    std::list<int> m_allocatedTextPagesLru; // least recently used first
+    QHash<int, std::list<int>::iterator> m_allocatedTextPagesLruPositions; // page -> its item in m_allocatedTextPagesLru
+    QHash<int, qulonglong> m_allocatedTextPagesMemory;
+    qulonglong m_allocatedTextPagesTotalMemory;
+    qulonglong m_maxAllocatedTextPagesMemory;
     bool m_warnedOutOfMemory;
 
     // the rotation applied to the document
@@ -320,6 +378,10 @@ public:
     QStringList m_supportedMimeTypes;
 
     PageController *m_pageController;
+    DocumentHash *m_documentHash;
+    PageImageCache *m_pageImageCache;
+    SearchIndex *m_searchIndex;
+    ThreadWeaver::Queue m_pixmapScaleWeaver;
     QEventLoop *m_closingLoop;
 
     Scripter *m_scripter;
@@ -0,0 +1,69 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "documenthash_p.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+
+#include <threadweaver/queueing.h>
+
+#include "debug_p.h"
+
+using namespace Okular;
+
+DocumentHash::DocumentHash(const QString &filePath)
+    : QObject()
+    , m_finished(false)
+{
+    m_weaver.setMaximumNumberOfThreads(1);
+    m_weaver.enqueue(ThreadWeaver::make_job([this, filePath] {
+        QByteArray result;
+        QFile file(filePath);
+        if (file.open(QIODevice::ReadOnly)) {
+            QCryptographicHash hash(QCryptographicHash::Sha1);
+            while (!file.atEnd() && file.error() == QFileDevice::NoError) {
+                if (m_aborted.loadRelaxed()) {
+                    return;
+                }
+                hash.addData(file.read(1024 * 1024));
+            }
+            if (file.error() == QFileDevice::NoError) {
+                result = hash.result();
+            }
+        }
+        if (result.isEmpty()) {
+            qCWarning(OkularCoreDebug) << "Could not hash" << filePath;
+        }
+
+        QMetaObject::invokeMethod(
+            this,
+            [this, result] {
+                m_result = result;
+                m_finished = true;
+                Q_EMIT finished(m_result);
+            },
+            Qt::QueuedConnection);
+    }));
+}
+
+DocumentHash::~DocumentHash()
+{
+    m_aborted.storeRelaxed(1);
+    m_weaver.finish();
+}
+
+bool DocumentHash::isFinished() const
+{
+    return m_finished;
+}
+
+QByteArray DocumentHash::result() const
+{
+    return m_result;
+}
+
+#include "moc_documenthash_p.cpp"
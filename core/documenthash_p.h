@@ -0,0 +1,53 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef _OKULAR_DOCUMENTHASH_P_H_
+#define _OKULAR_DOCUMENTHASH_P_H_
+
+#include "okularcore_export.h"
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+
+#include <threadweaver/queue.h>
+
+namespace Okular
+{
+/* The SHA-1 of the contents of a document file, what the data kept about
+ * the document between sessions (e.g. the persistent page image cache) is
+ * keyed on.
+ *
+ * Reading a big file takes a while, so it is hashed in a thread and the
+ * finished() signal tells when the hash is known.
+ */
+class OKULARCORE_EXPORT DocumentHash : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DocumentHash(const QString &filePath);
+    ~DocumentHash() override;
+
+    bool isFinished() const;
+
+    /* Empty until finished, and if the file could not be read */
+    QByteArray result() const;
+
+Q_SIGNALS:
+    void finished(const QByteArray &hash);
+
+private:
+    ThreadWeaver::Queue m_weaver;
+    QByteArray m_result;
+    bool m_finished;
+    QAtomicInt m_aborted; // stops reading the file
+};
+
+}
+
+#endif
@@ -40,6 +40,7 @@ GeneratorPrivate::GeneratorPrivate()
     : q_ptr(nullptr)
     , m_document(nullptr)
     , mPixmapGenerationThread(nullptr)
+    , mParallelPixmapGenerations(0)
     , mTextPageGenerationThread(nullptr)
     , mPixmapReady(true)
     , mTextPageReady(true)
@@ -58,6 +59,12 @@ GeneratorPrivate::~GeneratorPrivate()
 
     delete mPixmapGenerationThread;
 
+    for (PixmapGenerationThread *thread : std::as_const(mPixmapGenerationThreadPool)) {
+        thread->wait();
+    }
+
+    qDeleteAll(mPixmapGenerationThreadPool);
+
     if (mTextPageGenerationThread) {
         mTextPageGenerationThread->wait();
     }
@@ -73,11 +80,45 @@ PixmapGenerationThread *GeneratorPrivate::pixmapGenerationThread()
 
     Q_Q(Generator);
     mPixmapGenerationThread = new PixmapGenerationThread(q);
-    QObject::connect(mPixmapGenerationThread, &PixmapGenerationThread::finished, q, [this] { pixmapGenerationFinished(); }, Qt::QueuedConnection);
+    QObject::connect(mPixmapGenerationThread, &PixmapGenerationThread::finished, q, [this] { pixmapGenerationFinished(mPixmapGenerationThread); }, Qt::QueuedConnection);
 
     return mPixmapGenerationThread;
 }
 
+PixmapGenerationThread *GeneratorPrivate::idlePixmapGenerationThread()
+{
+    // A thread is idle once pixmapGenerationFinished() has handed its request back to the document,
+    // checking isRunning() is not enough since the finished() handler is queued
+    for (PixmapGenerationThread *thread : std::as_const(mPixmapGenerationThreadPool)) {
+        if (!thread->request()) {
+            return thread;
+        }
+    }
+
+    if (mPixmapGenerationThreadPool.size() >= maxParallelPixmapGenerations()) {
+        return nullptr;
+    }
+
+    Q_Q(Generator);
+    PixmapGenerationThread *thread = new PixmapGenerationThread(q);
+    QObject::connect(thread, &PixmapGenerationThread::finished, q, [this, thread] { pixmapGenerationFinished(thread); }, Qt::QueuedConnection);
+    mPixmapGenerationThreadPool.append(thread);
+
+    return thread;
+}
+
+int GeneratorPrivate::maxParallelPixmapGenerations()
+{
+    // Keep one core for the GUI thread, and don't go too wide since every
+    // request in flight holds a full resolution image until it is done
+    return qBound(1, QThread::idealThreadCount() - 1, 8);
+}
+
+bool GeneratorPrivate::pixmapGenerationsIdle() const
+{
+    return mPixmapReady && mParallelPixmapGenerations == 0;
+}
+
 TextPageGenerationThread *GeneratorPrivate::textPageGenerationThread()
 {
     if (mTextPageGenerationThread) {
@@ -91,19 +132,24 @@ TextPageGenerationThread *GeneratorPrivate::textPageGenerationThread()
     return mTextPageGenerationThread;
 }
 
-void GeneratorPrivate::pixmapGenerationFinished()
+void GeneratorPrivate::pixmapGenerationFinished(PixmapGenerationThread *thread)
 {
     Q_Q(Generator);
-    PixmapRequest *request = mPixmapGenerationThread->request();
-    const QImage &img = mPixmapGenerationThread->image();
-    mPixmapGenerationThread->endGeneration();
+    PixmapRequest *request = thread->request();
+    const QImage &img = thread->image();
+    thread->endGeneration();
 
     QMutexLocker locker(threadsLock());
 
-    if (m_closing) {
+    if (thread == mPixmapGenerationThread) {
         mPixmapReady = true;
+    } else {
+        --mParallelPixmapGenerations;
+    }
+
+    if (m_closing) {
         delete request;
-        if (mTextPageReady) {
+        if (mTextPageReady && pixmapGenerationsIdle()) {
             locker.unlock();
             m_closingLoop->quit();
         }
@@ -114,18 +160,17 @@ void GeneratorPrivate::pixmapGenerationFinished()
         request->page()->setPixmap(request->observer(), new QPixmap(QPixmap::fromImage(img)), request->normalizedRect());
         const int pageNumber = request->page()->number();
 
-        if (mPixmapGenerationThread->calcBoundingBox()) {
-            q->updatePageBoundingBox(pageNumber, mPixmapGenerationThread->boundingBox());
+        if (thread->calcBoundingBox()) {
+            q->updatePageBoundingBox(pageNumber, thread->boundingBox());
         }
     } else {
-        // Cancel the text page generation too if it's still running
-        if (mTextPageGenerationThread && mTextPageGenerationThread->isRunning()) {
+        // Cancel the text page generation too if it's still running for this page
+        if (mTextPageGenerationThread && mTextPageGenerationThread->isRunning() && mTextPageGenerationThread->page() == request->page()) {
             mTextPageGenerationThread->abortExtraction();
             mTextPageGenerationThread->wait();
         }
     }
 
-    mPixmapReady = true;
     q->signalPixmapRequestDone(request);
 }
 
@@ -140,7 +185,7 @@ void GeneratorPrivate::textpageGenerationFinished()
 
     if (m_closing) {
         delete mTextPageGenerationThread->textPage();
-        if (mPixmapReady) {
+        if (pixmapGenerationsIdle()) {
             locker.unlock();
             m_closingLoop->quit();
         }
@@ -223,7 +268,7 @@ bool Generator::closeDocument()
     d->m_closing = true;
 
     d->threadsLock()->lock();
-    if (!(d->mPixmapReady && d->mTextPageReady)) {
+    if (!(d->pixmapGenerationsIdle() && d->mTextPageReady)) {
         QEventLoop loop;
         d->m_closingLoop = &loop;
 
@@ -246,6 +291,9 @@ bool Generator::closeDocument()
 bool Generator::canGeneratePixmap() const
 {
     Q_D(const Generator);
+    if (hasFeature(ParallelRendering)) {
+        return d->mPixmapReady && d->mParallelPixmapGenerations < GeneratorPrivate::maxParallelPixmapGenerations();
+    }
     return d->mPixmapReady;
 }
 
@@ -279,9 +327,37 @@ void Generator::setActiveCertificateBackend(Okular::CertificateInfo::Backend new
 void Generator::generatePixmap(PixmapRequest *request)
 {
     Q_D(Generator);
-    d->mPixmapReady = false;
 
-    const bool calcBoundingBox = !request->isTile() && !request->page()->isBoundingBoxKnown();
+    // the bounding box of a preview would stay as inaccurate as the preview itself
+    const bool calcBoundingBox = !request->isTile() && !request->isPreview() && !request->page()->isBoundingBoxKnown();
+
+    if (request->asynchronous() && hasFeature(Threaded) && hasFeature(ParallelRendering)) {
+        PixmapGenerationThread *thread = d->idlePixmapGenerationThread();
+        if (!thread) {
+            // canGeneratePixmap() said there was room, so this should not happen, but try again later
+            QTimer::singleShot(0, this, [this, request] { generatePixmap(request); });
+            return;
+        }
+        ++d->mParallelPixmapGenerations;
+
+        // Same as below, but the text page thread is shared by all pixmap threads
+        // so only use it if it's really free, next request will take it otherwise
+        if (hasFeature(TextExtraction) && !request->page()->hasTextPage() && canGenerateTextPage() && !d->m_closing) {
+            d->mTextPageReady = false;
+            d->textPageGenerationThread()->setPage(request->page());
+
+            QObject *dummy = new QObject();
+            connect(thread, &QThread::started, dummy, [this, dummy] {
+                delete dummy;
+                d_ptr->textPageGenerationThread()->startGeneration();
+            });
+        }
+        thread->startGeneration(request, calcBoundingBox);
+
+        return;
+    }
+
+    d->mPixmapReady = false;
 
     if (request->asynchronous() && hasFeature(Threaded)) {
         if (d->textPageGenerationThread()->isFinished() && !canGenerateTextPage()) {
@@ -315,6 +391,7 @@ void Generator::generatePixmap(PixmapRequest *request)
     }
 
     const QImage &img = image(request);
+    PixmapRequestPrivate::get(request)->mResultImage = img;
     request->page()->setPixmap(request->observer(), new QPixmap(QPixmap::fromImage(img)), request->normalizedRect());
     const int pageNumber = request->page()->number();
 
@@ -351,6 +428,10 @@ TextPage *Generator::textPage(TextRequest *)
     return nullptr;
 }
 
+void Generator::preparePageFromCache(Page *)
+{
+}
+
 DocumentInfo Generator::generateDocumentInfo(const QSet<DocumentInfo::Key> &keys) const
 {
     Q_UNUSED(keys);
@@ -537,6 +618,14 @@ void Generator::updatePageBoundingBox(int page, const NormalizedRect &boundingBo
     }
 }
 
+void Generator::signalPageAnnotationsLoaded(int page)
+{
+    Q_D(Generator);
+    if (d->m_document) { // still connected to document?
+        d->m_document->pageAnnotationsLoaded(page);
+    }
+}
+
 QByteArray Generator::requestFontData(const Okular::FontInfo & /*font*/)
 {
     return {};
@@ -606,6 +695,9 @@ PixmapRequest::PixmapRequest(DocumentObserver *observer, int pageNumber, int wid
     d->mTile = false;
     d->mNormalizedRect = NormalizedRect();
     d->mPartialUpdatesWanted = false;
+    d->mFromPageImageCache = false;
+    d->mPreview = false;
+    d->mPreviewSent = false;
     d->mShouldAbortRender = 0;
 }
 
@@ -688,6 +780,11 @@ bool PixmapRequest::partialUpdatesWanted() const
     return d->mPartialUpdatesWanted;
 }
 
+bool PixmapRequest::isPreview() const
+{
+    return d->mPreview;
+}
+
 bool PixmapRequest::shouldAbortRender() const
 {
     return d->mShouldAbortRender != 0;
@@ -828,6 +925,7 @@ QDebug operator<<(QDebug str, const Okular::PixmapRequest &req)
     str << "- rect:" << req.normalizedRect();
     str << "- preload:" << (req.preload() ? "true" : "false");
     str << "- partialUpdates:" << (req.partialUpdatesWanted() ? "true" : "false");
+    str << "- preview:" << (req.isPreview() ? "true" : "false");
     str << "- shouldAbort:" << (req.shouldAbortRender() ? "true" : "false");
     str << "- force:" << (reqPriv->mForce ? "true" : "false");
     return str;
@@ -189,6 +189,8 @@ class OKULARCORE_EXPORT Generator : public QObject
     /// @cond PRIVATE
     friend class PixmapGenerationThread;
     friend class TextPageGenerationThread;
+    friend class TextSearchJobInternal;
+    friend class SearchIndexPageJobInternal;
     /// @endcond
 
     Q_OBJECT
@@ -199,17 +201,18 @@ public:
      * provide.
      */
     enum GeneratorFeature {
-        Threaded,          ///< Whether the Generator supports asynchronous generation of pictures or text pages
-        TextExtraction,    ///< Whether the Generator can extract text from the document in the form of TextPage's
-        ReadRawData,       ///< Whether the Generator can read a document directly from its raw data.
-        FontInfo,          ///< Whether the Generator can provide information about the fonts used in the document
-        PageSizes,         ///< Whether the Generator can change the size of the document pages.
-        PrintNative,       ///< Whether the Generator supports native cross-platform printing (QPainter-based).
-        PrintPostscript,   ///< Whether the Generator supports postscript-based file printing.
-        PrintToFile,       ///< Whether the Generator supports export to PDF & PS through the Print Dialog
-        TiledRendering,    ///< Whether the Generator can render tiles @since 0.16 (KDE 4.10)
-        SwapBackingFile,   ///< Whether the Generator can hot-swap the file it's reading from @since 1.3
-        SupportsCancelling ///< Whether the Generator can cancel requests @since 1.4
+        Threaded,           ///< Whether the Generator supports asynchronous generation of pictures or text pages
+        TextExtraction,     ///< Whether the Generator can extract text from the document in the form of TextPage's
+        ReadRawData,        ///< Whether the Generator can read a document directly from its raw data.
+        FontInfo,           ///< Whether the Generator can provide information about the fonts used in the document
+        PageSizes,          ///< Whether the Generator can change the size of the document pages.
+        PrintNative,        ///< Whether the Generator supports native cross-platform printing (QPainter-based).
+        PrintPostscript,    ///< Whether the Generator supports postscript-based file printing.
+        PrintToFile,        ///< Whether the Generator supports export to PDF & PS through the Print Dialog
+        TiledRendering,     ///< Whether the Generator can render tiles @since 0.16 (KDE 4.10)
+        SwapBackingFile,    ///< Whether the Generator can hot-swap the file it's reading from @since 1.3
+        SupportsCancelling, ///< Whether the Generator can cancel requests @since 1.4
+        ParallelRendering   ///< Whether the Generator can render several pixmap requests at the same time from different threads @since 26.04
     };
 
     /**
@@ -448,6 +451,11 @@ public:
     /**
      * This method returns the meta data of the given @p key with the given @p option
      * of the document.
+     *
+     * The "RenderSettings" key is asked for a string that changes whenever the
+     * images returned by image() would change for reasons other than the document
+     * contents (e.g. render hints or paper color). Generators returning a non empty
+     * string get their images kept in the persistent page cache, see preparePageFromCache().
      */
     virtual QVariant metaData(const QString &key, const QVariant &option) const;
 
@@ -577,6 +585,19 @@ protected:
      */
     virtual TextPage *textPage(TextRequest *request);
 
+    /**
+     * This method is called instead of image() when the image of a request for
+     * the page @p page is taken from the persistent page cache (see metaData()).
+     *
+     * Generators that fill the page while rendering it, e.g. with the object
+     * rects of its links, have to do that here for the pages they didn't render.
+     *
+     * Called from the main thread, the default implementation does nothing.
+     *
+     * @since 26.04
+     */
+    virtual void preparePageFromCache(Page *page);
+
     /**
      * Returns a pointer to the document.
      */
@@ -619,6 +640,17 @@ protected:
      */
     void updatePageBoundingBox(int page, const NormalizedRect &boundingBox);
 
+    /**
+     * Tell the Document that annotations were added to the page @p page after
+     * the page has already been handed to the Document, e.g. because the
+     * generator loads them in the background, so that all observers are notified.
+     *
+     * Must be called from the main thread.
+     *
+     * @since 26.04
+     */
+    void signalPageAnnotationsLoaded(int page);
+
     /**
      * Returns DPI, previously set via setDPI()
      * @since 0.19 (KDE 4.13)
@@ -775,6 +807,17 @@ public:
      */
     bool partialUpdatesWanted() const;
 
+    /**
+     * Returns whether the request is a quick low resolution render of the page,
+     * made while the request for the real size waits behind it.
+     *
+     * Generators can use it to pick faster rendering options, the result is
+     * scaled up and replaced once the real request is done.
+     *
+     * @since 26.04
+     */
+    bool isPreview() const;
+
     /**
      * Should the request be aborted if possible?
      *
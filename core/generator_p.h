@@ -13,6 +13,7 @@
 #include "area.h"
 
 #include <QImage>
+#include <QList>
 #include <QMutex>
 #include <QSet>
 #include <QThread>
@@ -48,7 +49,12 @@ public:
     PixmapGenerationThread *pixmapGenerationThread();
     TextPageGenerationThread *textPageGenerationThread();
 
-    void pixmapGenerationFinished();
+    // Used instead of pixmapGenerationThread() by generators with the ParallelRendering feature
+    PixmapGenerationThread *idlePixmapGenerationThread();
+    static int maxParallelPixmapGenerations();
+    bool pixmapGenerationsIdle() const;
+
+    void pixmapGenerationFinished(PixmapGenerationThread *thread);
     void textpageGenerationFinished();
 
     QMutex *threadsLock();
@@ -61,6 +67,8 @@ public:
     // but it is not to avoid #include'ing generator.h
     QSet<int> m_features;
     PixmapGenerationThread *mPixmapGenerationThread;
+    QList<PixmapGenerationThread *> mPixmapGenerationThreadPool;
+    int mParallelPixmapGenerations;
     TextPageGenerationThread *mTextPageGenerationThread;
     mutable QMutex m_mutex;
     QMutex m_threadsMutex;
@@ -89,6 +97,9 @@ public:
     bool mForce : 1;
     bool mTile : 1;
     bool mPartialUpdatesWanted : 1;
+    bool mFromPageImageCache : 1;
+    bool mPreview : 1;
+    bool mPreviewSent : 1;
     Page *mPage;
     NormalizedRect mNormalizedRect;
     QAtomicInt mShouldAbortRender;
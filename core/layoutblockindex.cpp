@@ -0,0 +1,92 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "layoutblockindex_p.h"
+
+#include <cmath>
+#include <numeric>
+
+using namespace Okular;
+
+LayoutBlockIndex::LayoutBlockIndex(const QList<LayoutBlock> &blocks)
+{
+    if (blocks.isEmpty()) {
+        return;
+    }
+
+    m_blocks.reserve(blocks.count());
+    for (qsizetype i = 0; i < blocks.count(); ++i) {
+        const LayoutBlock &block = blocks.at(i);
+        m_blocks.append({block.bbox, block.readingOrder});
+        if (!m_readingOrders.contains(block.readingOrder)) {
+            m_readingOrders.insert(block.readingOrder, i);
+        }
+    }
+
+    // About one block per cell for blocks spread over the page
+    m_gridSize = qBound(1, int(std::ceil(std::sqrt(double(blocks.count())))), 64);
+
+    const auto forEachCell = [this](const NormalizedRect &bbox, const auto &function) {
+        for (int row = cell(bbox.top); row <= cell(bbox.bottom); ++row) {
+            for (int column = cell(bbox.left); column <= cell(bbox.right); ++column) {
+                function(row * m_gridSize + column);
+            }
+        }
+    };
+
+    // The blocks are put in the cells in their order, so the first one found is the first one of the list
+    m_cellStarts.fill(0, m_gridSize * m_gridSize + 1);
+    for (const Block &block : std::as_const(m_blocks)) {
+        forEachCell(block.bbox, [this](int c) { ++m_cellStarts[c + 1]; });
+    }
+    std::partial_sum(m_cellStarts.begin(), m_cellStarts.end(), m_cellStarts.begin());
+
+    m_cellBlocks.resize(m_cellStarts.constLast());
+    QList<int> cellEnds = m_cellStarts;
+    for (qsizetype i = 0; i < m_blocks.count(); ++i) {
+        forEachCell(m_blocks.at(i).bbox, [this, &cellEnds, i](int c) { m_cellBlocks[cellEnds[c]++] = i; });
+    }
+}
+
+int LayoutBlockIndex::cell(double position) const
+{
+    // the positions out of the page are in the cells at its edges, NaN too
+    if (!(position > 0)) {
+        return 0;
+    }
+    if (position >= 1) {
+        return m_gridSize - 1;
+    }
+    return qMin(int(position * m_gridSize), m_gridSize - 1);
+}
+
+qsizetype LayoutBlockIndex::blockContaining(double x, double y, int minOrder, int maxOrder) const
+{
+    if (m_gridSize == 0) {
+        return -1;
+    }
+
+    const int c = cell(y) * m_gridSize + cell(x);
+    for (int k = m_cellStarts.at(c); k < m_cellStarts.at(c + 1); ++k) {
+        const int i = m_cellBlocks.at(k);
+        const Block &block = m_blocks.at(i);
+        if (block.readingOrder >= minOrder && block.readingOrder <= maxOrder && block.bbox.contains(x, y)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+qsizetype LayoutBlockIndex::blockWithReadingOrder(int readingOrder) const
+{
+    return m_readingOrders.value(readingOrder, -1);
+}
+
+qulonglong LayoutBlockIndex::memoryUsage() const
+{
+    // a QHash node is about the key and value with a pointer of the span
+    return m_blocks.capacity() * sizeof(Block) + (m_cellStarts.capacity() + m_cellBlocks.capacity()) * sizeof(int) + m_readingOrders.capacity() * (sizeof(int) + sizeof(qsizetype) + sizeof(void *));
+}
@@ -0,0 +1,69 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef _OKULAR_LAYOUTBLOCKINDEX_P_H_
+#define _OKULAR_LAYOUTBLOCKINDEX_P_H_
+
+#include "okularcore_export.h"
+
+#include <QHash>
+#include <QList>
+
+#include <climits>
+
+#include "area.h"
+
+namespace Okular
+{
+/**
+ * A uniform grid over the bounding boxes of the layout blocks of a page, to find
+ * the block of a point without going through all of them.
+ *
+ * The blocks are found by their position in the list the index was made from,
+ * and a point in several blocks gives the first one of the list, like going
+ * through the list does.
+ */
+class OKULARCORE_EXPORT LayoutBlockIndex
+{
+public:
+    LayoutBlockIndex() = default;
+    explicit LayoutBlockIndex(const QList<LayoutBlock> &blocks);
+
+    /**
+     * The position of the first block containing the point (@p x, @p y) whose reading
+     * order is between @p minOrder and @p maxOrder (inclusive), -1 if there's none
+     */
+    qsizetype blockContaining(double x, double y, int minOrder = INT_MIN, int maxOrder = INT_MAX) const;
+
+    /**
+     * The position of the first block with the reading order @p readingOrder, -1 if there's none
+     */
+    qsizetype blockWithReadingOrder(int readingOrder) const;
+
+    /**
+     * An estimate of the memory used by the index, in bytes
+     */
+    qulonglong memoryUsage() const;
+
+private:
+    int cell(double position) const;
+
+    struct Block {
+        NormalizedRect bbox;
+        int readingOrder;
+    };
+
+    int m_gridSize = 0;
+    QList<Block> m_blocks;
+    // the blocks overlapping each cell, row after row, are m_cellBlocks from m_cellStarts[cell] to m_cellStarts[cell + 1]
+    QList<int> m_cellStarts;
+    QList<int> m_cellBlocks;
+    QHash<int, qsizetype> m_readingOrders;
+};
+
+}
+
+#endif
@@ -106,6 +106,38 @@ PagePrivate *PagePrivate::get(Page *page)
     return page ? page->d : nullptr;
 }
 
+qulonglong PagePrivate::textPageMemory() const
+{
+    return m_text ? m_text->d->memoryUsage() : 0;
+}
+
+void PagePrivate::prepareTextPage(TextPage *textPage) const
+{
+    textPage->d->m_page = m_page;
+    // Correct/optimize text order for search and text selection
+    textPage->d->correctTextOrder();
+}
+
+void PagePrivate::setPreparedTextPage(TextPage *textPage)
+{
+    delete m_text;
+    m_text = textPage;
+}
+
+void PagePrivate::textPageUsed() const
+{
+    if (m_doc && m_text) {
+        m_doc->textPageUsed(m_number);
+    }
+}
+
+void PagePrivate::textPageMemoryChanged() const
+{
+    if (m_doc && m_text) {
+        m_doc->textPageMemoryChanged(m_number);
+    }
+}
+
 void PagePrivate::imageRotationDone(RotationJob *job)
 {
     TilesManager *tm = tilesManager(job->observer());
@@ -267,6 +299,7 @@ TextPage *Page::textPage() const
 std::unique_ptr<RegularAreaRect> Page::wordAt(const NormalizedPoint &p) const
 {
     if (d->m_text) {
+        d->textPageUsed();
         return d->m_text->wordAt(p);
     }
 
@@ -276,6 +309,7 @@ std::unique_ptr<RegularAreaRect> Page::wordAt(const NormalizedPoint &p) const
 std::unique_ptr<RegularAreaRect> Page::textArea(const TextSelection &selection, bool allowCrossBlock) const
 {
     if (d->m_text) {
+        d->textPageUsed();
         return d->m_text->textArea(selection, allowCrossBlock);
     }
 
@@ -333,7 +367,9 @@ RegularAreaRect *Page::findText(int id, const QString &text, SearchDirection dir
         return rect;
     }
 
+    d->textPageUsed();
     rect = d->m_text->findText(id, text, direction, caseSensitivity, lastRect);
+    d->textPageMemoryChanged();
     return rect;
 }
 
@@ -349,6 +385,7 @@ QString Page::text(const RegularAreaRect *area, TextPage::TextAreaInclusionBehav
     if (!d->m_text) {
         return ret;
     }
+    d->textPageUsed();
 
     if (area) {
         RegularAreaRect rotatedArea = *area;
@@ -588,16 +625,25 @@ void PagePrivate::setPixmap(DocumentObserver *observer, QPixmap *pixmap, const N
     }
 }
 
-void Page::setTextPage(TextPage *textPage)
+void PagePrivate::setRotatedPixmap(DocumentObserver *observer, QPixmap *pixmap)
 {
-    delete d->m_text;
+    QMap<DocumentObserver *, PagePrivate::PixmapObject>::iterator it = m_pixmaps.find(observer);
+    if (it != m_pixmaps.end()) {
+        delete it.value().m_pixmap;
+    } else {
+        it = m_pixmaps.insert(observer, PagePrivate::PixmapObject());
+    }
+    it.value().m_pixmap = pixmap;
+    it.value().m_rotation = m_rotation;
+    it.value().m_isPartialPixmap = false;
+}
 
-    d->m_text = textPage;
-    if (d->m_text) {
-        d->m_text->d->m_page = this;
-        // Correct/optimize text order for search and text selection
-        d->m_text->d->correctTextOrder();
+void Page::setTextPage(TextPage *textPage)
+{
+    if (textPage) {
+        d->prepareTextPage(textPage);
     }
+    d->setPreparedTextPage(textPage);
 }
 
 void Page::setObjectRects(const QList<ObjectRect *> &rects)
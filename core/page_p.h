@@ -123,6 +123,35 @@ public:
      */
     void setTilesManager(const DocumentObserver *observer, TilesManager *tm);
 
+    /**
+     * An estimate of the memory used by the text page, 0 if there's none
+     */
+    qulonglong textPageMemory() const;
+
+    /**
+     * Prepares @p textPage to be the text page of this page (links it to the
+     * page and corrects its text order). It only reads the page, so it can be
+     * called from any thread, see setPreparedTextPage().
+     */
+    void prepareTextPage(TextPage *textPage) const;
+
+    /**
+     * Sets @p textPage, prepared with prepareTextPage(), as the text page of this page
+     */
+    void setPreparedTextPage(TextPage *textPage);
+
+    /**
+     * Tells the document the text page was used, so it's kept over the
+     * ones that weren't used for longer
+     */
+    void textPageUsed() const;
+
+    /**
+     * Tells the document the memory used by the text page changed, e.g. after
+     * the first search of the page built its search text
+     */
+    void textPageMemoryChanged() const;
+
     /**
      * Moves contents that are generated from oldPage to this. And clears them from page
      * so it can be deleted fine.
@@ -136,6 +165,11 @@ public:
 
     void setPixmap(DocumentObserver *observer, QPixmap *pixmap, const NormalizedRect &rect, bool isPartialPixmap);
 
+    /*
+     * Sets the pixmap of the whole page for an observer without tiles, when it is already in the rotation of the page
+     */
+    void setRotatedPixmap(DocumentObserver *observer, QPixmap *pixmap);
+
     class PixmapObject
     {
     public:
@@ -0,0 +1,362 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "pageimagecache_p.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <vector>
+
+#include <threadweaver/queueing.h>
+
+#include "debug_p.h"
+#include "utils.h"
+
+using namespace Okular;
+
+// Gives the files it removed
+static QStringList evictLeastRecentlyUsed(const QString &directory, qint64 maximumSize)
+{
+    struct CacheFile {
+        QDateTime lastUsed;
+        qint64 size;
+        QString path;
+    };
+
+    // the docdata directory is shared with the other files kept about the documents,
+    // only the .pagecache directories of the documents are the cache's
+    QStringList cacheDirectories;
+    QDirIterator cacheDirIt(directory, {QStringLiteral("*.pagecache")}, QDir::Dirs | QDir::NoDotAndDotDot);
+    while (cacheDirIt.hasNext()) {
+        cacheDirectories << cacheDirIt.next();
+    }
+
+    std::vector<CacheFile> files;
+    qint64 totalSize = 0;
+    for (const QString &cacheDirectory : std::as_const(cacheDirectories)) {
+        QDirIterator it(cacheDirectory, {QStringLiteral("*.png")}, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            const QFileInfo info = it.nextFileInfo();
+            files.push_back({info.lastModified(), info.size(), info.filePath()});
+            totalSize += info.size();
+        }
+    }
+
+    if (totalSize <= maximumSize) {
+        return {};
+    }
+
+    // Go a bit below the limit so we don't have to evict again on the next store
+    const qint64 targetSize = maximumSize - maximumSize / 10;
+    QStringList removed;
+    std::ranges::sort(files, {}, &CacheFile::lastUsed);
+    for (const CacheFile &file : files) {
+        if (totalSize <= targetSize) {
+            break;
+        }
+        if (QFile::remove(file.path)) {
+            totalSize -= file.size;
+            removed << file.path;
+        }
+    }
+
+    // rmdir() only removes the directories left empty, deepest first
+    QStringList directories = cacheDirectories;
+    for (const QString &cacheDirectory : std::as_const(cacheDirectories)) {
+        QDirIterator dirIt(cacheDirectory, QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+        while (dirIt.hasNext()) {
+            directories << dirIt.next();
+        }
+    }
+    std::ranges::sort(directories, std::greater {}, &QString::size);
+    for (const QString &dir : std::as_const(directories)) {
+        QDir().rmdir(dir);
+    }
+
+    qCDebug(OkularCoreDebug) << "Page image cache trimmed to" << totalSize << "bytes";
+    return removed;
+}
+
+static QImage readEntryFile(const QString &filePath, bool calcBoundingBox, NormalizedRect *boundingBox)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QImage();
+    }
+
+    // the modification time is what the eviction uses to know when an entry was last used
+    file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+
+    QImageReader reader(&file, "png");
+    QImage image = reader.read();
+    if (!image.isNull() && calcBoundingBox) {
+        *boundingBox = Utils::imageBoundingBox(&image);
+    }
+    return image;
+}
+
+PageImageLoadJob::PageImageLoadJob(PixmapRequest *request, const QString &entry, const QString &filePath, bool calcBoundingBox)
+    : ThreadWeaver::QObjectDecorator(new PageImageLoadJobInternal(filePath, calcBoundingBox))
+    , mRequest(request)
+    , mEntry(entry)
+    , mFilePath(filePath)
+    , mCalcBoundingBox(calcBoundingBox)
+{
+}
+
+PixmapRequest *PageImageLoadJob::request() const
+{
+    return mRequest;
+}
+
+QString PageImageLoadJob::entry() const
+{
+    return mEntry;
+}
+
+QString PageImageLoadJob::filePath() const
+{
+    return mFilePath;
+}
+
+bool PageImageLoadJob::calcBoundingBox() const
+{
+    return mCalcBoundingBox;
+}
+
+PageImageLoadJobInternal::PageImageLoadJobInternal(const QString &filePath, bool calcBoundingBox)
+    : mFilePath(filePath)
+    , mCalcBoundingBox(calcBoundingBox)
+{
+}
+
+QImage PageImageLoadJobInternal::image() const
+{
+    return mImage;
+}
+
+NormalizedRect PageImageLoadJobInternal::boundingBox() const
+{
+    return mBoundingBox;
+}
+
+void PageImageLoadJobInternal::run(ThreadWeaver::JobPointer self, ThreadWeaver::Thread *thread)
+{
+    Q_UNUSED(self);
+    Q_UNUSED(thread);
+
+    mImage = readEntryFile(mFilePath, mCalcBoundingBox, &mBoundingBox);
+}
+
+PageImageCache::PageImageCache()
+    : QObject()
+    , m_allPagesExcluded(true)
+    , m_maximumSize(0)
+    , m_storedSinceEviction(0)
+{
+    // One thread keeps the disk operations in order, e.g. a store can't race the removal of its directory
+    m_weaver.setMaximumNumberOfThreads(1);
+}
+
+PageImageCache::~PageImageCache()
+{
+    m_weaver.finish();
+}
+
+QString PageImageCache::cacheDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + QStringLiteral("/okular/docdata");
+}
+
+void PageImageCache::setDocument(const QString &directory, const QString &renderSettings)
+{
+    m_documentHash.clear();
+    m_renderSettings = directory.isEmpty() ? QString() : renderSettings;
+    m_documentDirectory = directory;
+    m_directory.clear();
+    m_entries.clear();
+    m_excludedPages.clear();
+    m_allPagesExcluded = renderSettings.isEmpty();
+}
+
+void PageImageCache::setDocumentHash(const QByteArray &documentHash)
+{
+    if (m_renderSettings.isEmpty() || documentHash.isEmpty() || !m_documentHash.isEmpty()) {
+        return;
+    }
+
+    m_documentHash = QString::fromLatin1(documentHash.toHex());
+    openDirectory(m_renderSettings);
+
+    // the file of the document changed since the images of other hashes were rendered
+    const QString documentDirectory = m_documentDirectory;
+    const QString currentHash = m_documentHash;
+    m_weaver.enqueue(ThreadWeaver::make_job([documentDirectory, currentHash] {
+        const QStringList hashes = QDir(documentDirectory).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QString &hash : hashes) {
+            if (hash != currentHash) {
+                QDir(documentDirectory + QLatin1Char('/') + hash).removeRecursively();
+            }
+        }
+    }));
+    enqueueEviction();
+}
+
+void PageImageCache::setRenderSettings(const QString &renderSettings)
+{
+    if (m_renderSettings.isEmpty()) {
+        return;
+    }
+    m_renderSettings = renderSettings;
+    if (m_documentHash.isEmpty()) {
+        return;
+    }
+
+    const QString oldDirectory = m_directory;
+    openDirectory(renderSettings);
+    if (m_directory != oldDirectory) {
+        m_weaver.enqueue(ThreadWeaver::make_job([oldDirectory] { QDir(oldDirectory).removeRecursively(); }));
+    }
+}
+
+void PageImageCache::setMaximumSize(qint64 bytes)
+{
+    m_maximumSize = bytes;
+}
+
+void PageImageCache::excludePage(int page)
+{
+    m_excludedPages.insert(page);
+}
+
+bool PageImageCache::isActive(int page) const
+{
+    return !m_allPagesExcluded && !m_documentHash.isEmpty() && !m_excludedPages.contains(page);
+}
+
+bool PageImageCache::contains(const QString &entry) const
+{
+    return m_entries.contains(entry);
+}
+
+QString PageImageCache::entryName(int page, int width, int height, Rotation rotation, const NormalizedRect &tileRect)
+{
+    QString name = QStringLiteral("%1-%2x%3-%4").arg(page).arg(width).arg(height).arg(int(rotation));
+    if (!tileRect.isNull()) {
+        name += QStringLiteral("-%1_%2_%3_%4").arg(qRound(tileRect.left * 1e6)).arg(qRound(tileRect.top * 1e6)).arg(qRound(tileRect.right * 1e6)).arg(qRound(tileRect.bottom * 1e6));
+    }
+    return name;
+}
+
+void PageImageCache::load(PixmapRequest *request, const QString &entry, bool calcBoundingBox)
+{
+    PageImageLoadJob *job = new PageImageLoadJob(request, entry, entryPath(entry), calcBoundingBox);
+    connect(job, &PageImageLoadJob::done, this, &PageImageCache::imageLoaded);
+    m_weaver.enqueue(ThreadWeaver::JobPointer(job));
+}
+
+QImage PageImageCache::read(const QString &entry, bool calcBoundingBox, NormalizedRect *boundingBox)
+{
+    const QImage image = readEntryFile(entryPath(entry), calcBoundingBox, boundingBox);
+    if (image.isNull()) {
+        m_entries.remove(entry);
+    }
+    return image;
+}
+
+void PageImageCache::store(int page, const QString &entry, const QImage &image)
+{
+    if (!isActive(page) || m_entries.contains(entry) || image.isNull()) {
+        return;
+    }
+
+    m_entries.insert(entry);
+    const QString directory = m_directory;
+    const QString filePath = entryPath(entry);
+    m_weaver.enqueue(ThreadWeaver::make_job([directory, filePath, image] {
+        QDir().mkpath(directory);
+        // QSaveFile so that a load never sees a half written image
+        QSaveFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly) || !image.save(&file, "png", 80) || !file.commit()) {
+            qCDebug(OkularCoreDebug) << "Could not write the page image cache entry" << filePath;
+        }
+    }));
+
+    // Only approximate, the image is compressed when written
+    m_storedSinceEviction += image.sizeInBytes() / 4;
+    if (m_storedSinceEviction > m_maximumSize / 10) {
+        enqueueEviction();
+    }
+}
+
+void PageImageCache::imageLoaded(const ThreadWeaver::JobPointer &j)
+{
+    const PageImageLoadJob *job = static_cast<const PageImageLoadJob *>(j.data());
+    // gone, e.g. evicted by another instance, so the next render of it is stored again
+    if (job->image().isNull() && job->filePath() == entryPath(job->entry())) {
+        m_entries.remove(job->entry());
+    }
+    Q_EMIT loaded(job->request(), job->image(), job->boundingBox(), job->calcBoundingBox());
+}
+
+QString PageImageCache::entryPath(const QString &entry) const
+{
+    return m_directory + QLatin1Char('/') + entry + QStringLiteral(".png");
+}
+
+void PageImageCache::openDirectory(const QString &renderSettings)
+{
+    const QByteArray settingsHash = QCryptographicHash::hash(renderSettings.toUtf8(), QCryptographicHash::Sha1).toHex().left(16);
+    m_directory = m_documentDirectory + QLatin1Char('/') + m_documentHash + QLatin1Char('/') + QString::fromLatin1(settingsHash);
+
+    m_entries.clear();
+    const QStringList files = QDir(m_directory).entryList({QStringLiteral("*.png")}, QDir::Files);
+    for (const QString &file : files) {
+        m_entries.insert(file.chopped(4));
+    }
+}
+
+void PageImageCache::enqueueEviction()
+{
+    if (m_maximumSize <= 0) {
+        return;
+    }
+
+    m_storedSinceEviction = 0;
+    const QString directory = cacheDirectory();
+    const qint64 maximumSize = m_maximumSize;
+    m_weaver.enqueue(ThreadWeaver::make_job([this, directory, maximumSize] {
+        const QStringList removed = evictLeastRecentlyUsed(directory, maximumSize);
+        if (!removed.isEmpty()) {
+            QMetaObject::invokeMethod(this, [this, removed] { entriesEvicted(removed); }, Qt::QueuedConnection);
+        }
+    }));
+}
+
+void PageImageCache::entriesEvicted(const QStringList &filePaths)
+{
+    if (m_directory.isEmpty()) {
+        return;
+    }
+
+    const QString prefix = m_directory + QLatin1Char('/');
+    for (const QString &filePath : filePaths) {
+        if (filePath.startsWith(prefix)) {
+            m_entries.remove(filePath.sliced(prefix.size()).chopped(4));
+        }
+    }
+}
+
+#include "moc_pageimagecache_p.cpp"
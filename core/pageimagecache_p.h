@@ -0,0 +1,157 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef _OKULAR_PAGEIMAGECACHE_P_H_
+#define _OKULAR_PAGEIMAGECACHE_P_H_
+
+#include "okularcore_export.h"
+
+#include <QImage>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <threadweaver/job.h>
+#include <threadweaver/qobjectdecorator.h>
+#include <threadweaver/queue.h>
+
+#include "core/area.h"
+#include "core/global.h"
+
+namespace Okular
+{
+class PixmapRequest;
+
+class PageImageLoadJobInternal : public ThreadWeaver::Job
+{
+    friend class PageImageLoadJob;
+
+public:
+    QImage image() const;
+    NormalizedRect boundingBox() const;
+
+    PageImageLoadJobInternal(const PageImageLoadJobInternal &) = delete;
+    PageImageLoadJobInternal &operator=(const PageImageLoadJobInternal &) = delete;
+
+protected:
+    void run(ThreadWeaver::JobPointer self, ThreadWeaver::Thread *thread) override;
+
+private:
+    PageImageLoadJobInternal(const QString &filePath, bool calcBoundingBox);
+
+    const QString mFilePath;
+    const bool mCalcBoundingBox;
+    QImage mImage;
+    NormalizedRect mBoundingBox;
+};
+
+class PageImageLoadJob : public ThreadWeaver::QObjectDecorator
+{
+    Q_OBJECT
+public:
+    PageImageLoadJob(PixmapRequest *request, const QString &entry, const QString &filePath, bool calcBoundingBox);
+
+    PixmapRequest *request() const;
+    QString entry() const;
+    QString filePath() const;
+    bool calcBoundingBox() const;
+
+    QImage image() const
+    {
+        return static_cast<const PageImageLoadJobInternal *>(job())->image();
+    }
+    NormalizedRect boundingBox() const
+    {
+        return static_cast<const PageImageLoadJobInternal *>(job())->boundingBox();
+    }
+
+private:
+    PixmapRequest *mRequest;
+    QString mEntry;
+    QString mFilePath;
+    bool mCalcBoundingBox;
+};
+
+/* Persistent cache of the images rendered by the generator, stored in the
+ * docdata directory next to the docdata file of the document so reopening
+ * it doesn't need to render the same pages again.
+ *
+ * Entries are grouped by the hash of the document file contents and by the
+ * render settings of the generator, and named after the page, size, rotation
+ * and tile they were rendered for. Pages that differ in memory from the file
+ * (e.g. edited forms or annotations) are excluded. The caches of all the
+ * documents are kept under a size limit together by evicting the least
+ * recently used entries.
+ *
+ * Disk access happens in a ThreadWeaver queue, loads are reported back with
+ * the loaded() signal.
+ */
+class OKULARCORE_EXPORT PageImageCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    PageImageCache();
+    ~PageImageCache() override;
+
+    /* The directory the caches of the documents are in, the docdata directory */
+    static QString cacheDirectory();
+
+    /* Uses the cache in directory for a new document, rendered with the given
+     * generator settings. An empty renderSettings disables it. The cache isn't
+     * used before setDocumentHash() gives the hash of the document file. */
+    void setDocument(const QString &directory, const QString &renderSettings);
+
+    /* The hash of the file of the document given to setDocument(), see DocumentHash */
+    void setDocumentHash(const QByteArray &documentHash);
+
+    /* The generator render settings changed, drops the entries of the
+     * document rendered with the old ones */
+    void setRenderSettings(const QString &renderSettings);
+
+    void setMaximumSize(qint64 bytes);
+
+    void excludePage(int page);
+
+    bool isActive(int page) const;
+    bool contains(const QString &entry) const;
+
+    static QString entryName(int page, int width, int height, Rotation rotation, const NormalizedRect &tileRect);
+
+    void load(PixmapRequest *request, const QString &entry, bool calcBoundingBox);
+    /* Like load(), but on the calling thread for the requests that have to be done right away */
+    QImage read(const QString &entry, bool calcBoundingBox, NormalizedRect *boundingBox);
+    void store(int page, const QString &entry, const QImage &image);
+
+Q_SIGNALS:
+    /* image is null if the entry could not be read */
+    void loaded(Okular::PixmapRequest *request, const QImage &image, const Okular::NormalizedRect &boundingBox, bool calcBoundingBox);
+
+private Q_SLOTS:
+    void imageLoaded(const ThreadWeaver::JobPointer &job);
+
+private:
+    QString entryPath(const QString &entry) const;
+    void openDirectory(const QString &renderSettings);
+    void enqueueEviction();
+    void entriesEvicted(const QStringList &filePaths);
+
+    ThreadWeaver::Queue m_weaver;
+    QString m_documentHash;
+    QString m_renderSettings;
+    QString m_documentDirectory;
+    QString m_directory;
+    QSet<QString> m_entries;
+    QSet<int> m_excludedPages;
+    bool m_allPagesExcluded;
+    qint64 m_maximumSize;
+    qint64 m_storedSinceEviction;
+};
+
+}
+
+#endif
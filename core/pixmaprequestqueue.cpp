@@ -0,0 +1,177 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "pixmaprequestqueue_p.h"
+
+#include "generator.h"
+
+using namespace Okular;
+
+PixmapRequestQueue::PixmapRequestQueue()
+    : m_sequence(0)
+{
+    m_clock.start();
+}
+
+PixmapRequestQueue::~PixmapRequestQueue()
+{
+    clear();
+}
+
+void PixmapRequestQueue::push(PixmapRequest *request)
+{
+    Q_ASSERT(!m_entries.contains(request));
+
+    ++m_sequence;
+    // priority zero requests go ahead of the ones already queued, the others after them
+    const Key key(request->priority(), request->priority() == 0 ? -m_sequence : m_sequence);
+    m_byPriority.emplace(key, request);
+    m_entries.emplace(request, Entry {key, m_clock.elapsed()});
+    m_byObserver[request->observer()].emplace(request->pageNumber(), request);
+
+    m_statistics.peakCount = qMax(m_statistics.peakCount, count());
+}
+
+PixmapRequest *PixmapRequestQueue::top() const
+{
+    return m_byPriority.empty() ? nullptr : m_byPriority.begin()->second;
+}
+
+PixmapRequest *PixmapRequestQueue::next(PixmapRequest *request) const
+{
+    const auto entryIt = m_entries.find(request);
+    if (entryIt == m_entries.end()) {
+        return nullptr;
+    }
+
+    const auto it = m_byPriority.upper_bound(entryIt->second.key);
+    return it == m_byPriority.end() ? nullptr : it->second;
+}
+
+qint64 PixmapRequestQueue::take(PixmapRequest *request)
+{
+    const auto entryIt = m_entries.find(request);
+    if (entryIt == m_entries.end()) {
+        return 0;
+    }
+
+    const qint64 wait = m_clock.elapsed() - entryIt->second.enqueuedAt;
+    unlink(request);
+
+    ++m_statistics.takenCount;
+    m_statistics.totalWait += wait;
+    m_statistics.maxWait = qMax(m_statistics.maxWait, wait);
+
+    return wait;
+}
+
+void PixmapRequestQueue::discard(PixmapRequest *request)
+{
+    unlink(request);
+    delete request;
+    ++m_statistics.discardedCount;
+}
+
+void PixmapRequestQueue::discardRequests(const DocumentObserver *observer)
+{
+    const auto observerIt = m_byObserver.find(observer);
+    if (observerIt == m_byObserver.end()) {
+        return;
+    }
+
+    for (const auto &[page, request] : observerIt->second) {
+        m_byPriority.erase(m_entries.at(request).key);
+        m_entries.erase(request);
+        delete request;
+    }
+    m_statistics.discardedCount += observerIt->second.size();
+    m_byObserver.erase(observerIt);
+}
+
+void PixmapRequestQueue::discardRequests(const DocumentObserver *observer, const QSet<int> &pages)
+{
+    const auto observerIt = m_byObserver.find(observer);
+    if (observerIt == m_byObserver.end()) {
+        return;
+    }
+
+    ObserverPageMap &requests = observerIt->second;
+    for (const int page : pages) {
+        const auto [begin, end] = requests.equal_range(page);
+        for (auto it = begin; it != end; ++it) {
+            m_byPriority.erase(m_entries.at(it->second).key);
+            m_entries.erase(it->second);
+            delete it->second;
+            ++m_statistics.discardedCount;
+        }
+        requests.erase(begin, end);
+    }
+
+    if (requests.empty()) {
+        m_byObserver.erase(observerIt);
+    }
+}
+
+bool PixmapRequestQueue::hasRequests(const DocumentObserver *observer, int page) const
+{
+    const auto observerIt = m_byObserver.find(observer);
+    return observerIt != m_byObserver.end() && observerIt->second.contains(page);
+}
+
+void PixmapRequestQueue::clear()
+{
+    for (const auto &[key, request] : m_byPriority) {
+        delete request;
+    }
+    m_byPriority.clear();
+    m_entries.clear();
+    m_byObserver.clear();
+}
+
+bool PixmapRequestQueue::isEmpty() const
+{
+    return m_byPriority.empty();
+}
+
+int PixmapRequestQueue::count() const
+{
+    return static_cast<int>(m_byPriority.size());
+}
+
+const PixmapRequestQueue::Statistics &PixmapRequestQueue::statistics() const
+{
+    return m_statistics;
+}
+
+void PixmapRequestQueue::resetStatistics()
+{
+    m_statistics = Statistics();
+}
+
+void PixmapRequestQueue::unlink(PixmapRequest *request)
+{
+    const auto entryIt = m_entries.find(request);
+    if (entryIt == m_entries.end()) {
+        return;
+    }
+
+    m_byPriority.erase(entryIt->second.key);
+    m_entries.erase(entryIt);
+
+    const auto observerIt = m_byObserver.find(request->observer());
+    if (observerIt != m_byObserver.end()) {
+        const auto [begin, end] = observerIt->second.equal_range(request->pageNumber());
+        for (auto it = begin; it != end; ++it) {
+            if (it->second == request) {
+                observerIt->second.erase(it);
+                break;
+            }
+        }
+        if (observerIt->second.empty()) {
+            m_byObserver.erase(observerIt);
+        }
+    }
+}
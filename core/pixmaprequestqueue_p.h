@@ -0,0 +1,128 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef _OKULAR_PIXMAPREQUESTQUEUE_P_H_
+#define _OKULAR_PIXMAPREQUESTQUEUE_P_H_
+
+#include "okularcore_export.h"
+
+#include <QElapsedTimer>
+#include <QSet>
+
+#include <map>
+#include <unordered_map>
+#include <utility>
+
+namespace Okular
+{
+class DocumentObserver;
+class PixmapRequest;
+
+/**
+ * The pixmap requests waiting to be sent to the generator.
+ *
+ * Requests are ordered by priority (lowest number first). Among requests of
+ * the same priority the oldest one comes first, except for priority zero
+ * requests (the synchronous and visible ones) where the newest one does.
+ *
+ * Requests are also bucketed by observer and page, so replacing the requests
+ * of an observer doesn't need to look at the ones of the others.
+ *
+ * The queue owns the requests it holds. It is not thread safe, callers
+ * serialize the access (see DocumentPrivate::m_pixmapRequestsMutex).
+ */
+class OKULARCORE_EXPORT PixmapRequestQueue
+{
+public:
+    /**
+     * Counters to diagnose how the queue behaves, wait times are in milliseconds.
+     */
+    struct Statistics {
+        int peakCount = 0;
+        qulonglong takenCount = 0;
+        qulonglong discardedCount = 0;
+        qint64 totalWait = 0;
+        qint64 maxWait = 0;
+    };
+
+    PixmapRequestQueue();
+    ~PixmapRequestQueue();
+
+    PixmapRequestQueue(const PixmapRequestQueue &) = delete;
+    PixmapRequestQueue &operator=(const PixmapRequestQueue &) = delete;
+
+    void push(PixmapRequest *request);
+
+    /**
+     * Returns the request with the highest priority, or nullptr if the queue is empty.
+     */
+    PixmapRequest *top() const;
+
+    /**
+     * Returns the request that comes after @p request, or nullptr if it is the last one
+     * or isn't in the queue.
+     */
+    PixmapRequest *next(PixmapRequest *request) const;
+
+    /**
+     * Removes @p request from the queue because it is being sent to the generator,
+     * returns for how long it has been waiting in milliseconds.
+     */
+    qint64 take(PixmapRequest *request);
+
+    /**
+     * Removes and deletes @p request, which won't be sent to the generator.
+     */
+    void discard(PixmapRequest *request);
+
+    /**
+     * Deletes all the requests of @p observer.
+     */
+    void discardRequests(const DocumentObserver *observer);
+
+    /**
+     * Deletes the requests of @p observer for any of @p pages.
+     */
+    void discardRequests(const DocumentObserver *observer, const QSet<int> &pages);
+
+    /**
+     * Returns whether @p observer has requests queued for @p page.
+     */
+    bool hasRequests(const DocumentObserver *observer, int page) const;
+
+    /**
+     * Deletes all the requests.
+     */
+    void clear();
+
+    bool isEmpty() const;
+    int count() const;
+
+    const Statistics &statistics() const;
+    void resetStatistics();
+
+private:
+    // (priority, sequence), see the class documentation for the order of the sequence
+    typedef std::pair<int, qint64> Key;
+    struct Entry {
+        Key key;
+        qint64 enqueuedAt;
+    };
+    typedef std::multimap<int, PixmapRequest *> ObserverPageMap;
+
+    void unlink(PixmapRequest *request);
+
+    std::map<Key, PixmapRequest *> m_byPriority;
+    std::unordered_map<PixmapRequest *, Entry> m_entries;
+    std::unordered_map<const DocumentObserver *, ObserverPageMap> m_byObserver;
+    qint64 m_sequence;
+    QElapsedTimer m_clock;
+    Statistics m_statistics;
+};
+
+}
+
+#endif
@@ -0,0 +1,54 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "pixmapscalejob_p.h"
+
+using namespace Okular;
+
+PixmapScaleJob::PixmapScaleJob(PixmapRequest *request, const QImage &image, int width, int height, Rotation rotation)
+    : ThreadWeaver::QObjectDecorator(new PixmapScaleJobInternal(image, width, height))
+    , mRequest(request)
+    , mRotation(rotation)
+{
+}
+
+PixmapRequest *PixmapScaleJob::request() const
+{
+    return mRequest;
+}
+
+Rotation PixmapScaleJob::rotation() const
+{
+    return mRotation;
+}
+
+QImage PixmapScaleJob::scaled(const QImage &image, int width, int height)
+{
+    // Smooth scaling averages the source pixels when going down, using the SIMD code paths of Qt
+    return image.scaled(width, height, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+}
+
+PixmapScaleJobInternal::PixmapScaleJobInternal(const QImage &image, int width, int height)
+    : mImage(image)
+    , mWidth(width)
+    , mHeight(height)
+{
+}
+
+QImage PixmapScaleJobInternal::image() const
+{
+    return mScaledImage;
+}
+
+void PixmapScaleJobInternal::run(ThreadWeaver::JobPointer self, ThreadWeaver::Thread *thread)
+{
+    Q_UNUSED(self);
+    Q_UNUSED(thread);
+
+    mScaledImage = PixmapScaleJob::scaled(mImage, mWidth, mHeight);
+}
+
+#include "moc_pixmapscalejob_p.cpp"
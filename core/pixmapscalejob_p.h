@@ -0,0 +1,74 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef _OKULAR_PIXMAPSCALEJOB_P_H_
+#define _OKULAR_PIXMAPSCALEJOB_P_H_
+
+#include <QImage>
+
+#include <threadweaver/job.h>
+#include <threadweaver/qobjectdecorator.h>
+
+#include "core/global.h"
+
+namespace Okular
+{
+class PixmapRequest;
+
+class PixmapScaleJobInternal : public ThreadWeaver::Job
+{
+    friend class PixmapScaleJob;
+
+public:
+    QImage image() const;
+
+    PixmapScaleJobInternal(const PixmapScaleJobInternal &) = delete;
+    PixmapScaleJobInternal &operator=(const PixmapScaleJobInternal &) = delete;
+
+protected:
+    void run(ThreadWeaver::JobPointer self, ThreadWeaver::Thread *thread) override;
+
+private:
+    PixmapScaleJobInternal(const QImage &image, int width, int height);
+
+    const QImage mImage;
+    const int mWidth;
+    const int mHeight;
+    QImage mScaledImage;
+};
+
+/* Scales down the pixmap another observer has of a page to the size of a
+ * request, so the generator doesn't have to render the page again.
+ *
+ * The pixmap is in the rotation of the page and so is the resulting image,
+ * width x height is the rotated size of the request. Pixmaps can only be
+ * used in the GUI thread, like the other jobs this one is given the pixmap
+ * converted to an image and only does the scaling in its thread. */
+class PixmapScaleJob : public ThreadWeaver::QObjectDecorator
+{
+    Q_OBJECT
+public:
+    PixmapScaleJob(PixmapRequest *request, const QImage &image, int width, int height, Rotation rotation);
+
+    PixmapRequest *request() const;
+    Rotation rotation() const;
+
+    QImage image() const
+    {
+        return static_cast<const PixmapScaleJobInternal *>(job())->image();
+    }
+
+    /* What the job does, for the requests that have to be done right away */
+    static QImage scaled(const QImage &image, int width, int height);
+
+private:
+    PixmapRequest *mRequest;
+    Rotation mRotation;
+};
+
+}
+
+#endif
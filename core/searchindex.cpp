@@ -0,0 +1,379 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "searchindex_p.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+#include <QThread>
+
+#include <threadweaver/queueing.h>
+
+#include "debug_p.h"
+#include "generator_p.h"
+#include "page_p.h"
+#include "textpage.h"
+#include "textpage_p.h"
+
+using namespace Okular;
+
+static const quint32 searchIndexMagic = 0x4F4B5349; // "OKSI"
+static const quint32 searchIndexVersion = 1;
+
+static bool isTermCharacter(QChar c)
+{
+    // the surrogates are kept, the letters outside of the BMP are part of words too
+    return c.isLetterOrNumber() || c.isMark() || c.isSurrogate();
+}
+
+static void addTerms(QStringView text, QSet<QString> &terms)
+{
+    qsizetype start = -1;
+    for (qsizetype i = 0; i <= text.size(); ++i) {
+        const bool termCharacter = i < text.size() && isTermCharacter(text[i]);
+        if (termCharacter && start == -1) {
+            start = i;
+        } else if (!termCharacter && start != -1) {
+            terms.insert(text.sliced(start, i - start).toString());
+            start = -1;
+        }
+    }
+}
+
+static void appendVarint(QByteArray &bytes, quint32 value)
+{
+    while (value >= 0x80) {
+        bytes.append(char((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    bytes.append(char(value));
+}
+
+static void setPageBits(const QByteArray &pages, QBitArray &bits)
+{
+    qint64 page = -1;
+    quint32 delta = 0;
+    int shift = 0;
+    for (const char c : pages) {
+        delta |= quint32(uchar(c) & 0x7f) << shift;
+        if (uchar(c) & 0x80) {
+            shift += 7;
+            continue;
+        }
+        page += delta;
+        if (page >= bits.size()) {
+            return;
+        }
+        bits.setBit(page);
+        delta = 0;
+        shift = 0;
+    }
+}
+
+SearchIndexPageJob::SearchIndexPageJob(Generator *generator, Page *page)
+    : ThreadWeaver::QObjectDecorator(new SearchIndexPageJobInternal(generator, page))
+{
+}
+
+void SearchIndexPageJob::abort()
+{
+    static_cast<SearchIndexPageJobInternal *>(job())->abort();
+}
+
+SearchIndexPageJobInternal::SearchIndexPageJobInternal(Generator *generator, Page *page)
+    : mGenerator(generator)
+    , mPage(page)
+    , mRequest(page)
+{
+}
+
+QSet<QString> SearchIndexPageJobInternal::terms() const
+{
+    return mTerms;
+}
+
+void SearchIndexPageJobInternal::abort()
+{
+    TextRequestPrivate::get(&mRequest)->mShouldAbortExtraction = 1;
+}
+
+void SearchIndexPageJobInternal::run(ThreadWeaver::JobPointer self, ThreadWeaver::Thread *thread)
+{
+    Q_UNUSED(self);
+    Q_UNUSED(thread);
+
+    // the indexing must not slow down the rendering and the searches
+    QThread::currentThread()->setPriority(QThread::LowestPriority);
+
+    if (mRequest.shouldAbortExtraction()) {
+        return;
+    }
+
+    TextPage *textPage = mGenerator->textPage(&mRequest);
+    if (textPage && !mRequest.shouldAbortExtraction()) {
+        PagePrivate::get(mPage)->prepareTextPage(textPage);
+        mTerms = SearchIndex::pageTerms(textPage);
+    }
+    delete textPage;
+}
+
+SearchIndex::SearchIndex(Generator *generator, const QList<Page *> &pages, const QString &indexFilePath)
+    : QObject()
+    , m_generator(generator)
+    , m_pages(pages)
+    , m_indexFilePath(indexFilePath)
+    , m_modified(false)
+{
+    // One thread, the pages are indexed one after the other and the index is written after them
+    m_weaver.setMaximumNumberOfThreads(1);
+}
+
+SearchIndex::~SearchIndex()
+{
+    if (m_pageJob) {
+        static_cast<SearchIndexPageJob *>(m_pageJob.data())->abort();
+    }
+    m_weaver.finish();
+
+    // what was indexed is kept for the next time the document is opened
+    if (m_modified) {
+        save(true);
+    }
+}
+
+void SearchIndex::setDocumentHash(const QByteArray &documentHash)
+{
+    if (documentHash.isEmpty() || !m_documentHash.isEmpty()) {
+        return;
+    }
+
+    const QString indexFilePath = m_indexFilePath;
+    const int pageCount = m_pages.count();
+    m_weaver.enqueue(ThreadWeaver::make_job([this, documentHash, indexFilePath, pageCount] {
+        const Data data = readIndex(indexFilePath, documentHash, pageCount);
+        QMetaObject::invokeMethod(this, [this, documentHash, data] { indexLoaded(documentHash, data); }, Qt::QueuedConnection);
+    }));
+}
+
+QList<int> SearchIndex::candidatePages(const QStringList &texts, bool all) const
+{
+    return candidatePages(m_data, m_pages.count(), texts, all);
+}
+
+QList<int> SearchIndex::candidatePages(const Data &data, int pageCount, const QStringList &texts, bool all)
+{
+    QBitArray pages;
+    for (const QString &text : texts) {
+        const QBitArray textPages = SearchIndex::textPages(data, pageCount, text);
+        if (pages.isEmpty()) {
+            pages = textPages;
+        } else if (all) {
+            pages &= textPages;
+        } else {
+            pages |= textPages;
+        }
+    }
+
+    QList<int> candidates;
+    for (int i = 0; i < pages.size(); ++i) {
+        if (pages.testBit(i)) {
+            candidates.append(i);
+        }
+    }
+    return candidates;
+}
+
+QSet<QString> SearchIndex::terms(QStringView text)
+{
+    QSet<QString> terms;
+    addTerms(TextPagePrivate::caseFolded(text.toString().normalized(QString::NormalizationForm_KC)), terms);
+    return terms;
+}
+
+QSet<QString> SearchIndex::pageTerms(TextPage *textPage)
+{
+    TextPagePrivate *d = TextPagePrivate::get(textPage);
+    const QStringView text = d->searchText(Qt::CaseInsensitive);
+
+    QSet<QString> terms;
+    addTerms(text, terms);
+
+    // The searches match the words split by a hyphen at the end of a line as one, index them that way too
+    const qsizetype wordCount = d->m_searchWordAdjustedEnds.count();
+    bool hasHyphens = false;
+    for (qsizetype i = 0; i < wordCount && !hasHyphens; ++i) {
+        hasHyphens = d->m_searchWordAdjustedEnds.at(i) < d->m_searchWordStarts.at(i + 1);
+    }
+    if (hasHyphens) {
+        QString joinedText;
+        bool afterHyphen = false;
+        for (qsizetype i = 0; i < wordCount; ++i) {
+            const qsizetype start = d->m_searchWordStarts.at(i);
+            const qsizetype adjustedEnd = d->m_searchWordAdjustedEnds.at(i);
+            const QStringView word = text.sliced(start, adjustedEnd - start);
+            // the line break after the hyphen is left out too, a term too many only makes a page more to search
+            if (afterHyphen && word.trimmed().isEmpty()) {
+                continue;
+            }
+            joinedText += word;
+            afterHyphen = adjustedEnd < d->m_searchWordStarts.at(i + 1);
+        }
+        addTerms(joinedText, terms);
+    }
+
+    return terms;
+}
+
+void SearchIndex::addPage(Data &data, const QSet<QString> &pageTerms)
+{
+    const int page = data.indexedPages;
+    for (const QString &term : pageTerms) {
+        Term &t = data.terms[term];
+        appendVarint(t.pages, page - t.lastPage);
+        t.lastPage = page;
+    }
+    ++data.indexedPages;
+}
+
+SearchIndex::Data SearchIndex::readIndex(const QString &indexFilePath, const QByteArray &documentHash, int pageCount)
+{
+    Data data;
+    QFile file(indexFilePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return data;
+    }
+
+    QDataStream stream(&file);
+    quint32 magic, version, termCount;
+    QByteArray hash;
+    qint32 savedPageCount, indexedPages;
+    stream >> magic >> version >> hash >> savedPageCount >> indexedPages >> termCount;
+
+    // the index of another version of the document is of no use
+    if (stream.status() != QDataStream::Ok || magic != searchIndexMagic || version != searchIndexVersion || hash != documentHash || savedPageCount != pageCount || indexedPages < 0 || indexedPages > pageCount) {
+        return data;
+    }
+
+    for (quint32 i = 0; i < termCount && stream.status() == QDataStream::Ok; ++i) {
+        QByteArray term;
+        qint32 lastPage;
+        Term t;
+        stream >> term >> lastPage >> t.pages;
+        t.lastPage = lastPage;
+        data.terms.insert(QString::fromUtf8(term), t);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        qCDebug(OkularCoreDebug) << "Could not read the search index" << indexFilePath;
+        return Data();
+    }
+
+    data.indexedPages = indexedPages;
+    return data;
+}
+
+QByteArray SearchIndex::encodedIndex(const Data &data, const QByteArray &documentHash, int pageCount)
+{
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream << searchIndexMagic << searchIndexVersion << documentHash << qint32(pageCount) << qint32(data.indexedPages) << quint32(data.terms.count());
+    for (auto it = data.terms.cbegin(); it != data.terms.cend(); ++it) {
+        stream << it.key().toUtf8() << qint32(it->lastPage) << it->pages;
+    }
+    return bytes;
+}
+
+void SearchIndex::indexLoaded(const QByteArray &documentHash, const Data &data)
+{
+    m_documentHash = documentHash;
+    m_data = data;
+    indexNextPage();
+}
+
+void SearchIndex::indexNextPage()
+{
+    if (m_data.indexedPages >= m_pages.count()) {
+        if (m_modified) {
+            save(false);
+        }
+        return;
+    }
+
+    SearchIndexPageJob *job = new SearchIndexPageJob(m_generator, m_pages.at(m_data.indexedPages));
+    connect(job, &SearchIndexPageJob::done, this, &SearchIndex::pageIndexed);
+    m_pageJob = ThreadWeaver::JobPointer(job);
+    m_weaver.enqueue(m_pageJob);
+}
+
+void SearchIndex::pageIndexed(const ThreadWeaver::JobPointer &job)
+{
+    if (job != m_pageJob) {
+        return;
+    }
+    m_pageJob.clear();
+
+    addPage(m_data, static_cast<const SearchIndexPageJob *>(job.data())->terms());
+    m_modified = true;
+
+    indexNextPage();
+}
+
+void SearchIndex::save(bool wait)
+{
+    if (m_documentHash.isEmpty() || m_indexFilePath.isEmpty()) {
+        return;
+    }
+    m_modified = false;
+
+    const QByteArray bytes = encodedIndex(m_data, m_documentHash, m_pages.count());
+    const QString filePath = m_indexFilePath;
+    auto write = [filePath, bytes] {
+        QSaveFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly) || file.write(bytes) != bytes.size() || !file.commit()) {
+            qCWarning(OkularCoreDebug) << "Could not write the search index" << filePath;
+        }
+    };
+
+    if (wait) {
+        write();
+    } else {
+        m_weaver.enqueue(ThreadWeaver::make_job(write));
+    }
+}
+
+QBitArray SearchIndex::textPages(const Data &data, int pageCount, const QString &text)
+{
+    QBitArray pages(pageCount);
+    const QSet<QString> textTerms = terms(text);
+
+    // a text without words can match anywhere, and so can the pages not indexed yet
+    if (textTerms.isEmpty()) {
+        pages.fill(true);
+        return pages;
+    }
+
+    // A term of the text can be part of a word of the page, each of them is looked for in all the words
+    bool first = true;
+    for (const QString &textTerm : textTerms) {
+        QBitArray termPages(pageCount);
+        for (auto it = data.terms.cbegin(); it != data.terms.cend(); ++it) {
+            if (it.key().contains(textTerm)) {
+                setPageBits(it->pages, termPages);
+            }
+        }
+        termPages.fill(true, qMin(data.indexedPages, pageCount), pageCount);
+        if (first) {
+            pages = termPages;
+            first = false;
+        } else {
+            pages &= termPages;
+        }
+    }
+    return pages;
+}
+
+#include "moc_searchindex_p.cpp"
@@ -0,0 +1,153 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef _OKULAR_SEARCHINDEX_P_H_
+#define _OKULAR_SEARCHINDEX_P_H_
+
+#include "okularcore_export.h"
+
+#include <QBitArray>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <threadweaver/job.h>
+#include <threadweaver/qobjectdecorator.h>
+#include <threadweaver/queue.h>
+
+#include "core/generator.h"
+
+namespace Okular
+{
+class Page;
+class TextPage;
+
+class SearchIndexPageJobInternal : public ThreadWeaver::Job
+{
+    friend class SearchIndexPageJob;
+
+public:
+    QSet<QString> terms() const;
+
+    SearchIndexPageJobInternal(const SearchIndexPageJobInternal &) = delete;
+    SearchIndexPageJobInternal &operator=(const SearchIndexPageJobInternal &) = delete;
+
+protected:
+    void run(ThreadWeaver::JobPointer self, ThreadWeaver::Thread *thread) override;
+
+private:
+    SearchIndexPageJobInternal(Generator *generator, Page *page);
+
+    void abort();
+
+    Generator *const mGenerator;
+    Page *const mPage;
+    TextRequest mRequest;
+    QSet<QString> mTerms;
+};
+
+/* Extracts the text of a page and gives the terms to index of it */
+class SearchIndexPageJob : public ThreadWeaver::QObjectDecorator
+{
+    Q_OBJECT
+public:
+    SearchIndexPageJob(Generator *generator, Page *page);
+
+    void abort();
+
+    QSet<QString> terms() const
+    {
+        return static_cast<const SearchIndexPageJobInternal *>(job())->terms();
+    }
+};
+
+/**
+ * A persistent index of the words of the pages of a document, so the
+ * searches over the whole document only search the pages that can have
+ * a match.
+ *
+ * The terms of the pages are their words normalized to NFKC and case
+ * folded like the searches do. A page can have a match of a text if each
+ * term of the text is part of one of the terms of the page, the index only
+ * narrows the pages to search and the matches still come from searching
+ * the text pages.
+ *
+ * The pages are indexed one after the other in a low priority thread, and
+ * the index is saved to indexFilePath when all of them are, or when the
+ * index is deleted. A saved index is used again only for the same content
+ * of the document and the indexing goes on from where it stopped.
+ */
+class SearchIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Term {
+        QByteArray pages; // the page numbers, as varint encoded differences from the previous one
+        int lastPage = -1;
+    };
+
+    /* The terms of the first indexedPages pages */
+    struct Data {
+        QHash<QString, Term> terms;
+        int indexedPages = 0;
+    };
+
+    /* generator has to be able to extract the text of pages in parallel */
+    SearchIndex(Generator *generator, const QList<Page *> &pages, const QString &indexFilePath);
+    ~SearchIndex() override;
+
+    /* The hash of the document file, see DocumentHash. Nothing is indexed before it is given,
+     * an empty one keeps the index from being saved or loaded */
+    void setDocumentHash(const QByteArray &documentHash);
+
+    /* The pages that can have a match of all the texts (or any of them if all is false),
+     * in increasing order. The pages not indexed yet are always there. */
+    QList<int> candidatePages(const QStringList &texts, bool all) const;
+
+    /* The terms of text, see the class documentation */
+    OKULARCORE_EXPORT static QSet<QString> terms(QStringView text);
+
+    /* The terms of textPage, which has to be prepared for its page */
+    OKULARCORE_EXPORT static QSet<QString> pageTerms(TextPage *textPage);
+
+    /* Adds pageTerms as the terms of the page after the indexed ones of data */
+    OKULARCORE_EXPORT static void addPage(Data &data, const QSet<QString> &pageTerms);
+
+    /* candidatePages() for the index data of a document of pageCount pages */
+    OKULARCORE_EXPORT static QList<int> candidatePages(const Data &data, int pageCount, const QStringList &texts, bool all);
+
+    /* The index file contents, readIndex() gives an empty Data for an index of another document hash or page count */
+    OKULARCORE_EXPORT static QByteArray encodedIndex(const Data &data, const QByteArray &documentHash, int pageCount);
+    OKULARCORE_EXPORT static Data readIndex(const QString &indexFilePath, const QByteArray &documentHash, int pageCount);
+
+private Q_SLOTS:
+    void pageIndexed(const ThreadWeaver::JobPointer &job);
+
+private:
+    void indexLoaded(const QByteArray &documentHash, const Data &data);
+    void indexNextPage();
+    void save(bool wait);
+
+    static QBitArray textPages(const Data &data, int pageCount, const QString &text);
+
+    ThreadWeaver::Queue m_weaver;
+    ThreadWeaver::JobPointer m_pageJob;
+    Generator *m_generator;
+    QList<Page *> m_pages;
+    QString m_indexFilePath;
+    QByteArray m_documentHash;
+    Data m_data;
+    bool m_modified;
+};
+
+}
+
+#endif
@@ -11,13 +11,17 @@
 
 #include "area.h"
 #include "blockselection.h"
+#include "blockselection_p.h"
 #include "debug_p.h"
 #include "misc.h"
 #include "page.h"
 #include "page_p.h"
 #include <unordered_set>
 
+#include <algorithm>
 #include <cstring>
+#include <limits>
+#include <numeric>
 
 #include <QVarLengthArray>
 #include <QtAlgorithms>
@@ -59,10 +63,10 @@ public:
     }
 
     /** The TextEntity containing the first character of the match. */
-    TextEntity::List::ConstIterator it_begin;
+    TextEntityStore::ConstIterator it_begin;
 
     /** The TextEntity containing the last character of the match. */
-    TextEntity::List::ConstIterator it_end;
+    TextEntityStore::ConstIterator it_end;
 
     /** The index of the first character of the match in (*it_begin)->text().
      *  Satisfies 0 <= offset_begin < (*it_begin)->text().length().
@@ -75,22 +79,27 @@ public:
     int offset_end;
 };
 
-/* text comparison functions */
-
-static bool CaseInsensitiveCmpFn(QStringView from, QStringView to)
-{
-#ifdef DEBUG_TEXTPAGE
-    qDebug(OkularCoreDebug) << from << ":" << to << "(case insensitive)";
-#endif
-    return from.compare(to, Qt::CaseInsensitive) == 0;
-}
-
-static bool CaseSensitiveCmpFn(QStringView from, QStringView to)
+QString TextPagePrivate::caseFolded(QStringView text)
 {
-#ifdef DEBUG_TEXTPAGE
-    qDebug(OkularCoreDebug) << from << ":" << to << "(case sensitive)";
-#endif
-    return from.compare(to, Qt::CaseSensitive) == 0;
+    QString folded(text.size(), Qt::Uninitialized);
+    QChar *out = folded.data();
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        const QChar c = text[i];
+        if (c.isHighSurrogate() && i + 1 < text.size() && text[i + 1].isLowSurrogate()) {
+            const char32_t foldedCodePoint = QChar::toCaseFolded(QChar::surrogateToUcs4(c, text[i + 1]));
+            if (QChar::requiresSurrogates(foldedCodePoint)) {
+                out[i] = QChar(QChar::highSurrogate(foldedCodePoint));
+                out[i + 1] = QChar(QChar::lowSurrogate(foldedCodePoint));
+            } else {
+                out[i] = c;
+                out[i + 1] = text[i + 1];
+            }
+            ++i;
+        } else {
+            out[i] = c.toCaseFolded();
+        }
+    }
+    return folded;
 }
 
 /**
@@ -168,24 +177,38 @@ TextPagePrivate::~TextPagePrivate()
     qDeleteAll(m_searchPoints);
 }
 
+TextPagePrivate *TextPagePrivate::get(TextPage *textPage)
+{
+    return textPage ? textPage->d : nullptr;
+}
+
+qulonglong TextPagePrivate::memoryUsage() const
+{
+    qulonglong bytes = sizeof(TextPage) + sizeof(TextPagePrivate);
+    bytes += m_words.memoryUsage();
+    bytes += (m_searchText.capacity() + m_foldedSearchText.capacity()) * sizeof(QChar);
+    bytes += (m_searchWordStarts.capacity() + m_searchWordAdjustedEnds.capacity()) * sizeof(quint32);
+    // a QMap node is about three pointers and the key beside the value
+    bytes += m_searchPoints.count() * (sizeof(SearchPoint) + 4 * sizeof(void *));
+    bytes += m_layoutBlocks.capacity() * sizeof(LayoutBlock);
+    for (const LayoutBlock &block : m_layoutBlocks) {
+        bytes += (block.id.capacity() + block.blockType.capacity()) * sizeof(QChar);
+    }
+    bytes += m_layoutBlockIndex.memoryUsage();
+    return bytes;
+}
+
 const LayoutBlock *TextPagePrivate::findBlockContaining(const NormalizedPoint &p) const
 {
-    for (const auto &block : m_layoutBlocks) {
-        if (block.contains(p)) {
-            return &block;
-        }
-    }
-    return nullptr;
+    const qsizetype index = m_layoutBlockIndex.blockContaining(p.x, p.y);
+    return index >= 0 ? &m_layoutBlocks.at(index) : nullptr;
 }
 
 const LayoutBlock *TextPagePrivate::findBlockContaining(const NormalizedRect &r) const
 {
-    for (const auto &block : m_layoutBlocks) {
-        if (block.contains(r)) {
-            return &block;
-        }
-    }
-    return nullptr;
+    // the block containing the center, like LayoutBlock::contains()
+    const qsizetype index = m_layoutBlockIndex.blockContaining((r.left + r.right) / 2.0, (r.top + r.bottom) / 2.0);
+    return index >= 0 ? &m_layoutBlocks.at(index) : nullptr;
 }
 
 const LayoutBlock *TextPagePrivate::getNextBlock(const LayoutBlock *current) const
@@ -194,12 +217,8 @@ const LayoutBlock *TextPagePrivate::getNextBlock(const LayoutBlock *current) con
         return nullptr;
     }
 
-    for (const auto &block : m_layoutBlocks) {
-        if (block.readingOrder == current->readingOrder + 1) {
-            return &block;
-        }
-    }
-    return nullptr;
+    const qsizetype index = m_layoutBlockIndex.blockWithReadingOrder(current->readingOrder + 1);
+    return index >= 0 ? &m_layoutBlocks.at(index) : nullptr;
 }
 
 const LayoutBlock *TextPagePrivate::getPreviousBlock(const LayoutBlock *current) const
@@ -208,15 +227,77 @@ const LayoutBlock *TextPagePrivate::getPreviousBlock(const LayoutBlock *current)
         return nullptr;
     }
 
-    for (const auto &block : m_layoutBlocks) {
-        if (block.readingOrder == current->readingOrder - 1) {
-            return &block;
-        }
+    const qsizetype index = m_layoutBlockIndex.blockWithReadingOrder(current->readingOrder - 1);
+    return index >= 0 ? &m_layoutBlocks.at(index) : nullptr;
+}
+
+NormalizedRect TextEntityStore::Entry::transformedArea(const QTransform &matrix) const
+{
+    NormalizedRect transformed_area = area();
+    transformed_area.transform(matrix);
+    return transformed_area;
+}
+
+TextEntity TextEntityStore::Entry::toTextEntity() const
+{
+    return TextEntity(text().toString(), area());
+}
+
+void TextEntityStore::append(QStringView text, const NormalizedRect &area)
+{
+    m_text.append(text);
+    m_ends.append(m_text.size());
+    m_areas.append({float(area.left), float(area.top), float(area.right), float(area.bottom)});
+}
+
+void TextEntityStore::removeLast()
+{
+    m_ends.removeLast();
+    m_areas.removeLast();
+    m_text.truncate(m_ends.isEmpty() ? 0 : m_ends.constLast());
+}
+
+void TextEntityStore::assign(const TextEntity::List &words)
+{
+    qsizetype length = 0;
+    for (const TextEntity &word : words) {
+        length += word.text().size();
+    }
+
+    QString text;
+    text.reserve(length);
+    QList<quint32> ends;
+    ends.reserve(words.count());
+    QList<Area> areas;
+    areas.reserve(words.count());
+    for (const TextEntity &word : words) {
+        const NormalizedRect area = word.area();
+        text.append(word.text());
+        ends.append(text.size());
+        areas.append({float(area.left), float(area.top), float(area.right), float(area.bottom)});
+    }
+
+    m_text = std::move(text);
+    m_ends = std::move(ends);
+    m_areas = std::move(areas);
+}
+
+TextEntity::List TextEntityStore::toList() const
+{
+    TextEntity::List list;
+    list.reserve(count());
+    for (const Entry &entry : *this) {
+        list.append(entry.toTextEntity());
     }
-    return nullptr;
+    return list;
+}
+
+qulonglong TextEntityStore::memoryUsage() const
+{
+    return m_text.capacity() * sizeof(QChar) + m_ends.capacity() * sizeof(quint32) + m_areas.capacity() * sizeof(Area);
 }
 
-bool TextPagePrivate::isLastEntityInBlock(TextEntity::List::ConstIterator it, const LayoutBlock *block) const
+bool TextPagePrivate::isLastEntityInBlock(TextEntityStore::ConstIterator it, const LayoutBlock *block) const
 {
     if (!block || it == m_words.constEnd()) {
         return true;
@@ -230,7 +311,7 @@ bool TextPagePrivate::isLastEntityInBlock(TextEntity::List::ConstIterator it, co
     return !block->contains(next->area());
 }
 
-bool TextPagePrivate::shouldIncludeEntity(const TextEntity &entity, const LayoutBlock *block) const
+bool TextPagePrivate::shouldIncludeEntity(const TextEntityStore::Entry &entity, const LayoutBlock *block) const
 {
     if (!block) {
         return true;
@@ -245,6 +326,17 @@ bool TextPagePrivate::shouldIncludeEntity(const TextEntity &entity, const Layout
     return block->bbox.contains(cx, cy);
 }
 
+TextEntityStore::ConstIterator TextPagePrivate::findNearestEntityInBlock(const LayoutBlock *block, const NormalizedPoint &p) const
+{
+    return BlockSelection::findNearestEntityInBlock(m_words, block, p);
+}
+
+QString TextPagePrivate::extractTextInReadingOrder(const RegularAreaRect *area, bool useIntersects) const
+{
+    return BlockSelection::extractTextInReadingOrder(
+        m_words, [this](const NormalizedRect &entityArea) { return findBlockContaining(entityArea); }, area, useIntersects);
+}
+
 TextPage::TextPage()
     : d(new TextPagePrivate())
 {
@@ -253,7 +345,7 @@ TextPage::TextPage()
 TextPage::TextPage(const TextEntity::List &words)
     : d(new TextPagePrivate())
 {
-    d->m_words = words;
+    d->m_words.assign(words);
 }
 
 TextPage::~TextPage()
@@ -264,6 +356,7 @@ TextPage::~TextPage()
 void TextPage::setLayoutBlocks(const QList<LayoutBlock> &blocks)
 {
     d->m_layoutBlocks = blocks;
+    d->m_layoutBlockIndex = LayoutBlockIndex(blocks);
     // Reading order is now computed by the AI service and embedded in XMP data.
     // No need to recompute here - trust the XMP reading order.
     // d->computeReadingOrder();
@@ -282,20 +375,21 @@ QList<LayoutBlock> TextPage::layoutBlocks() const
 void TextPage::append(const QString &text, const NormalizedRect &area)
 {
     if (!text.isEmpty()) {
+        d->clearSearchText();
         if (!d->m_words.isEmpty()) {
-            const TextEntity &lastEntity = d->m_words.last();
+            const qsizetype last = d->m_words.count() - 1;
             // Unicode Normalization Form KC (NFKC) may alter characters, for example ⑥ to 6, so we use NFC
-            const QString concatText = lastEntity.text() + text.normalized(QString::NormalizationForm_C);
+            const QString concatText = d->m_words.text(last).toString() + text.normalized(QString::NormalizationForm_C);
             if (concatText != concatText.normalized(QString::NormalizationForm_C)) {
                 // If this happens it means that the new text + old one have combined, for example A and ◌̊  form Å
-                NormalizedRect newArea = area | lastEntity.area();
+                NormalizedRect newArea = area | d->m_words.area(last);
                 d->m_words.removeLast();
-                d->m_words.append(TextEntity(concatText.normalized(QString::NormalizationForm_C), newArea));
+                d->m_words.append(concatText.normalized(QString::NormalizationForm_C), newArea);
                 return;
             }
         }
 
-        d->m_words.append(TextEntity(text.normalized(QString::NormalizationForm_C), area));
+        d->m_words.append(text.normalized(QString::NormalizationForm_C), area);
     }
 }
 
@@ -505,8 +599,8 @@ std::unique_ptr<RegularAreaRect> TextPage::textArea(const TextSelection &sel, bo
     clampBlockPoint(blockStartC);
     clampBlockPoint(blockEndC);
 
-    TextEntity::List::ConstIterator it = d->m_words.constBegin(), itEnd = d->m_words.constEnd();
-    TextEntity::List::ConstIterator start = it, end = itEnd, tmpIt = it; //, tmpItEnd = itEnd;
+    TextEntityStore::ConstIterator it = d->m_words.constBegin(), itEnd = d->m_words.constEnd();
+    TextEntityStore::ConstIterator start = it, end = itEnd, tmpIt = it; //, tmpItEnd = itEnd;
     const MergeSide side = d->m_page ? (MergeSide)d->m_page->totalOrientation() : MergeRight;
 
     NormalizedRect tmp;
@@ -674,9 +768,9 @@ std::unique_ptr<RegularAreaRect> TextPage::textArea(const TextSelection &sel, bo
         NormalizedPoint endPoint(blockEndC.x, blockEndC.y);
 
         // Find block containing start cursor
-        const LayoutBlock *startBlock = BlockSelectionHelper::findBlockContaining(d->m_layoutBlocks, startPoint);
+        const LayoutBlock *startBlock = d->findBlockContaining(startPoint);
         // Find block containing end cursor
-        const LayoutBlock *endBlock = BlockSelectionHelper::findBlockContaining(d->m_layoutBlocks, endPoint);
+        const LayoutBlock *endBlock = d->findBlockContaining(endPoint);
 
         // If cursor is not in any block, find the nearest appropriate block
         if (!startBlock) {
@@ -703,42 +797,46 @@ std::unique_ptr<RegularAreaRect> TextPage::textArea(const TextSelection &sel, bo
             return ret;
         }
 
-        // Collect all blocks in the reading order range
-        QList<const LayoutBlock *> activeBlocks = BlockSelectionHelper::getBlocksInReadingOrderRange(d->m_layoutBlocks, minOrder, maxOrder);
+        // The blocks in the reading order range are the active ones, the first active block
+        // containing the center of an entity is the one it belongs to
+        const auto activeBlockOf = [d = d, minOrder, maxOrder](const NormalizedRect &area) -> const LayoutBlock * {
+            const qsizetype index = d->m_layoutBlockIndex.blockContaining((area.left + area.right) / 2.0, (area.top + area.bottom) / 2.0, minOrder, maxOrder);
+            return index >= 0 ? &d->m_layoutBlocks.at(index) : nullptr;
+        };
 
         if (minOrder == maxOrder) {
             // Single block selection: respect geometric boundaries
             // Only include entities between start and end that are in the block
             for (; start <= end; start++) {
-                if (BlockSelectionHelper::isEntityInAnyBlock(start->area(), activeBlocks)) {
+                if (activeBlockOf(start->area())) {
                     ret->appendShape(start->transformedArea(matrix), side);
                 }
             }
         } else {
-            const TextEntity *startEntity = nullptr;
+            TextEntityStore::ConstIterator startEntity = d->m_words.constEnd();
             if (startBlock) {
                 if (start != d->m_words.constEnd() && startBlock->contains(start->area())) {
-                    startEntity = &(*start);
+                    startEntity = start;
                 } else {
-                    startEntity = BlockSelectionHelper::findNearestEntityInBlock(d->m_words, startBlock, startPoint);
+                    startEntity = d->findNearestEntityInBlock(startBlock, startPoint);
                 }
             }
 
-            const TextEntity *endEntity = nullptr;
+            TextEntityStore::ConstIterator endEntity = d->m_words.constEnd();
             if (endBlock) {
                 if (end != d->m_words.constEnd() && endBlock->contains(end->area())) {
-                    endEntity = &(*end);
+                    endEntity = end;
                 } else {
-                    endEntity = BlockSelectionHelper::findNearestEntityInBlock(d->m_words, endBlock, endPoint);
+                    endEntity = d->findNearestEntityInBlock(endBlock, endPoint);
                 }
             }
 
             NormalizedRect startLineArea;
-            if (startEntity) {
+            if (startEntity != d->m_words.constEnd()) {
                 startLineArea = startEntity->area();
             }
             NormalizedRect endLineArea;
-            if (endEntity) {
+            if (endEntity != d->m_words.constEnd()) {
                 endLineArea = endEntity->area();
             }
 
@@ -753,13 +851,7 @@ std::unique_ptr<RegularAreaRect> TextPage::textArea(const TextSelection &sel, bo
 
             for (auto it = d->m_words.constBegin(); it != d->m_words.constEnd(); ++it) {
                 // Find which block this entity belongs to
-                const LayoutBlock *entityBlock = nullptr;
-                for (const LayoutBlock *block : activeBlocks) {
-                    if (block->contains(it->area())) {
-                        entityBlock = block;
-                        break;
-                    }
-                }
+                const LayoutBlock *entityBlock = activeBlockOf(it->area());
 
                 if (!entityBlock) {
                     continue;  // Entity not in any active block
@@ -782,7 +874,7 @@ std::unique_ptr<RegularAreaRect> TextPage::textArea(const TextSelection &sel, bo
                     // Entity is in the block where selection started
                     // Include if entity is at or after the start cursor position
                     // (below the start line, or on the same line but to the right)
-                    const NormalizedRect *lineArea = startEntity ? &startLineArea : nullptr;
+                    const NormalizedRect *lineArea = startEntity != d->m_words.constEnd() ? &startLineArea : nullptr;
                     const bool afterStart = BlockSelectionHelper::isAfterCursor(entityArea, lineArea, startPoint, blockStartC);
                     const bool beforeStart = BlockSelectionHelper::isBeforeCursor(entityArea, lineArea, startPoint, blockStartC);
                     const bool includeStart = forwardInReadingOrder ? afterStart : beforeStart;
@@ -793,7 +885,7 @@ std::unique_ptr<RegularAreaRect> TextPage::textArea(const TextSelection &sel, bo
                     // Entity is in the block where selection ended
                     // Include if entity is at or before the end cursor position
                     // (above the end line, or on the same line but to the left)
-                    const NormalizedRect *lineArea = endEntity ? &endLineArea : nullptr;
+                    const NormalizedRect *lineArea = endEntity != d->m_words.constEnd() ? &endLineArea : nullptr;
                     const bool beforeEnd = BlockSelectionHelper::isBeforeCursor(entityArea, lineArea, endPoint, blockEndC);
                     const bool afterEnd = BlockSelectionHelper::isAfterCursor(entityArea, lineArea, endPoint, blockEndC);
                     const bool includeEnd = forwardInReadingOrder ? beforeEnd : afterEnd;
@@ -818,9 +910,9 @@ RegularAreaRect *TextPage::findText(int searchID, const QString &query, SearchDi
     if (d->m_words.isEmpty() || query.isEmpty() || (area && area->isNull())) {
         return nullptr;
     }
-    TextEntity::List::ConstIterator start;
+    TextEntityStore::ConstIterator start;
     int start_offset = 0;
-    TextEntity::List::ConstIterator end;
+    TextEntityStore::ConstIterator end;
     const QMap<int, SearchPoint *>::const_iterator sIt = d->m_searchPoints.constFind(searchID);
     if (sIt == d->m_searchPoints.constEnd()) {
         // if no previous run of this search is found, then set it to start
@@ -856,12 +948,23 @@ RegularAreaRect *TextPage::findText(int searchID, const QString &query, SearchDi
         forward = false;
         break;
     };
+
+    // normalize query search all unicode (including glyphs)
+    // Use NFKC for search operations. Use NFC for copy, makeWord, and export operations.
+    QString searchQuery = query.normalized(QString::NormalizationForm_KC);
+    if (searchQuery.isEmpty()) {
+        return nullptr;
+    }
+    if (caseSensitivity == Qt::CaseInsensitive) {
+        searchQuery = TextPagePrivate::caseFolded(searchQuery);
+    }
+    const QStringView text = d->searchText(caseSensitivity);
+
     RegularAreaRect *ret = nullptr;
-    const TextComparisonFunction cmpFn = caseSensitivity == Qt::CaseSensitive ? CaseSensitiveCmpFn : CaseInsensitiveCmpFn;
     if (forward) {
-        ret = d->findTextInternalForward(searchID, query, cmpFn, start, start_offset, end);
+        ret = d->findTextInternalForward(searchID, searchQuery, text, start, start_offset, end);
     } else {
-        ret = d->findTextInternalBackward(searchID, query, cmpFn, start, start_offset, end);
+        ret = d->findTextInternalBackward(searchID, searchQuery, text, start, start_offset, end);
     }
     return ret;
 }
@@ -870,7 +973,7 @@ RegularAreaRect *TextPage::findText(int searchID, const QString &query, SearchDi
 // we have a '-' just followed by a '\n' character
 // check if the string contains a '-' character
 // if the '-' is the last entry
-static int stringLengthAdaptedWithHyphen(const QString &str, TextEntity::List::ConstIterator it, TextEntity::List::ConstIterator textListEnd)
+static int stringLengthAdaptedWithHyphen(const QString &str, TextEntityStore::ConstIterator it, TextEntityStore::ConstIterator textListEnd)
 {
     const int len = str.length();
 
@@ -882,14 +985,14 @@ static int stringLengthAdaptedWithHyphen(const QString &str, TextEntity::List::C
         // validity check of it + 1
         if ((it + 1) != textListEnd) {
             // 1. if the next character is '\n'
-            const QString &lookahedStr = (it + 1)->text();
+            const QStringView lookahedStr = (it + 1)->text();
             if (lookahedStr.startsWith(QLatin1Char('\n'))) {
                 return len - 1;
             }
 
             // 2. if the next word is in a different line or not
-            const NormalizedRect &hyphenArea = it->area();
-            const NormalizedRect &lookaheadArea = (it + 1)->area();
+            const NormalizedRect hyphenArea = it->area();
+            const NormalizedRect lookaheadArea = (it + 1)->area();
 
             // lookahead to check whether both the '-' rect and next character rect overlap
             if (!doesConsumeY(hyphenArea, lookaheadArea, 70)) {
@@ -905,15 +1008,55 @@ static int stringLengthAdaptedWithHyphen(const QString &str, TextEntity::List::C
     return len;
 }
 
+QStringView TextPagePrivate::searchText(Qt::CaseSensitivity caseSensitivity)
+{
+    if (m_searchWordStarts.isEmpty()) {
+        // normalizing the words once per page instead of on every search is what makes searching fast
+        m_searchWordStarts.reserve(m_words.count() + 1);
+        m_searchWordAdjustedEnds.reserve(m_words.count());
+        for (TextEntityStore::ConstIterator it = m_words.constBegin(); it != m_words.constEnd(); ++it) {
+            const QStringView text = it->text();
+            const QString str = QString::fromRawData(text.data(), text.size()).normalized(QString::NormalizationForm_KC);
+            m_searchWordStarts.append(m_searchText.size());
+            m_searchWordAdjustedEnds.append(m_searchText.size() + stringLengthAdaptedWithHyphen(str, it, m_words.constEnd()));
+            m_searchText += str;
+        }
+        m_searchWordStarts.append(m_searchText.size());
+        m_searchText.squeeze();
+    }
+
+    if (caseSensitivity == Qt::CaseSensitive) {
+        return m_searchText;
+    }
+
+    if (m_foldedSearchText.isEmpty()) {
+        m_foldedSearchText = caseFolded(m_searchText);
+    }
+    return m_foldedSearchText;
+}
+
+void TextPagePrivate::clearSearchText()
+{
+    m_searchText.clear();
+    m_foldedSearchText.clear();
+    m_searchWordStarts.clear();
+    m_searchWordAdjustedEnds.clear();
+}
+
+qsizetype TextPagePrivate::searchWordAt(qsizetype position) const
+{
+    // the last word starting at or before position, empty words before it start there too
+    return std::upper_bound(m_searchWordStarts.cbegin(), m_searchWordStarts.cend(), quint32(position)) - m_searchWordStarts.cbegin() - 1;
+}
+
 RegularAreaRect *TextPagePrivate::searchPointToArea(const SearchPoint *sp)
 {
     const PagePrivate *pagePrivate = PagePrivate::get(m_page);
     const QTransform matrix = pagePrivate ? pagePrivate->rotationMatrix() : QTransform();
     RegularAreaRect *ret = new RegularAreaRect;
 
-    for (TextEntity::List::ConstIterator it = sp->it_begin;; it++) {
-        const TextEntity &curEntity = *it;
-        ret->append(curEntity.transformedArea(matrix));
+    for (TextEntityStore::ConstIterator it = sp->it_begin;; it++) {
+        ret->append(it->transformedArea(matrix));
 
         if (it == sp->it_end) {
             break;
@@ -924,27 +1067,26 @@ RegularAreaRect *TextPagePrivate::searchPointToArea(const SearchPoint *sp)
     return ret;
 }
 
-RegularAreaRect *TextPagePrivate::findTextInternalForward(int searchID, const QString &_query, TextComparisonFunction comparer, TextEntity::List::ConstIterator start, int start_offset, TextEntity::List::ConstIterator end)
+RegularAreaRect *TextPagePrivate::findTextInternalForward(int searchID, QStringView query, QStringView text, TextEntityStore::ConstIterator start, int start_offset, TextEntityStore::ConstIterator end)
 {
-    // normalize query search all unicode (including glyphs)
-    // Use NFKC for search operations. Use NFC for copy, makeWord, and export operations.
-    const QString query = _query.normalized(QString::NormalizationForm_KC);
+    // query and text are normalized, and case folded for the case insensitive searches,
+    // so they are compared as they are
 
     // j is the current position in our query
     // queryLeft is the length of the query we have left to match
     int j = 0, queryLeft = query.length();
 
-    TextEntity::List::ConstIterator it = start;
+    TextEntityStore::ConstIterator it = start;
     int offset = start_offset;
 
-    TextEntity::List::ConstIterator it_begin = TextEntity::List::ConstIterator();
+    TextEntityStore::ConstIterator it_begin = TextEntityStore::ConstIterator();
     int offset_begin = 0; // dummy initial value to suppress compiler warnings
 
     while (it != end) {
-        const TextEntity &curEntity = *it;
-        const QString &str = curEntity.text().normalized(QString::NormalizationForm_KC);
-        const int strLen = str.length();
-        const int adjustedLen = stringLengthAdaptedWithHyphen(str, it, m_words.constEnd());
+        const qsizetype index = it - m_words.constBegin();
+        const int wordStart = m_searchWordStarts.at(index);
+        const int strLen = m_searchWordStarts.at(index + 1) - wordStart;
+        const int adjustedLen = m_searchWordAdjustedEnds.at(index) - wordStart;
         // adjustedLen <= strLen
 
         if (offset >= strLen) {
@@ -953,18 +1095,20 @@ RegularAreaRect *TextPagePrivate::findTextInternalForward(int searchID, const QS
             continue;
         }
 
-        if (it_begin == TextEntity::List::ConstIterator()) {
+        if (it_begin == TextEntityStore::ConstIterator()) {
             it_begin = it;
             offset_begin = offset;
         }
 
+        const QStringView str = text.sliced(wordStart, strLen);
+
         // Let the user write the hyphen or not when searching for text
         int matchedLen = -1;
         for (int matchingLen = strLen; matchingLen >= adjustedLen; matchingLen--) {
             // we have equal (or less than) area of the query left as the length of the current
             // entity
             const int min = qMin(queryLeft, matchingLen - offset);
-            if (comparer(QStringView {str}.mid(offset, min), QStringView {query}.mid(j, min))) {
+            if (str.mid(offset, min) == query.mid(j, min)) {
                 matchedLen = min;
                 break;
             }
@@ -974,15 +1118,20 @@ RegularAreaRect *TextPagePrivate::findTextInternalForward(int searchID, const QS
             // we have not matched
             // this means we do not have a complete match
             // we need to get back to query start
-            // and continue the search from this place
+            // and continue the search from the next place the query can start at
 #ifdef DEBUG_TEXTPAGE
             qCDebug(OkularCoreDebug) << "\tnot matched";
 #endif
             j = 0;
             queryLeft = query.length();
-            it = it_begin;
-            offset = offset_begin + 1;
-            it_begin = TextEntity::List::ConstIterator();
+            const qsizetype next = text.indexOf(query.front(), m_searchWordStarts.at(it_begin - m_words.constBegin()) + offset_begin + 1);
+            if (next == -1) {
+                break;
+            }
+            const qsizetype nextIndex = searchWordAt(next);
+            it = m_words.constBegin() + nextIndex;
+            offset = next - m_searchWordStarts.at(nextIndex);
+            it_begin = TextEntityStore::ConstIterator();
         } else {
             // we have a match
             // move the current position in the query
@@ -1025,21 +1174,20 @@ RegularAreaRect *TextPagePrivate::findTextInternalForward(int searchID, const QS
     return nullptr;
 }
 
-RegularAreaRect *TextPagePrivate::findTextInternalBackward(int searchID, const QString &_query, TextComparisonFunction comparer, TextEntity::List::ConstIterator start, int start_offset, TextEntity::List::ConstIterator end)
+RegularAreaRect *TextPagePrivate::findTextInternalBackward(int searchID, QStringView query, QStringView text, TextEntityStore::ConstIterator start, int start_offset, TextEntityStore::ConstIterator end)
 {
-    // normalize query to search all unicode (including glyphs)
-    // Use NFKC for search operations. Use NFC for copy, makeWord, and export operations.
-    const QString query = _query.normalized(QString::NormalizationForm_KC);
+    // query and text are normalized, and case folded for the case insensitive searches,
+    // so they are compared as they are
 
     // j is the current position in our query
     // len is the length of the string in TextEntity
     // queryLeft is the length of the query we have left
     int j = query.length(), queryLeft = query.length();
 
-    TextEntity::List::ConstIterator it = start;
+    TextEntityStore::ConstIterator it = start;
     int offset = start_offset;
 
-    TextEntity::List::ConstIterator it_begin = TextEntity::List::ConstIterator();
+    TextEntityStore::ConstIterator it_begin = TextEntityStore::ConstIterator();
     int offset_begin = 0; // dummy initial value to suppress compiler warnings
 
     while (true) {
@@ -1050,21 +1198,23 @@ RegularAreaRect *TextPagePrivate::findTextInternalBackward(int searchID, const Q
             it--;
         }
 
-        const TextEntity &curEntity = *it;
-        const QString &str = curEntity.text().normalized(QString::NormalizationForm_KC);
-        const int strLen = str.length();
-        const int adjustedLen = stringLengthAdaptedWithHyphen(str, it, m_words.constEnd());
+        const qsizetype index = it - m_words.constBegin();
+        const int wordStart = m_searchWordStarts.at(index);
+        const int strLen = m_searchWordStarts.at(index + 1) - wordStart;
+        const int adjustedLen = m_searchWordAdjustedEnds.at(index) - wordStart;
         // adjustedLen <= strLen
 
         if (offset <= 0) {
             offset = strLen;
         }
 
-        if (it_begin == TextEntity::List::ConstIterator()) {
+        if (it_begin == TextEntityStore::ConstIterator()) {
             it_begin = it;
             offset_begin = offset;
         }
 
+        const QStringView str = text.sliced(wordStart, strLen);
+
         // Let the user write the hyphen or not when searching for text
         int matchedLen = -1;
         // we have equal (or less than) area of the query left as the length of the current
@@ -1072,7 +1222,7 @@ RegularAreaRect *TextPagePrivate::findTextInternalBackward(int searchID, const Q
         for (int matchingLen = strLen; matchingLen >= adjustedLen; matchingLen--) {
             const int hyphenOffset = (strLen - matchingLen);
             const int min = qMin(queryLeft + hyphenOffset, offset);
-            if (comparer(QStringView {str}.mid(offset - min, min - hyphenOffset), QStringView {query}.mid(j - min + hyphenOffset, min - hyphenOffset))) {
+            if (str.mid(offset - min, min - hyphenOffset) == query.mid(j - min + hyphenOffset, min - hyphenOffset)) {
                 matchedLen = min - hyphenOffset;
                 break;
             }
@@ -1082,16 +1232,22 @@ RegularAreaRect *TextPagePrivate::findTextInternalBackward(int searchID, const Q
             // we have not matched
             // this means we do not have a complete match
             // we need to get back to query start
-            // and continue the search from this place
+            // and continue the search from the previous place the query can end at
 #ifdef DEBUG_TEXTPAGE
             qCDebug(OkularCoreDebug) << "\tnot matched";
 #endif
 
             j = query.length();
             queryLeft = query.length();
-            it = it_begin;
-            offset = offset_begin - 1;
-            it_begin = TextEntity::List::ConstIterator();
+            const qsizetype last = m_searchWordStarts.at(it_begin - m_words.constBegin()) + offset_begin - 2;
+            const qsizetype previous = last >= 0 ? text.lastIndexOf(query.back(), last) : -1;
+            if (previous == -1) {
+                break;
+            }
+            const qsizetype previousIndex = searchWordAt(previous);
+            it = m_words.constBegin() + previousIndex;
+            offset = previous + 1 - m_searchWordStarts.at(previousIndex);
+            it_begin = TextEntityStore::ConstIterator();
         } else {
             // we have a match
             // move the current position in the query
@@ -1144,13 +1300,13 @@ QString TextPage::text(const RegularAreaRect *area, TextAreaInclusionBehaviour b
         return QString();
     }
 
-    TextEntity::List::ConstIterator it = d->m_words.constBegin(), itEnd = d->m_words.constEnd();
+    TextEntityStore::ConstIterator it = d->m_words.constBegin(), itEnd = d->m_words.constEnd();
     QString ret;
 
     // If we have layout blocks, extract text respecting reading order
     if (!d->m_layoutBlocks.isEmpty() && area) {
         bool useIntersects = (b == AnyPixelTextAreaInclusionBehaviour);
-        return BlockSelectionHelper::extractTextInReadingOrder(d->m_words, d->m_layoutBlocks, area, useIntersects);
+        return d->extractTextInReadingOrder(area, useIntersects);
     } else if (area) {
         // No layout blocks - use original behavior
         for (; it != itEnd; ++it) {
@@ -1194,7 +1350,8 @@ static bool compareTinyTextEntityY(const WordWithCharacters &first, const WordWi
  */
 void TextPagePrivate::setWordList(const TextEntity::List &list)
 {
-    m_words = list;
+    m_words.assign(list);
+    clearSearchText();
 }
 
 /**
@@ -1228,7 +1385,7 @@ static WordsWithCharacters makeWordFromCharacters(const TextEntity::List &charac
      */
     WordsWithCharacters wordsWithCharacters;
 
-    TextEntity::List::ConstIterator it = characters.begin(), itEnd = characters.end(), tmpIt;
+    TextEntityStore::ConstIterator it = characters.begin(), itEnd = characters.end(), tmpIt;
     int newLeft, newRight, newTop, newBottom;
 
     for (; it != itEnd; it++) {
@@ -1335,20 +1492,46 @@ QList<QPair<WordsWithCharacters, QRect>> makeAndSortLines(const WordsWithCharact
     // Step 1
     std::sort(words.begin(), words.end(), compareTinyTextEntityY);
 
+    QList<QRect> areas;
+    areas.reserve(words.count());
+    for (const WordWithCharacters &word : std::as_const(words)) {
+        areas.append(word.area().roundedGeometry(pageWidth, pageHeight));
+    }
+
+    // the smallest top of the texts from each one on, the sort rounds differently so it can be a bit
+    // out of order
+    QList<int> minTops(areas.count());
+    for (qsizetype i = areas.count() - 1; i >= 0; --i) {
+        minTops[i] = (i + 1 < areas.count()) ? qMin(areas.at(i).top(), minTops.at(i + 1)) : areas.at(i).top();
+    }
+
     // Step 2
-    QList<WordWithCharacters>::Iterator it = words.begin(), itEnd = words.end();
+    /* Sweep down the page: a line ending above the texts left can't get any of them, so only
+       the open lines, in the order they were made, are checked for each text instead of all
+       the lines
+     */
+    QList<qsizetype> openLines;
 
     // for every non-space texts(characters/words) in the textList
-    for (; it != itEnd; it++) {
-        const QRect elementArea = (*it).area().roundedGeometry(pageWidth, pageHeight);
+    for (qsizetype i = 0; i < words.count(); ++i) {
+        const QRect elementArea = areas.at(i);
+        const int minTop = minTops.at(i);
         bool found = false;
 
-        for (QPair<WordsWithCharacters, QRect> &linesI : lines) {
+        for (qsizetype j = 0; j < openLines.count();) {
             /* the line area which will be expanded
                line_rects is only necessary to preserve the topmin and bottommax of all
                the texts in the line, left and right is not necessary at all
             */
+            QPair<WordsWithCharacters, QRect> &linesI = lines[openLines.at(j)];
             QRect &lineArea = linesI.second;
+
+            // no y overlap with this text nor the ones after it
+            if (lineArea.bottom() + 1 < minTop && lineArea.top() < minTop) {
+                openLines.remove(j);
+                continue;
+            }
+
             const int text_y1 = elementArea.top(), text_y2 = elementArea.top() + elementArea.height(), text_x1 = elementArea.left(), text_x2 = elementArea.left() + elementArea.width();
             const int line_y1 = lineArea.top(), line_y2 = lineArea.top() + lineArea.height(), line_x1 = lineArea.left(), line_x2 = lineArea.left() + lineArea.width();
 
@@ -1358,7 +1541,7 @@ QList<QPair<WordsWithCharacters, QRect>> makeAndSortLines(const WordsWithCharact
              */
             if (doesConsumeY(elementArea, lineArea, 70)) {
                 WordsWithCharacters &line = linesI.first;
-                line.append(*it);
+                line.append(words.at(i));
 
                 const int newLeft = line_x1 < text_x1 ? line_x1 : text_x1;
                 const int newRight = line_x2 > text_x2 ? line_x2 : text_x2;
@@ -1367,18 +1550,17 @@ QList<QPair<WordsWithCharacters, QRect>> makeAndSortLines(const WordsWithCharact
 
                 lineArea = QRect(newLeft, newTop, newRight - newLeft, newBottom - newTop);
                 found = true;
-            }
-
-            if (found) {
                 break;
             }
+            ++j;
         }
 
         /* when we have found a new line create a new TextList containing
            only one element and append it to the lines
          */
         if (!found) {
-            lines.append(QPair<WordsWithCharacters, QRect>({*it}, elementArea));
+            openLines.append(lines.count());
+            lines.append(QPair<WordsWithCharacters, QRect>({words.at(i)}, elementArea));
         }
     }
 
@@ -1594,19 +1776,14 @@ static RegionTextList XYCutForBoundingBoxes(const QList<WordWithCharacters> &wor
         /**
          * 1. calculation of projection profiles
          */
-        // allocate the size of proj profiles and initialize with 0
+        // allocate the size of proj profiles and initialize with 0, one more for the differences
         int size_proj_y = node.area().height();
         int size_proj_x = node.area().width();
         // dynamic memory allocation
-        QVarLengthArray<int> proj_on_xaxis(size_proj_x);
-        QVarLengthArray<int> proj_on_yaxis(size_proj_y);
-
-        for (int j = 0; j < size_proj_y; ++j) {
-            proj_on_yaxis[j] = 0;
-        }
-        for (int j = 0; j < size_proj_x; ++j) {
-            proj_on_xaxis[j] = 0;
-        }
+        QVarLengthArray<int> proj_on_xaxis(size_proj_x + 1);
+        QVarLengthArray<int> proj_on_yaxis(size_proj_y + 1);
+        std::fill(proj_on_xaxis.begin(), proj_on_xaxis.end(), 0);
+        std::fill(proj_on_yaxis.begin(), proj_on_yaxis.end(), 0);
 
         const QList<WordWithCharacters> list = node.text();
 
@@ -1621,24 +1798,29 @@ static RegionTextList XYCutForBoundingBoxes(const QList<WordWithCharacters> &wor
         int avgX = 0;
         int count;
 
+        // Adds value to profile from first to last, clipped to its size, as differences from the
+        // previous position so each text takes the same time whatever its size
+        const auto addToProfile = [](QVarLengthArray<int> &profile, int size, int first, int last, int value) {
+            first = qMax(first, 0);
+            last = qMin(last, size - 1);
+            if (first <= last) {
+                profile[first] += value;
+                profile[last + 1] -= value;
+            }
+        };
+
         // for every text in the region
         for (const WordWithCharacters &wwc : list) {
             const QRect entRect = wwc.area().geometry(pageWidth, pageHeight);
 
             // calculate vertical projection profile proj_on_xaxis1
-            for (int k = entRect.left(); k <= entRect.left() + entRect.width(); ++k) {
-                if ((k - regionRect.left()) < size_proj_x && (k - regionRect.left()) >= 0) {
-                    proj_on_xaxis[k - regionRect.left()] += entRect.height();
-                }
-            }
+            addToProfile(proj_on_xaxis, size_proj_x, entRect.left() - regionRect.left(), entRect.left() + entRect.width() - regionRect.left(), entRect.height());
 
             // calculate horizontal projection profile in the same way
-            for (int k = entRect.top(); k <= entRect.top() + entRect.height(); ++k) {
-                if ((k - regionRect.top()) < size_proj_y && (k - regionRect.top()) >= 0) {
-                    proj_on_yaxis[k - regionRect.top()] += entRect.width();
-                }
-            }
+            addToProfile(proj_on_yaxis, size_proj_y, entRect.top() - regionRect.top(), entRect.top() + entRect.height() - regionRect.top(), entRect.width());
         }
+        std::partial_sum(proj_on_xaxis.begin(), proj_on_xaxis.end(), proj_on_xaxis.begin());
+        std::partial_sum(proj_on_yaxis.begin(), proj_on_yaxis.end(), proj_on_yaxis.begin());
 
         for (int j = 0; j < size_proj_y; ++j) {
             if (proj_on_yaxis[j] > maxY) {
@@ -1843,8 +2025,12 @@ TextEntity::List addNecessarySpace(RegionTextList tree, int pageWidth, int pageH
 
         // Step 02
         for (QPair<WordsWithCharacters, QRect> &sortedLine : sortedLines) {
-            WordsWithCharacters &list = sortedLine.first;
+            const WordsWithCharacters &list = sortedLine.first;
+            // the line with the spaces, made aside since inserting them one by one is quadratic
+            WordsWithCharacters spacedList;
+            spacedList.reserve(2 * list.length());
             for (int k = 0; k < list.length(); k++) {
+                spacedList.append(list.at(k));
                 const QRect area1 = list.at(k).area().roundedGeometry(pageWidth, pageHeight);
                 if (k + 1 >= list.length()) {
                     break;
@@ -1866,13 +2052,11 @@ TextEntity::List addNecessarySpace(RegionTextList tree, int pageWidth, int pageH
                     TextEntity ent1 = TextEntity(spaceStr, entRect);
                     WordWithCharacters word(ent1, QList<TextEntity>() << ent1);
 
-                    list.insert(k + 1, word);
-
-                    // Skip the space
-                    k++;
+                    spacedList.append(word);
                 }
             }
-            counter += list.length();
+            sortedLine.first = std::move(spacedList);
+            counter += sortedLine.first.length();
         }
         res.reserve(res.length() + counter);
 
@@ -1901,7 +2085,7 @@ void TextPagePrivate::correctTextOrder()
     const int pageWidth = (int)(scalingFactor * m_page->width());
     const int pageHeight = (int)(scalingFactor * m_page->height());
 
-    TextEntity::List characters = m_words;
+    TextEntity::List characters = m_words.toList();
 
     /**
      * Remove spaces from the text
@@ -1932,23 +2116,21 @@ TextEntity::List TextPage::words(const RegularAreaRect *area, TextAreaInclusionB
         return TextEntity::List();
     }
 
+    if (!area) {
+        return d->m_words.toList();
+    }
+
     TextEntity::List ret;
-    if (area) {
-        for (const TextEntity &te : std::as_const(d->m_words)) {
-            if (b == AnyPixelTextAreaInclusionBehaviour) {
-                if (area->intersects(te.area())) {
-                    ret.append(te);
-                }
-            } else {
-                const NormalizedPoint center = te.area().center();
-                if (area->contains(center.x, center.y)) {
-                    ret.append(te);
-                }
+    for (const TextEntityStore::Entry &te : d->m_words) {
+        if (b == AnyPixelTextAreaInclusionBehaviour) {
+            if (area->intersects(te.area())) {
+                ret.append(te.toTextEntity());
+            }
+        } else {
+            const NormalizedPoint center = te.area().center();
+            if (area->contains(center.x, center.y)) {
+                ret.append(te.toTextEntity());
             }
-        }
-    } else {
-        for (const TextEntity &te : std::as_const(d->m_words)) {
-            ret.append(te);
         }
     }
     return ret;
@@ -1956,9 +2138,9 @@ TextEntity::List TextPage::words(const RegularAreaRect *area, TextAreaInclusionB
 
 std::unique_ptr<RegularAreaRect> TextPage::wordAt(const NormalizedPoint &p) const
 {
-    TextEntity::List::ConstIterator itBegin = d->m_words.constBegin(), itEnd = d->m_words.constEnd();
-    TextEntity::List::ConstIterator it = itBegin;
-    TextEntity::List::ConstIterator posIt = itEnd;
+    TextEntityStore::ConstIterator itBegin = d->m_words.constBegin(), itEnd = d->m_words.constEnd();
+    TextEntityStore::ConstIterator it = itBegin;
+    TextEntityStore::ConstIterator posIt = itEnd;
     for (; it != itEnd; ++it) {
         if (it->area().contains(p.x, p.y)) {
             posIt = it;
@@ -1966,14 +2148,14 @@ std::unique_ptr<RegularAreaRect> TextPage::wordAt(const NormalizedPoint &p) cons
         }
     }
     if (posIt != itEnd) {
-        if (posIt->text().simplified().isEmpty()) {
+        if (posIt->text().trimmed().isEmpty()) {
             return nullptr;
         }
         // Find the first TinyTextEntity of the word
         while (posIt != itBegin) {
             --posIt;
-            const QString itText = posIt->text();
-            if (itText.right(1).at(0).isSpace()) {
+            const QStringView itText = posIt->text();
+            if (itText.back().isSpace()) {
                 if (itText.endsWith(QLatin1String("-\n"))) {
                     // Is an hyphenated word
                     // continue searching the start of the word back
@@ -1997,14 +2179,14 @@ std::unique_ptr<RegularAreaRect> TextPage::wordAt(const NormalizedPoint &p) cons
         auto ret = std::make_unique<RegularAreaRect>();
         QString foundWord;
         for (; posIt != itEnd; ++posIt) {
-            const QString itText = posIt->text();
-            if (itText.simplified().isEmpty()) {
+            const QStringView itText = posIt->text();
+            if (itText.trimmed().isEmpty()) {
                 break;
             }
 
             ret->appendShape(posIt->area());
             foundWord += posIt->text();
-            if (itText.right(1).at(0).isSpace()) {
+            if (itText.back().isSpace()) {
                 if (!foundWord.endsWith(QLatin1String("-\n"))) {
                     break;
                 }
@@ -103,6 +103,7 @@ class OKULARCORE_EXPORT TextPage
     /// @cond PRIVATE
     friend class Page;
     friend class PagePrivate;
+    friend class TextPagePrivate;
     /// @endcond
 
 public:
@@ -15,7 +15,11 @@
 #include <QPair>
 #include <QTransform>
 
+#include <compare>
+#include <iterator>
+
 #include "area.h"
+#include "layoutblockindex_p.h"
 
 class SearchPoint;
 
@@ -28,15 +32,186 @@ class RegularAreaRect;
 class Page;
 
 /**
- * Returns whether the two strings match.
- * Satisfies the condition that if two strings match then their lengths are equal.
+ * A list of RegionText. It keeps a bunch of TextList with their bounding rectangles
  */
-typedef bool (*TextComparisonFunction)(QStringView from, const QStringView to);
+typedef QList<RegionText> RegionTextList;
 
 /**
- * A list of RegionText. It keeps a bunch of TextList with their bounding rectangles
+ * The words of a text page, stored compactly: the text of all the words is
+ * kept in one UTF-16 buffer, and the areas are kept as floats next to the
+ * offsets of the words in it.
+ *
+ * It's walked like a TextEntity::List, but its entries are views: the text
+ * of an entry points into the buffer, and is valid until the store changes.
  */
-typedef QList<RegionText> RegionTextList;
+class TextEntityStore
+{
+public:
+    class Entry
+    {
+    public:
+        QStringView text() const
+        {
+            return m_store->text(m_index);
+        }
+
+        NormalizedRect area() const
+        {
+            return m_store->area(m_index);
+        }
+
+        NormalizedRect transformedArea(const QTransform &matrix) const;
+
+        TextEntity toTextEntity() const;
+
+    private:
+        friend class TextEntityStore;
+
+        const TextEntityStore *m_store = nullptr;
+        qsizetype m_index = 0;
+    };
+
+    class ConstIterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type = qsizetype;
+        using value_type = Entry;
+        using pointer = const Entry *;
+        using reference = const Entry &;
+
+        ConstIterator() = default;
+
+        const Entry &operator*() const
+        {
+            return m_entry;
+        }
+        const Entry *operator->() const
+        {
+            return &m_entry;
+        }
+
+        ConstIterator &operator++()
+        {
+            ++m_entry.m_index;
+            return *this;
+        }
+        ConstIterator operator++(int)
+        {
+            ConstIterator it = *this;
+            ++m_entry.m_index;
+            return it;
+        }
+        ConstIterator &operator--()
+        {
+            --m_entry.m_index;
+            return *this;
+        }
+        ConstIterator operator--(int)
+        {
+            ConstIterator it = *this;
+            --m_entry.m_index;
+            return it;
+        }
+        ConstIterator operator+(qsizetype n) const
+        {
+            return ConstIterator(m_entry.m_store, m_entry.m_index + n);
+        }
+        ConstIterator operator-(qsizetype n) const
+        {
+            return ConstIterator(m_entry.m_store, m_entry.m_index - n);
+        }
+        qsizetype operator-(const ConstIterator &other) const
+        {
+            return m_entry.m_index - other.m_entry.m_index;
+        }
+
+        // a default constructed iterator is different from all the iterators of a store
+        bool operator==(const ConstIterator &other) const
+        {
+            return m_entry.m_store == other.m_entry.m_store && m_entry.m_index == other.m_entry.m_index;
+        }
+        auto operator<=>(const ConstIterator &other) const
+        {
+            return m_entry.m_index <=> other.m_entry.m_index;
+        }
+
+    private:
+        friend class TextEntityStore;
+
+        ConstIterator(const TextEntityStore *store, qsizetype index)
+        {
+            m_entry.m_store = store;
+            m_entry.m_index = index;
+        }
+
+        Entry m_entry;
+    };
+
+    bool isEmpty() const
+    {
+        return m_areas.isEmpty();
+    }
+    qsizetype count() const
+    {
+        return m_areas.count();
+    }
+
+    ConstIterator constBegin() const
+    {
+        return ConstIterator(this, 0);
+    }
+    ConstIterator constEnd() const
+    {
+        return ConstIterator(this, count());
+    }
+    ConstIterator begin() const
+    {
+        return constBegin();
+    }
+    ConstIterator end() const
+    {
+        return constEnd();
+    }
+
+    QStringView text(qsizetype index) const
+    {
+        const quint32 start = index > 0 ? m_ends.at(index - 1) : 0;
+        return QStringView(m_text).sliced(start, m_ends.at(index) - start);
+    }
+
+    NormalizedRect area(qsizetype index) const
+    {
+        const Area &area = m_areas.at(index);
+        return NormalizedRect(area.left, area.top, area.right, area.bottom);
+    }
+
+    void append(QStringView text, const NormalizedRect &area);
+    void removeLast();
+
+    /**
+     * Replaces the contents with @p words, taking no more memory than needed
+     */
+    void assign(const TextEntity::List &words);
+    TextEntity::List toList() const;
+
+    /**
+     * The memory used by the store, in bytes
+     */
+    qulonglong memoryUsage() const;
+
+private:
+    struct Area {
+        float left;
+        float top;
+        float right;
+        float bottom;
+    };
+
+    QString m_text;
+    QList<quint32> m_ends; // offset in m_text after the last character of each word
+    QList<Area> m_areas;
+};
 
 class TextPagePrivate
 {
@@ -44,11 +219,36 @@ public:
     TextPagePrivate();
     ~TextPagePrivate();
 
-    RegularAreaRect *findTextInternalForward(int searchID, const QString &query, TextComparisonFunction comparer, const TextEntity::List::ConstIterator start, int start_offset, const TextEntity::List::ConstIterator end);
-    RegularAreaRect *findTextInternalBackward(int searchID, const QString &query, TextComparisonFunction comparer, const TextEntity::List::ConstIterator start, int start_offset, const TextEntity::List::ConstIterator end);
+    static TextPagePrivate *get(TextPage *textPage);
 
     /**
-     * Copy a TextList to m_words, the pointers of list are adopted
+     * Returns @p text case folded like QStringView::compare() does with Qt::CaseInsensitive,
+     * one code point at a time so the offsets in it stay the same.
+     */
+    static QString caseFolded(QStringView text);
+
+    RegularAreaRect *findTextInternalForward(int searchID, QStringView query, QStringView text, const TextEntityStore::ConstIterator start, int start_offset, const TextEntityStore::ConstIterator end);
+    RegularAreaRect *findTextInternalBackward(int searchID, QStringView query, QStringView text, const TextEntityStore::ConstIterator start, int start_offset, const TextEntityStore::ConstIterator end);
+
+    /**
+     * The text of m_words normalized (NFKC) for searching, the words one after
+     * the other. It's built on the first search, and case folded on the first
+     * case insensitive one.
+     */
+    QStringView searchText(Qt::CaseSensitivity caseSensitivity);
+
+    /**
+     * Drops the search text, to call when m_words changes
+     */
+    void clearSearchText();
+
+    /**
+     * The index of the word containing the character at @p position of the search text
+     */
+    qsizetype searchWordAt(qsizetype position) const;
+
+    /**
+     * Copy a TextList to m_words
      */
     void setWordList(const TextEntity::List &list);
 
@@ -97,7 +297,7 @@ public:
      * @param block The layout block to check against
      * @return true if this is the last entity in the block
      */
-    bool isLastEntityInBlock(TextEntity::List::ConstIterator it, const LayoutBlock *block) const;
+    bool isLastEntityInBlock(TextEntityStore::ConstIterator it, const LayoutBlock *block) const;
 
     /**
      * Determine if a text entity should be included in selection based on
@@ -111,10 +311,33 @@ public:
      * @param block The layout block to check against
      * @return true if the entity should be included (center is in block or no block specified)
      */
-    bool shouldIncludeEntity(const TextEntity &entity, const LayoutBlock *block) const;
+    bool shouldIncludeEntity(const TextEntityStore::Entry &entity, const LayoutBlock *block) const;
+
+    /**
+     * Find the text entity nearest to @p p within @p block, m_words.constEnd() if there's none.
+     * BlockSelection::findNearestEntityInBlock() for m_words.
+     */
+    TextEntityStore::ConstIterator findNearestEntityInBlock(const LayoutBlock *block, const NormalizedPoint &p) const;
+
+    /**
+     * Extract the text of the entities in @p area, respecting block reading order.
+     * BlockSelection::extractTextInReadingOrder() for m_words.
+     */
+    QString extractTextInReadingOrder(const RegularAreaRect *area, bool useIntersects) const;
+
+    /**
+     * An estimate of the memory used by the text page, in bytes
+     */
+    qulonglong memoryUsage() const;
 
     // variables those can be accessed directly from TextPage
-    TextEntity::List m_words;
+    TextEntityStore m_words;
+
+    // see searchText()
+    QString m_searchText;
+    QString m_foldedSearchText;
+    QList<quint32> m_searchWordStarts; // offset of each word in m_searchText, and the length of m_searchText last
+    QList<quint32> m_searchWordAdjustedEnds; // where each word ends when its end of line hyphen is left out
     QMap<int, SearchPoint *> m_searchPoints;
     Page *m_page;
 
@@ -125,6 +348,7 @@ public:
      * @since 24.12
      */
     QList<LayoutBlock> m_layoutBlocks;
+    LayoutBlockIndex m_layoutBlockIndex; // of m_layoutBlocks
 
 private:
     RegularAreaRect *searchPointToArea(const SearchPoint *sp);
@@ -0,0 +1,157 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "textsearchjob_p.h"
+
+#include <utility>
+
+#include "area.h"
+#include "generator_p.h"
+#include "page_p.h"
+#include "textpage.h"
+
+using namespace Okular;
+
+static QList<TextSearchMatch> findAll(TextPage *textPage, int searchID, const QString &text, Qt::CaseSensitivity caseSensitivity, const QColor &color)
+{
+    QList<TextSearchMatch> matches;
+    RegularAreaRect *lastMatch = textPage->findText(searchID, text, FromTop, caseSensitivity, nullptr);
+    while (lastMatch) {
+        matches.append(TextSearchMatch(lastMatch, color));
+        lastMatch = textPage->findText(searchID, text, NextResult, caseSensitivity, lastMatch);
+    }
+    return matches;
+}
+
+QList<TextSearchMatch> Okular::searchTextPage(TextPage *textPage, const TextSearchQuery &query)
+{
+    QList<TextSearchMatch> matches;
+    if (!textPage || query.text.isEmpty()) {
+        return matches;
+    }
+
+    switch (query.type) {
+    case Document::NextMatch:
+    case Document::PreviousMatch: {
+        RegularAreaRect *match = textPage->findText(query.searchID, query.text, query.type == Document::NextMatch ? FromTop : FromBottom, query.caseSensitivity, nullptr);
+        if (match) {
+            matches.append(TextSearchMatch(match, query.color));
+        }
+        break;
+    }
+    case Document::AllDocument:
+        matches = findAll(textPage, query.searchID, query.text, query.caseSensitivity, query.color);
+        break;
+    case Document::GoogleAll:
+    case Document::GoogleAny: {
+        const int wordCount = query.words.count();
+        const int hueStep = (wordCount > 1) ? (60 / (wordCount - 1)) : 60;
+        int baseHue, baseSat, baseVal;
+        query.color.getHsv(&baseHue, &baseSat, &baseVal);
+
+        bool allMatched = wordCount > 0;
+        for (int w = 0; w < wordCount; w++) {
+            int newHue = baseHue - w * hueStep;
+            if (newHue < 0) {
+                newHue += 360;
+            }
+            const QList<TextSearchMatch> wordMatches = findAll(textPage, query.searchID, query.words[w], query.caseSensitivity, QColor::fromHsv(newHue, baseSat, baseVal));
+            allMatched = allMatched && !wordMatches.isEmpty();
+            matches += wordMatches;
+        }
+
+        // if not all words are present in page, remove partial highlights
+        if (!allMatched && query.type == Document::GoogleAll) {
+            for (const TextSearchMatch &match : std::as_const(matches)) {
+                delete match.first;
+            }
+            matches.clear();
+        }
+        break;
+    }
+    }
+    return matches;
+}
+
+TextSearchJob::TextSearchJob(Generator *generator, Page *page, const TextSearchQuery &query, int index)
+    : ThreadWeaver::QObjectDecorator(new TextSearchJobInternal(generator, page, query))
+    , mPage(page)
+    , mIndex(index)
+{
+}
+
+Page *TextSearchJob::page() const
+{
+    return mPage;
+}
+
+int TextSearchJob::index() const
+{
+    return mIndex;
+}
+
+void TextSearchJob::abort()
+{
+    static_cast<TextSearchJobInternal *>(job())->abort();
+}
+
+TextSearchJobInternal::TextSearchJobInternal(Generator *generator, Page *page, const TextSearchQuery &query)
+    : mGenerator(generator)
+    , mPage(page)
+    , mQuery(query)
+    , mRequest(page)
+{
+}
+
+TextSearchJobInternal::~TextSearchJobInternal()
+{
+    delete mTextPage;
+    for (const TextSearchMatch &match : std::as_const(mMatches)) {
+        delete match.first;
+    }
+}
+
+TextPage *TextSearchJobInternal::takeTextPage()
+{
+    return std::exchange(mTextPage, nullptr);
+}
+
+QList<TextSearchMatch> TextSearchJobInternal::takeMatches()
+{
+    return std::exchange(mMatches, {});
+}
+
+void TextSearchJobInternal::abort()
+{
+    TextRequestPrivate::get(&mRequest)->mShouldAbortExtraction = 1;
+}
+
+void TextSearchJobInternal::run(ThreadWeaver::JobPointer self, ThreadWeaver::Thread *thread)
+{
+    Q_UNUSED(self);
+    Q_UNUSED(thread);
+
+    if (mRequest.shouldAbortExtraction()) {
+        return;
+    }
+
+    mTextPage = mGenerator->textPage(&mRequest);
+    if (!mTextPage) {
+        return;
+    }
+
+    // An aborted extraction can give a partial text page, that must not be kept
+    if (mRequest.shouldAbortExtraction()) {
+        delete mTextPage;
+        mTextPage = nullptr;
+        return;
+    }
+
+    PagePrivate::get(mPage)->prepareTextPage(mTextPage);
+    mMatches = searchTextPage(mTextPage, mQuery);
+}
+
+#include "moc_textsearchjob_p.cpp"
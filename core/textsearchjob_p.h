@@ -0,0 +1,110 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef _OKULAR_TEXTSEARCHJOB_P_H_
+#define _OKULAR_TEXTSEARCHJOB_P_H_
+
+#include <QColor>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <threadweaver/job.h>
+#include <threadweaver/qobjectdecorator.h>
+
+#include "core/document.h"
+#include "core/generator.h"
+
+namespace Okular
+{
+class Page;
+class RegularAreaRect;
+class TextPage;
+
+/* What a search looks for on each page */
+struct TextSearchQuery {
+    int searchID;
+    Document::SearchType type;
+    QString text;
+    QStringList words; // the words of text, for the Google searches
+    Qt::CaseSensitivity caseSensitivity;
+    QColor color;
+};
+
+typedef std::pair<RegularAreaRect *, QColor> TextSearchMatch;
+
+/* Searches @p textPage (which can be null) for @p query.
+ *
+ * NextMatch and PreviousMatch give the first match from the top or
+ * the bottom of the page, the other types give all the matches. */
+QList<TextSearchMatch> searchTextPage(TextPage *textPage, const TextSearchQuery &query);
+
+class TextSearchJobInternal : public ThreadWeaver::Job
+{
+    friend class TextSearchJob;
+
+public:
+    ~TextSearchJobInternal() override;
+
+    TextPage *takeTextPage();
+    QList<TextSearchMatch> takeMatches();
+
+    TextSearchJobInternal(const TextSearchJobInternal &) = delete;
+    TextSearchJobInternal &operator=(const TextSearchJobInternal &) = delete;
+
+protected:
+    void run(ThreadWeaver::JobPointer self, ThreadWeaver::Thread *thread) override;
+
+private:
+    TextSearchJobInternal(Generator *generator, Page *page, const TextSearchQuery &query);
+
+    void abort();
+
+    Generator *const mGenerator;
+    Page *const mPage;
+    const TextSearchQuery mQuery;
+    TextRequest mRequest;
+    TextPage *mTextPage = nullptr;
+    QList<TextSearchMatch> mMatches;
+};
+
+/* Extracts the text page of a page and searches it, for the generators
+ * that can extract the text of several pages at the same time.
+ *
+ * The text page is not set on the page, that has to be done in the main
+ * thread once the job is done. */
+class TextSearchJob : public ThreadWeaver::QObjectDecorator
+{
+    Q_OBJECT
+public:
+    TextSearchJob(Generator *generator, Page *page, const TextSearchQuery &query, int index);
+
+    Page *page() const;
+
+    /* The position of the page in the pages of the search */
+    int index() const;
+
+    /* Makes the job stop as soon as possible, its results are not needed anymore */
+    void abort();
+
+    TextPage *takeTextPage()
+    {
+        return static_cast<TextSearchJobInternal *>(job())->takeTextPage();
+    }
+
+    QList<TextSearchMatch> takeMatches()
+    {
+        return static_cast<TextSearchJobInternal *>(job())->takeMatches();
+    }
+
+private:
+    Page *mPage;
+    int mIndex;
+};
+
+}
+
+#endif
@@ -10,10 +10,15 @@
 #include <QPixmap>
 #include <qmath.h>
 
+#include <algorithm>
+
 #include "tile.h"
 
 #define TILES_MAXSIZE 2000000
 
+// How many previous sizes of the page keep their tiles
+static const int maxKeptLevels = 3;
+
 using namespace Okular;
 
 static bool rankedTilesLessThan(const TileNode *t1, const TileNode *t2)
@@ -45,6 +50,30 @@ public:
      */
     void deleteTiles(const TileNode &tile);
 
+    /**
+     * The clean tiles of the page at a size it was shown at before
+     */
+    struct Level {
+        int width;
+        int height;
+        QList<std::pair<NormalizedRect, QPixmap *>> tiles;
+        qulonglong pixels;
+    };
+
+    /**
+     * Keeps a copy of the clean tiles at the current size in levels
+     */
+    void storeLevel();
+    void collectTiles(const TileNode &tile, Level &level) const;
+
+    /**
+     * Sets the tiles of @p level back, as they were at its size
+     */
+    void restoreLevel(const Level &level);
+
+    void deleteLevel(qsizetype index);
+    void deleteLevels();
+
     void markParentDirty(const TileNode &tile);
     void rankTiles(TileNode &tile, QList<TileNode *> &rankedTiles, const NormalizedRect &visibleRect, int visiblePageNumber);
     /**
@@ -71,7 +100,9 @@ public:
     qulonglong totalPixels;
     Rotation rotation;
     NormalizedRect visibleRect;
-    NormalizedRect requestRect;
+    QList<Level> levels;
+    qulonglong levelPixels;
+    QList<NormalizedRect> requestRects;
     int requestWidth;
     int requestHeight;
 };
@@ -82,7 +113,7 @@ TilesManager::Private::Private()
     , pageNumber(0)
     , totalPixels(0)
     , rotation(Rotation0)
-    , requestRect(NormalizedRect())
+    , levelPixels(0)
     , requestWidth(0)
     , requestHeight(0)
 {
@@ -110,6 +141,7 @@ TilesManager::~TilesManager()
     for (const TileNode &tile : d->tiles) {
         d->deleteTiles(tile);
     }
+    d->deleteLevels();
 
     delete d;
 }
@@ -136,10 +168,101 @@ void TilesManager::setSize(int width, int height)
         return;
     }
 
+    d->storeLevel();
+    for (TileNode &tile : d->tiles) {
+        TilesManager::Private::markDirty(tile);
+    }
+
+    // Show the kept resolution closest to the new size, the tiles have the one of the previous size already
+    const auto closest = std::ranges::min_element(d->levels, {}, [width](const Private::Level &level) {
+        return qAbs(level.width - width);
+    });
+    const bool exact = closest != d->levels.end() && closest->width == width && closest->height == height;
+    if (closest != d->levels.end() && (closest->width != d->width || closest->height != d->height)) {
+        d->restoreLevel(*closest);
+    }
+
     d->width = width;
     d->height = height;
 
-    markDirty();
+    if (exact) {
+        // the restored tiles are clean, the kept copy isn't needed anymore
+        d->deleteLevel(closest - d->levels.begin());
+    } else {
+        for (TileNode &tile : d->tiles) {
+            TilesManager::Private::markDirty(tile);
+        }
+    }
+}
+
+void TilesManager::Private::storeLevel()
+{
+    Level level {width, height, {}, 0};
+    for (const TileNode &tile : tiles) {
+        collectTiles(tile, level);
+    }
+    if (level.tiles.isEmpty()) {
+        return;
+    }
+
+    for (qsizetype i = 0; i < levels.count(); ++i) {
+        if (levels.at(i).width == width && levels.at(i).height == height) {
+            deleteLevel(i);
+            break;
+        }
+    }
+    levels.prepend(level);
+    levelPixels += level.pixels;
+
+    while (levels.count() > maxKeptLevels) {
+        deleteLevel(levels.count() - 1);
+    }
+}
+
+void TilesManager::Private::collectTiles(const TileNode &tile, Level &level) const
+{
+    // QPixmap is implicitly shared, the copies don't take memory until the tiles get new pixmaps
+    if (tile.pixmap && !tile.dirty && !tile.partial && tile.rotation == rotation) {
+        level.tiles.append({tile.rect, new QPixmap(*tile.pixmap)});
+        level.pixels += tile.pixmap->width() * tile.pixmap->height();
+    }
+
+    for (int i = 0; i < tile.nTiles; ++i) {
+        collectTiles(tile.tiles[i], level);
+    }
+}
+
+void TilesManager::Private::restoreLevel(const Level &level)
+{
+    const int currentWidth = width;
+    const int currentHeight = height;
+    width = level.width;
+    height = level.height;
+
+    for (const auto &[rect, pixmap] : level.tiles) {
+        for (TileNode &tile : tiles) {
+            setPixmap(pixmap, rect, tile, false /*isPartialPixmap*/);
+        }
+    }
+
+    width = currentWidth;
+    height = currentHeight;
+}
+
+void TilesManager::Private::deleteLevel(qsizetype index)
+{
+    const Level level = levels.takeAt(index);
+    for (const auto &[rect, pixmap] : level.tiles) {
+        delete pixmap;
+    }
+    levelPixels -= level.pixels;
+}
+
+void TilesManager::Private::deleteLevels()
+{
+    while (!levels.isEmpty()) {
+        deleteLevel(levels.count() - 1);
+    }
 }
 
 int TilesManager::width() const
@@ -158,6 +281,8 @@ void TilesManager::setRotation(Rotation rotation)
         return;
     }
 
+    // the kept tiles are in the old rotation
+    d->deleteLevels();
     d->rotation = rotation;
 }
 
@@ -168,6 +293,7 @@ Rotation TilesManager::rotation() const
 
 void TilesManager::markDirty()
 {
+    d->deleteLevels();
     for (TileNode &tile : d->tiles) {
         TilesManager::Private::markDirty(tile);
     }
@@ -185,15 +311,15 @@ void TilesManager::Private::markDirty(TileNode &tile)
 void TilesManager::setPixmap(const QPixmap *pixmap, const NormalizedRect &rect, bool isPartialPixmap)
 {
     const NormalizedRect rotatedRect = TilesManager::fromRotatedRect(rect, d->rotation);
-    if (!d->requestRect.isNull()) {
-        if (!(d->requestRect == rect)) {
+    if (!d->requestRects.isEmpty()) {
+        if (!d->requestRects.contains(rect)) {
             return;
         }
 
         if (pixmap) {
             // Check whether the pixmap has the same absolute size of the expected
             // request.
-            // If the document is rotated, rotate requestRect back to the original
+            // If the document is rotated, rotate the requested rect back to the original
             // rotation before comparing to pixmap's size. This is to avoid
             // conversion issues. The pixmap request was made using an unrotated
             // rect.
@@ -210,7 +336,10 @@ void TilesManager::setPixmap(const QPixmap *pixmap, const NormalizedRect &rect,
             }
         }
 
-        d->requestRect = NormalizedRect();
+        // a partial pixmap is followed by the complete one
+        if (!isPartialPixmap) {
+            d->requestRects.removeOne(rect);
+        }
     }
 
     for (TileNode &tile : d->tiles) {
@@ -450,11 +579,21 @@ void TilesManager::Private::tilesAt(const NormalizedRect &rect, TileNode &tile,
 
 qulonglong TilesManager::totalMemory() const
 {
-    return 4 * d->totalPixels;
+    return 4 * (d->totalPixels + d->levelPixels);
 }
 
 void TilesManager::cleanupPixmapMemory(qulonglong numberOfBytes, const NormalizedRect &visibleRect, int visiblePageNumber)
 {
+    // The kept resolutions aren't shown, drop them first, the ones farthest from the current size before the others
+    while (numberOfBytes > 0 && !d->levels.isEmpty()) {
+        const auto farthest = std::ranges::max_element(d->levels, {}, [this](const Private::Level &level) {
+            return qAbs(level.width - d->width);
+        });
+        const qulonglong bytes = 4 * farthest->pixels;
+        numberOfBytes = bytes < numberOfBytes ? numberOfBytes - bytes : 0;
+        d->deleteLevel(farthest - d->levels.begin());
+    }
+
     QList<TileNode *> rankedTiles;
     for (TileNode &tile : d->tiles) {
         d->rankTiles(tile, rankedTiles, visibleRect, visiblePageNumber);
@@ -538,16 +677,33 @@ void TilesManager::Private::rankTiles(TileNode &tile, QList<TileNode *> &rankedT
 
 bool TilesManager::isRequesting(const NormalizedRect &rect, int pageWidth, int pageHeight) const
 {
-    return rect == d->requestRect && pageWidth == d->requestWidth && pageHeight == d->requestHeight;
+    return d->requestRects.contains(rect) && pageWidth == d->requestWidth && pageHeight == d->requestHeight;
 }
 
 void TilesManager::setRequest(const NormalizedRect &rect, int pageWidth, int pageHeight)
 {
-    d->requestRect = rect;
+    d->requestRects.clear();
+    if (!rect.isNull()) {
+        d->requestRects.append(rect);
+    }
     d->requestWidth = pageWidth;
     d->requestHeight = pageHeight;
 }
 
+void TilesManager::addRequest(const NormalizedRect &rect, int pageWidth, int pageHeight)
+{
+    if (pageWidth != d->requestWidth || pageHeight != d->requestHeight) {
+        setRequest(rect, pageWidth, pageHeight);
+    } else if (!rect.isNull() && !d->requestRects.contains(rect)) {
+        d->requestRects.append(rect);
+    }
+}
+
+void TilesManager::removeRequest(const NormalizedRect &rect)
+{
+    d->requestRects.removeOne(rect);
+}
+
 bool TilesManager::Private::splitBigTiles(TileNode &tile, const NormalizedRect &rect)
 {
     QRect tileRect = tile.rect.geometry(width, height);
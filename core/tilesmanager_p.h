@@ -143,13 +143,14 @@ public:
     QList<Tile> tilesAt(const NormalizedRect &rect, TileLeaf tileLeaf);
 
     /**
-     * The total memory consumed by the tiles manager
+     * The total memory consumed by the tiles manager, including the
+     * resolutions kept from previous sizes of the page
      */
     qulonglong totalMemory() const;
 
     /**
-     * Removes at least @p numberOfBytes bytes worth of tiles (least ranked
-     * tiles are removed first).
+     * Removes at least @p numberOfBytes bytes worth of tiles (the resolutions
+     * kept from previous sizes first, then the least ranked tiles).
      * Set @p visibleRect to the visible region of the page. Set a
      * @p visiblePageNumber if the current page is not visible.
      * Visible tiles are not discarded.
@@ -168,7 +169,22 @@ public:
     void setRequest(const NormalizedRect &rect, int pageWidth, int pageHeight);
 
     /**
-     * Inform the new size of the page and mark all tiles to repaint
+     * Adds a region to the ones being requested, for tiles rendered in parallel.
+     * A different page size replaces the regions requested so far.
+     */
+    void addRequest(const NormalizedRect &rect, int pageWidth, int pageHeight);
+
+    /**
+     * Stops expecting the pixmap of a region, e.g. because its request was cancelled
+     */
+    void removeRequest(const NormalizedRect &rect);
+
+    /**
+     * Inform the new size of the page and mark all tiles to repaint.
+     *
+     * The clean tiles of the previous size are kept, so going back to it
+     * shows them again right away. Until the new size is rendered the tiles
+     * show the kept resolution closest to it, scaled.
      */
     void setSize(int width, int height);
 
@@ -189,7 +205,7 @@ public:
     Rotation rotation() const;
 
     /**
-     * Mark all tiles as dirty
+     * Mark all tiles as dirty, and drop the resolutions kept from previous sizes
      */
     void markDirty();
 
@@ -19,6 +19,8 @@
 #include <QWidget>
 #include <QWindow>
 
+#include <cstring>
+
 using namespace Okular;
 
 QRect Utils::rotateRect(const QRect source, int width, int height, int orientation)
@@ -66,6 +68,92 @@ inline static bool isPaperColor(QRgb argb, QRgb paperColor)
     return (argb & 0xFFFFFF) == (paperColor & 0xFFFFFF); // ignore alpha
 }
 
+namespace
+{
+/**
+ * Looks for non paper pixels in the scanlines of a 32 bit image,
+ * giving the same answers as isPaperColor() on QImage::pixel().
+ *
+ * Pixels are compared two at a time as one 64 bit word, only the words
+ * that differ from paper are looked at pixel by pixel.
+ */
+class PaperScanner
+{
+public:
+    PaperScanner(const QImage &image, QRgb paperColor)
+        : m_image(image)
+        , m_paperColor(paperColor)
+        , m_premultiplied(image.format() == QImage::Format_ARGB32_Premultiplied)
+    {
+        // QImage::pixel() unpremultiplies, so premultiplied pixels are only paper at first sight when opaque
+        m_mask = m_premultiplied ? 0xFFFFFFFF : 0x00FFFFFF;
+        m_paper = (paperColor & 0xFFFFFF) | (m_premultiplied ? 0xFF000000 : 0);
+        m_mask64 = (quint64(m_mask) << 32) | m_mask;
+        m_paper64 = (quint64(m_paper) << 32) | m_paper;
+    }
+
+    const QRgb *line(int y) const
+    {
+        return reinterpret_cast<const QRgb *>(m_image.constScanLine(y));
+    }
+
+    bool isPaper(QRgb pixel) const
+    {
+        if ((pixel & m_mask) == m_paper) {
+            return true;
+        }
+        return m_premultiplied && isPaperColor(qUnpremultiply(pixel), m_paperColor);
+    }
+
+    // The first non paper pixel of line in [from, to), or -1
+    int firstInk(const QRgb *line, int from, int to) const
+    {
+        int x = from;
+        for (; x + 2 <= to; x += 2) {
+            quint64 pair;
+            std::memcpy(&pair, line + x, sizeof(pair));
+            if ((pair & m_mask64) != m_paper64) {
+                break;
+            }
+        }
+        for (; x < to; ++x) {
+            if (!isPaper(line[x])) {
+                return x;
+            }
+        }
+        return -1;
+    }
+
+    // The last non paper pixel of line in [from, to), or -1
+    int lastInk(const QRgb *line, int from, int to) const
+    {
+        int x = to;
+        for (; x - 2 >= from; x -= 2) {
+            quint64 pair;
+            std::memcpy(&pair, line + x - 2, sizeof(pair));
+            if ((pair & m_mask64) != m_paper64) {
+                break;
+            }
+        }
+        for (--x; x >= from; --x) {
+            if (!isPaper(line[x])) {
+                return x;
+            }
+        }
+        return -1;
+    }
+
+private:
+    const QImage &m_image;
+    const QRgb m_paperColor;
+    const bool m_premultiplied;
+    QRgb m_mask;
+    QRgb m_paper;
+    quint64 m_mask64;
+    quint64 m_paper64;
+};
+}
+
 NormalizedRect Utils::imageBoundingBox(const QImage *image)
 {
     if (!image) {
@@ -74,55 +162,68 @@ NormalizedRect Utils::imageBoundingBox(const QImage *image)
 
     const int width = image->width();
     const int height = image->height();
-    const QRgb paperColor = SettingsCore::paperColor().rgb();
-    int left, top, bottom, right, x, y;
 
 #ifdef BBOX_DEBUG
     QTime time;
     time.start();
 #endif
 
-    // Scan pixels for top non-white
-    for (top = 0; top < height; ++top) {
-        for (x = 0; x < width; ++x) {
-            if (!isPaperColor(image->pixel(x, top), paperColor)) {
-                goto got_top;
-            }
-        }
+    // Renders are 32 bit, anything else is brought to the format QImage::pixel() returns
+    QImage argbImage;
+    switch (image->format()) {
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32:
+    case QImage::Format_ARGB32_Premultiplied:
+        argbImage = *image;
+        break;
+    default:
+        argbImage = image->convertToFormat(QImage::Format_ARGB32);
+        break;
     }
-    return NormalizedRect(0, 0, 0, 0); // the image is blank
-got_top:
-    left = right = x;
+    const PaperScanner scanner(argbImage, SettingsCore::paperColor().rgb());
+    int left, top, bottom, right;
 
-    // Scan pixels for bottom non-white
-    for (bottom = height - 1; bottom >= top; --bottom) {
-        for (x = width - 1; x >= 0; --x) {
-            if (!isPaperColor(image->pixel(x, bottom), paperColor)) {
-                goto got_bottom;
-            }
+    // Scan lines for top non-white
+    for (top = 0; top < height; ++top) {
+        left = scanner.firstInk(scanner.line(top), 0, width);
+        if (left >= 0) {
+            break;
         }
     }
-    Q_ASSERT(0); // image changed?!
-got_bottom:
-    if (x < left) {
-        left = x;
+    if (top == height) {
+        return NormalizedRect(0, 0, 0, 0); // the image is blank
     }
-    if (x > right) {
-        right = x;
+    right = scanner.lastInk(scanner.line(top), left, width);
+
+    // Scan lines for bottom non-white
+    for (bottom = height - 1; bottom > top; --bottom) {
+        if (scanner.lastInk(scanner.line(bottom), 0, width) >= 0) {
+            break;
+        }
     }
 
-    // Scan for leftmost and rightmost (we already found some bounds on these):
-    for (y = top; y <= bottom && (left > 0 || right < width - 1); ++y) {
-        for (x = 0; x < left; ++x) {
-            if (!isPaperColor(image->pixel(x, y), paperColor)) {
-                left = x;
-            }
+    // Only the pixels outside of the bounds found so far need to be looked at
+    auto extendToLine = [&](int y) {
+        const QRgb *line = scanner.line(y);
+        const int lineLeft = scanner.firstInk(line, 0, left);
+        if (lineLeft >= 0) {
+            left = lineLeft;
         }
-        for (x = width - 1; x > right + 1; --x) {
-            if (!isPaperColor(image->pixel(x, y), paperColor)) {
-                right = x;
-            }
+        const int lineRight = scanner.lastInk(line, right + 1, width);
+        if (lineRight >= 0) {
+            right = lineRight;
         }
+    };
+    extendToLine(bottom);
+
+    // Coarse pass over every few lines first: most lines of text reach the margins,
+    // so it finds bounds close to the final ones, and the full pass below has little left to scan
+    const int coarseStep = 16;
+    for (int y = top + coarseStep; y < bottom && (left > 0 || right < width - 1); y += coarseStep) {
+        extendToLine(y);
+    }
+    for (int y = top + 1; y < bottom && (left > 0 || right < width - 1); ++y) {
+        extendToLine(y);
     }
 
     NormalizedRect bbox(QRect(left, top, (right - left + 1), (bottom - top + 1)), image->width(), image->height());
@@ -24,6 +24,7 @@
 #include "debug_pdf.h"
 #include "generator_pdf.h"
 #include "imagescaling.h"
+#include "popplerdocumentpool.h"
 #include "popplerembeddedfile.h"
 
 Q_DECLARE_METATYPE(Poppler::Annotation *)
@@ -68,10 +69,11 @@ static int maskExportedFlags(int flags)
 }
 
 // BEGIN PopplerAnnotationProxy implementation
-PopplerAnnotationProxy::PopplerAnnotationProxy(Poppler::Document *doc, QMutex *userMutex, QHash<Okular::Annotation *, Poppler::Annotation *> *annotsOnOpenHash)
+PopplerAnnotationProxy::PopplerAnnotationProxy(Poppler::Document *doc, QMutex *userMutex, QHash<Okular::Annotation *, Poppler::Annotation *> *annotsOnOpenHash, PopplerDocumentPool *pool)
     : ppl_doc(doc)
     , mutex(userMutex)
     , annotationsOnOpenHash(annotsOnOpenHash)
+    , documentPool(pool)
 {
 }
 
@@ -610,6 +612,9 @@ static Poppler::Annotation *createPopplerAnnotationFromOkularAnnotation(const Ok
 }
 void PopplerAnnotationProxy::notifyAddition(Okular::Annotation *okl_ann, int page)
 {
+    // The page no longer matches the file, render it from ppl_doc only
+    documentPool->excludePage(page);
+
     QMutexLocker ml(mutex);
 
     std::unique_ptr<Poppler::Page> ppl_page = ppl_doc->page(page);
@@ -684,7 +689,6 @@ void PopplerAnnotationProxy::notifyAddition(Okular::Annotation *okl_ann, int pag
 
 void PopplerAnnotationProxy::notifyModification(const Okular::Annotation *okl_ann, int page, bool appearanceChanged)
 {
-    Q_UNUSED(page);
     Q_UNUSED(appearanceChanged);
 
     Poppler::Annotation *ppl_ann = qvariant_cast<Poppler::Annotation *>(okl_ann->nativeId());
@@ -693,6 +697,8 @@ void PopplerAnnotationProxy::notifyModification(const Okular::Annotation *okl_an
         return;
     }
 
+    documentPool->excludePage(page);
+
     QMutexLocker ml(mutex);
 
     if (okl_ann->flags() & (Okular::Annotation::BeingMoved | Okular::Annotation::BeingResized)) {
@@ -789,6 +795,8 @@ void PopplerAnnotationProxy::notifyRemoval(Okular::Annotation *okl_ann, int page
         return;
     }
 
+    documentPool->excludePage(page);
+
     QMutexLocker ml(mutex);
 
     std::unique_ptr<Poppler::Page> ppl_page = ppl_doc->page(page);
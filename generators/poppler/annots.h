@@ -21,12 +21,14 @@
 
 #include "core/annotations.h"
 
+class PopplerDocumentPool;
+
 extern Okular::Annotation *createAnnotationFromPopplerAnnotation(Poppler::Annotation *popplerAnnotation, const Poppler::Page &popplerPage, bool *doDelete);
 
 class PopplerAnnotationProxy : public Okular::AnnotationProxy
 {
 public:
-    PopplerAnnotationProxy(Poppler::Document *doc, QMutex *userMutex, QHash<Okular::Annotation *, Poppler::Annotation *> *annotsOnOpenHash);
+    PopplerAnnotationProxy(Poppler::Document *doc, QMutex *userMutex, QHash<Okular::Annotation *, Poppler::Annotation *> *annotsOnOpenHash, PopplerDocumentPool *pool);
     ~PopplerAnnotationProxy() override;
 
     bool supports(Capability capability) const override;
@@ -38,6 +40,7 @@ private:
     Poppler::Document *ppl_doc;
     QMutex *mutex;
     QHash<Okular::Annotation *, Poppler::Annotation *> *annotationsOnOpenHash;
+    PopplerDocumentPool *documentPool;
     std::unordered_map<Okular::StampAnnotation *, std::unique_ptr<Poppler::AnnotationAppearance>> deletedStampsAnnotationAppearance;
 };
 
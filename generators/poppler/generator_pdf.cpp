@@ -20,6 +20,7 @@
 #include <QComboBox>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QImage>
 #include <QImageReader>
@@ -72,6 +73,8 @@ Q_DECLARE_METATYPE(Poppler::FontInfo)
 
 static const int defaultPageWidth = 595;
 static const int defaultPageHeight = 842;
+// documents with more pages load their annotations in the background, see loadPages()
+static const int deferredAnnotationsPageCount = 500;
 
 class PDFOptionsPage : public Okular::PrintOptionsWidget
 {
@@ -646,6 +649,9 @@ static QList<Okular::ObjectRect *> generateLinks(std::vector<std::unique_ptr<Pop
  *           mutex is needed only because we have the asynchronous thread; else
  *           the operations are all within the 'gui' thread, scheduled by the
  *           Qt scheduler and no mutex is needed.
+ *           Rendering, text extraction and font reading first try to check
+ *           out a document from 'documentPool', those don't need the mutex
+ *           and can run at the same time from different threads.
  * external: dangerous operations are all locked via mutex internally, and the
  *           only needed external thing is the 'canGeneratePixmap' method
  *           that tells if the generator is free (since we don't want an
@@ -690,6 +696,7 @@ PDFGenerator::PDFGenerator(QObject *parent, const QVariantList &args)
     setFeature(TiledRendering);
     setFeature(SwapBackingFile);
     setFeature(SupportsCancelling);
+    setFeature(ParallelRendering);
 
     // You only need to do it once not for each of the documents but it is cheap enough
     // so doing it all the time won't hurt either
@@ -729,6 +736,8 @@ Okular::Document::OpenResult PDFGenerator::loadDocumentWithPassword(const QStrin
         return Okular::Document::OpenError;
     }
 #endif
+    // before loading it, the pooled documents are only loaded from the file as it is now
+    documentPool.setSource(filePath, QByteArray());
     // create PDFDoc for the given file
     pdfdoc = Poppler::Document::load(filePath, nullptr, nullptr);
     documentFilePath = filePath;
@@ -746,6 +755,7 @@ Okular::Document::OpenResult PDFGenerator::loadDocumentFromDataWithPassword(cons
     // create PDFDoc for the given file
     pdfdoc = Poppler::Document::loadFromData(fileData, nullptr, nullptr);
     documentFilePath = QString();
+    documentPool.setSource(QString(), fileData);
     return init(pagesVector, password);
 }
 
@@ -770,6 +780,7 @@ Okular::Document::OpenResult PDFGenerator::init(QList<Okular::Page *> &pagesVect
     } else {
         documentHasPassword = false;
     }
+    documentPool.setPassword(password);
 
     xrefReconstructed = false;
     if (pdfdoc->xrefWasReconstructed()) {
@@ -817,7 +828,12 @@ Okular::Document::OpenResult PDFGenerator::init(QList<Okular::Page *> &pagesVect
     reparseConfig();
 
     // create annotation proxy
-    annotProxy = new PopplerAnnotationProxy(pdfdoc.get(), userMutex(), &annotationsOnOpenHash);
+    annotProxy = new PopplerAnnotationProxy(pdfdoc.get(), userMutex(), &annotationsOnOpenHash, &documentPool);
+
+    // the pooled documents keep the default layer visibility
+    if (pdfdoc->hasOptionalContent()) {
+        connect(pdfdoc->optionalContentModel(), &QAbstractItemModel::dataChanged, this, [this] { documentPool.excludeAllPages(); });
+    }
 
 #if POPPLER_VERSION_MACRO >= QT_VERSION_CHECK(24, 07, 0)
     setAdditionalDocumentAction(Okular::Document::CloseDocument, createLinkFromPopplerLink(pdfdoc->additionalAction(Poppler::Document::CloseDocument)));
@@ -856,6 +872,12 @@ PDFGenerator::SwapBackingFileResult PDFGenerator::swapBackingFile(QString const
         return SwapBackingFileError;
     }
 
+    // The document takes the annotations of the new pages and then deletes them, so they can't wait
+    for (int i = 0; i < pagesWithPendingAnnotations.count(); ++i) {
+        addPendingAnnotations(i);
+    }
+    pagesWithPendingAnnotations.clear();
+
     // Recreate links if needed since they are done on image() and image() is not called when swapping the file
     // since the page is already rendered
     if (oldRectsGenerated.count() == rectsGenerated.count()) {
@@ -883,6 +905,7 @@ bool PDFGenerator::doCloseDocument()
     annotProxy = nullptr;
     pdfdoc = nullptr;
     userMutex()->unlock();
+    documentPool.clear();
     docSynopsisDirty = true;
     docSyn.clear();
     docEmbeddedFilesDirty = true;
@@ -890,6 +913,8 @@ bool PDFGenerator::doCloseDocument()
     docEmbeddedFiles.clear();
     nextFontPage = 0;
     rectsGenerated.clear();
+    pagesWithPendingAnnotations.clear();
+    nextPendingAnnotationsPage = 0;
     m_pageLayoutBlocks.clear();
 
     return true;
@@ -996,6 +1021,21 @@ void PDFGenerator::loadPages(QList<Okular::Page *> &pagesVector, int rotation, b
     // TODO XPDF 3.01 check
     const int count = pagesVector.count();
     double w = 0, h = 0;
+
+    // Form fields refer to their widget annotations, so only documents without forms
+    // can have their annotations loaded later. For big documents that's done in the
+    // background so the first page doesn't have to wait for the annotations of all of them.
+    const bool hasForms = pdfdoc->formType() != Poppler::Document::NoForm;
+    const bool deferAnnotations = !hasForms && count > deferredAnnotationsPageCount;
+    pagesWithPendingAnnotations.clear();
+    nextPendingAnnotationsPage = 0;
+    if (deferAnnotations) {
+        pagesWithPendingAnnotations.fill(nullptr, count);
+    }
+
+    // the fully qualified names of the form fields of the pages, to find the signatures that are in none of them
+    QSet<QString> formFieldNames;
+
     for (int i = 0; i < count; i++) {
         // get xpdf page
         std::unique_ptr<Poppler::Page> p = pdfdoc->page(i);
@@ -1025,7 +1065,9 @@ void PDFGenerator::loadPages(QList<Okular::Page *> &pagesVector, int rotation, b
             // init a Okular::page, add transition and annotation information
             page = new Okular::Page(i, w, h, orientation);
             addTransition(p.get(), page);
-            if (true) { // TODO real check
+            if (deferAnnotations) {
+                pagesWithPendingAnnotations[i] = page;
+            } else {
                 addAnnotations(p.get(), page);
             }
             std::unique_ptr<Poppler::Link> tmplink = p->action(Poppler::Page::Opening);
@@ -1040,11 +1082,16 @@ void PDFGenerator::loadPages(QList<Okular::Page *> &pagesVector, int rotation, b
             page->setLabel(p->label());
 
             QList<Okular::FormField *> okularFormFields;
-            if (i > 0) { // for page 0 we handle the form fields at the end
+            if (i > 0 && hasForms) { // for page 0 we handle the form fields at the end
                 okularFormFields = getFormFields(p.get());
             }
             if (!okularFormFields.isEmpty()) {
                 page->setFormFields(okularFormFields);
+                // form fields are edited in pdfdoc
+                documentPool.excludePage(i);
+                for (const Okular::FormField *off : std::as_const(okularFormFields)) {
+                    formFieldNames.insert(off->fullyQualifiedName());
+                }
             }
             // qWarning(PDFDebug).nospace() << page->width() << "x" << page->height();
 
@@ -1063,39 +1110,98 @@ void PDFGenerator::loadPages(QList<Okular::Page *> &pagesVector, int rotation, b
 
     // Once we've added the signatures to all pages except page 0, we add all the missing signatures there
     // we do that because there's signatures that don't belong to any page, but okular needs a page<->signature mapping
-    if (count > 0) {
+    if (count > 0 && hasForms) {
         std::vector<std::unique_ptr<Poppler::FormFieldSignature>> allSignatures = pdfdoc->signatures();
         std::unique_ptr<Poppler::Page> page0(pdfdoc->page(0));
         QList<Okular::FormField *> page0FormFields = getFormFields(page0.get());
+        for (const Okular::FormField *off : std::as_const(page0FormFields)) {
+            formFieldNames.insert(off->fullyQualifiedName());
+        }
 
         for (auto &s : allSignatures) {
-            bool createSignature = true;
+            // If the signature is in none of the pages it's a page-less signature, add it to page 0
             const QString fullyQualifiedName = s->fullyQualifiedName();
-            auto compareSignatureByFullyQualifiedName = [&fullyQualifiedName](const Okular::FormField *off) { return off->fullyQualifiedName() == fullyQualifiedName; };
-
-            // See if the signature is in one of the already loaded page (i.e. 1 to end)
-            for (Okular::Page *p : std::as_const(pagesVector)) {
-                const QList<Okular::FormField *> pageFormFields = p->formFields();
-                if (std::find_if(pageFormFields.begin(), pageFormFields.end(), compareSignatureByFullyQualifiedName) != pageFormFields.end()) {
-                    createSignature = false;
-                    break;
-                }
-            }
-            // See if the signature is in page 0
-            if (createSignature && std::find_if(page0FormFields.constBegin(), page0FormFields.constEnd(), compareSignatureByFullyQualifiedName) != page0FormFields.constEnd()) {
-                createSignature = false;
-            }
-            // Otherwise it's a page-less signature, add it to page 0
-            if (createSignature) {
+            if (!formFieldNames.contains(fullyQualifiedName)) {
                 Okular::FormField *of = new PopplerFormFieldSignature(std::move(s));
                 page0FormFields.append(of);
+                formFieldNames.insert(fullyQualifiedName);
             }
         }
 
         if (!page0FormFields.isEmpty()) {
             pagesVector[0]->setFormFields(page0FormFields);
+            documentPool.excludePage(0);
         }
     }
+
+    if (deferAnnotations) {
+        QTimer::singleShot(0, this, qOverload<>(&PDFGenerator::loadPendingAnnotations));
+    }
+}
+
+void PDFGenerator::loadPendingAnnotations()
+{
+    // Rendering threads may be using pdfdoc, come back later instead of blocking the user interface
+    if (!userMutex()->tryLock()) {
+        QTimer::singleShot(50, this, qOverload<>(&PDFGenerator::loadPendingAnnotations));
+        return;
+    }
+
+    // A slice at a time so the user interface stays responsive
+    QList<int> loadedPages;
+    QElapsedTimer sliceTimer;
+    sliceTimer.start();
+    while (nextPendingAnnotationsPage < pagesWithPendingAnnotations.count() && sliceTimer.elapsed() < 10) {
+        if (addPendingAnnotations(nextPendingAnnotationsPage)) {
+            loadedPages << nextPendingAnnotationsPage;
+        }
+        ++nextPendingAnnotationsPage;
+    }
+    userMutex()->unlock();
+
+    for (const int page : std::as_const(loadedPages)) {
+        signalPageAnnotationsLoaded(page);
+    }
+
+    if (nextPendingAnnotationsPage < pagesWithPendingAnnotations.count()) {
+        QTimer::singleShot(0, this, qOverload<>(&PDFGenerator::loadPendingAnnotations));
+    }
+}
+
+void PDFGenerator::loadPendingAnnotations(int pageNumber)
+{
+    if (!pagesWithPendingAnnotations.value(pageNumber)) {
+        return;
+    }
+
+    userMutex()->lock();
+    const bool loaded = addPendingAnnotations(pageNumber);
+    userMutex()->unlock();
+
+    if (loaded) {
+        signalPageAnnotationsLoaded(pageNumber);
+    }
+}
+
+bool PDFGenerator::addPendingAnnotations(int pageNumber)
+{
+    Okular::Page *page = pagesWithPendingAnnotations.value(pageNumber);
+    if (!page) {
+        return false;
+    }
+    pagesWithPendingAnnotations[pageNumber] = nullptr;
+
+    std::unique_ptr<Poppler::Page> p = pdfdoc->page(pageNumber);
+    if (!p) {
+        return false;
+    }
+
+    addAnnotations(p.get(), page);
+    // Media links are resolved when the links of the page are created, which may have been before
+    if (rectsGenerated.at(pageNumber)) {
+        resolveMediaLinkReferences(page);
+    }
+    return !page->annotations().isEmpty();
 }
 
 Okular::DocumentInfo PDFGenerator::generateDocumentInfo(const QSet<Okular::DocumentInfo::Key> &keys) const
@@ -1236,15 +1342,20 @@ Okular::FontInfo::List PDFGenerator::fontsForPage(int page)
     }
 
     QList<Poppler::FontInfo> fonts;
-    userMutex()->lock();
+    PopplerDocumentPool::Lease pooledDocument = documentPool.acquire(page);
+    if (!pooledDocument) {
+        userMutex()->lock();
+    }
 
     {
-        std::unique_ptr<Poppler::FontIterator> it = pdfdoc->newFontIterator(page);
+        std::unique_ptr<Poppler::FontIterator> it = pooledDocument ? pooledDocument->newFontIterator(page) : pdfdoc->newFontIterator(page);
         if (it->hasNext()) {
             fonts = it->next();
         }
     }
-    userMutex()->unlock();
+    if (!pooledDocument) {
+        userMutex()->unlock();
+    }
 
     for (const Poppler::FontInfo &font : std::as_const(fonts)) {
         Okular::FontInfo of;
@@ -1404,6 +1515,14 @@ static bool shouldAbortRenderCallback(const QVariant &vPayload)
     return payload->request->shouldAbortRender();
 }
 
+void PDFGenerator::generatePixmap(Okular::PixmapRequest *request)
+{
+    // Don't make a page that is about to be shown wait for the background loading
+    loadPendingAnnotations(request->pageNumber());
+
+    Generator::generatePixmap(request);
+}
+
 QImage PDFGenerator::image(Okular::PixmapRequest *request)
 {
     // debug requests to this (xpdf) generator
@@ -1421,20 +1540,22 @@ QImage PDFGenerator::image(Okular::PixmapRequest *request)
     qreal fakeDpiX = request->width() / pageWidth * dpi().width();
     qreal fakeDpiY = request->height() / pageHeight * dpi().height();
 
-    // generate links rects only the first time
-    bool genObjectRects = !rectsGenerated.at(page->number());
-
-    // 0. LOCK [waits for the thread end]
-    userMutex()->lock();
+    // 0. Use a document of our own if there is one free, else LOCK [waits for the thread end]
+    PopplerDocumentPool::Lease pooledDocument = documentPool.acquire(page->number());
+    if (!pooledDocument) {
+        userMutex()->lock();
+    }
 
     if (request->shouldAbortRender()) {
-        userMutex()->unlock();
+        if (!pooledDocument) {
+            userMutex()->unlock();
+        }
         return QImage();
     }
 
     // 1. Set OutputDev parameters and Generate contents
     // note: thread safety is set on 'false' for the GUI (this) thread
-    std::unique_ptr<Poppler::Page> p = pdfdoc->page(page->number());
+    std::unique_ptr<Poppler::Page> p = pooledDocument ? pooledDocument->page(page->number()) : pdfdoc->page(page->number());
 
     // 2. Take data from outputdev and attach it to the Page
     QImage img;
@@ -1463,22 +1584,61 @@ QImage PDFGenerator::image(Okular::PixmapRequest *request)
         img.fill(Qt::white);
     }
 
-    if (p && genObjectRects) {
-        // TODO previously we extracted Image type rects too, but that needed porting to poppler
-        // and as we are not doing anything with Image type rects i did not port it, have a look at
-        // dead gp_outputdev.cpp on image extraction
-        page->setObjectRects(generateLinks(p->links()));
-        rectsGenerated[request->page()->number()] = true;
-
-        resolveMediaLinkReferences(page);
+    if (p) {
+        // rectsGenerated is shared by the rendering threads, only look at it with the lock held
+        if (pooledDocument) {
+            userMutex()->lock();
+        }
+        // generate links rects only the first time, another rendering thread may have done it in the meantime
+        if (!rectsGenerated.at(page->number())) {
+            // Links and media references must point into pdfdoc, so take them from there
+            // even when rendering with a pooled document
+            std::unique_ptr<Poppler::Page> linksPage;
+            if (pooledDocument) {
+                linksPage = pdfdoc->page(page->number());
+            }
+            generateObjectRects(pooledDocument ? linksPage.get() : p.get(), page);
+        }
+        if (pooledDocument) {
+            userMutex()->unlock();
+        }
     }
 
     // 3. UNLOCK [re-enables shared access]
-    userMutex()->unlock();
+    if (!pooledDocument) {
+        userMutex()->unlock();
+    }
 
     return img;
 }
 
+void PDFGenerator::preparePageFromCache(Okular::Page *page)
+{
+    // image() creates the links of the pages it renders, do it for the ones it didn't render
+    QMutexLocker ml(userMutex());
+    if (rectsGenerated.at(page->number())) {
+        return;
+    }
+
+    std::unique_ptr<Poppler::Page> p = pdfdoc->page(page->number());
+    generateObjectRects(p.get(), page);
+}
+
+void PDFGenerator::generateObjectRects(Poppler::Page *popplerPage, Okular::Page *page)
+{
+    if (!popplerPage || rectsGenerated.at(page->number())) {
+        return;
+    }
+
+    // TODO previously we extracted Image type rects too, but that needed porting to poppler
+    // and as we are not doing anything with Image type rects i did not port it, have a look at
+    // dead gp_outputdev.cpp on image extraction
+    page->setObjectRects(generateLinks(popplerPage->links()));
+    rectsGenerated[page->number()] = true;
+
+    resolveMediaLinkReferences(page);
+}
+
 template<typename PopplerLinkType, typename OkularLinkType, typename PopplerAnnotationType, typename OkularAnnotationType>
 void resolveMediaLinks(Okular::Action *action, enum Okular::Annotation::SubType subType, QHash<Okular::Annotation *, Poppler::Annotation *> &annotationsHash)
 {
@@ -1567,12 +1727,17 @@ Okular::TextPage *PDFGenerator::textPage(Okular::TextRequest *request)
     // build a TextList...
     std::vector<std::unique_ptr<Poppler::TextBox>> textList;
     double pageWidth, pageHeight;
-    userMutex()->lock();
+    PopplerDocumentPool::Lease pooledDocument = documentPool.acquire(page->number());
+    if (!pooledDocument) {
+        userMutex()->lock();
+    }
     if (request->shouldAbortExtraction()) {
-        userMutex()->unlock();
+        if (!pooledDocument) {
+            userMutex()->unlock();
+        }
         return nullptr;
     }
-    std::unique_ptr<Poppler::Page> pp = pdfdoc->page(page->number());
+    std::unique_ptr<Poppler::Page> pp = pooledDocument ? pooledDocument->page(page->number()) : pdfdoc->page(page->number());
     if (pp) {
         TextExtractionPayload payload(request);
         textList = pp->textList(Poppler::Page::Rotate0, shouldAbortTextExtractionCallback, QVariant::fromValue(&payload));
@@ -1583,7 +1748,9 @@ Okular::TextPage *PDFGenerator::textPage(Okular::TextRequest *request)
         pageWidth = defaultPageWidth;
         pageHeight = defaultPageHeight;
     }
-    userMutex()->unlock();
+    if (!pooledDocument) {
+        userMutex()->unlock();
+    }
 
     if (textList.empty() && request->shouldAbortExtraction()) {
         return nullptr;
@@ -1838,6 +2005,9 @@ QVariant PDFGenerator::metaData(const QString &key, const QVariant &option) cons
         }
     } else if (key == QLatin1String("DocumentHasPassword")) {
         return documentHasPassword ? QStringLiteral("yes") : QStringLiteral("no");
+    } else if (key == QLatin1String("RenderSettings")) {
+        QMutexLocker ml(userMutex());
+        return QStringLiteral("poppler %1 %2 %3").arg(Poppler::Version::string()).arg(int(pdfdoc->renderHints())).arg(pdfdoc->paperColor().name(QColor::HexArgb));
     }
     return QVariant();
 }
@@ -1862,6 +2032,7 @@ bool PDFGenerator::reparseConfig()
     }
     bool aaChanged = setDocumentRenderHints();
     somethingchanged = somethingchanged || aaChanged;
+    documentPool.setRenderSettings(pdfdoc->renderHints(), pdfdoc->paperColor());
     return somethingchanged;
 }
 
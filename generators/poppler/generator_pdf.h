@@ -31,6 +31,8 @@
 #include <interfaces/printinterface.h>
 #include <interfaces/saveinterface.h>
 
+#include "popplerdocumentpool.h"
+
 #include <unordered_map>
 
 class PDFOptionsPage;
@@ -82,7 +84,9 @@ public:
     bool isAllowed(Okular::Permission permission) const override;
 
     // [INHERITED] perform actions on document / pages
+    void generatePixmap(Okular::PixmapRequest *request) override;
     QImage image(Okular::PixmapRequest *request) override;
+    void preparePageFromCache(Okular::Page *page) override;
 
     // [INHERITED] print page using an already configured kprinter
     Okular::Document::PrintError print(QPrinter &printer) override;
@@ -136,6 +140,11 @@ private:
     void addSynopsisChildren(const QList<Poppler::OutlineItem> &outlineItems, QDomNode *parentDestination);
     // fetch annotations from the pdf file and add they to the page
     void addAnnotations(Poppler::Page *popplerPage, Okular::Page *page);
+    // add the annotations loadPages() left for later, for a slice of the pages or for the given one
+    void loadPendingAnnotations();
+    void loadPendingAnnotations(int pageNumber);
+    // called with userMutex() locked, returns whether the page got annotations
+    bool addPendingAnnotations(int pageNumber);
     // fetch the transition information and add it to the page
     void addTransition(Poppler::Page *pdfPage, Okular::Page *page);
     // fetch the poppler page form fields
@@ -143,6 +152,8 @@ private:
 
     Okular::TextPage *abstractTextPage(const std::vector<std::unique_ptr<Poppler::TextBox>> &text, double height, double width, int rot);
 
+    // called with userMutex() locked, creates the object rects of the page if not done yet
+    void generateObjectRects(Poppler::Page *popplerPage, Okular::Page *page);
     void resolveMediaLinkReferences(Okular::Page *page);
     void resolveMediaLinkReference(Okular::Action *action);
 
@@ -150,6 +161,8 @@ private:
 
     // poppler dependent stuff
     std::unique_ptr<Poppler::Document> pdfdoc;
+    // extra documents so rendering and text extraction don't need userMutex()
+    PopplerDocumentPool documentPool;
 
     void xrefReconstructionHandler();
 
@@ -170,6 +183,10 @@ private:
 
     QBitArray rectsGenerated;
 
+    // pages created without their annotations, see loadPages()
+    QList<Okular::Page *> pagesWithPendingAnnotations;
+    int nextPendingAnnotationsPage = 0;
+
     QPointer<PDFOptionsPage> pdfOptionsPage;
 
     bool documentHasPassword = false;
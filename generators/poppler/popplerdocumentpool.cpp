@@ -0,0 +1,219 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "popplerdocumentpool.h"
+
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QThread>
+
+#include "debug_pdf.h"
+
+PopplerDocumentPool::Lease::Lease(PopplerDocumentPool *pool, std::unique_ptr<Poppler::Document> &&document, int sourceGeneration)
+    : m_pool(pool)
+    , m_document(std::move(document))
+    , m_sourceGeneration(sourceGeneration)
+{
+}
+
+PopplerDocumentPool::Lease::Lease(Lease &&other) noexcept
+    : m_pool(other.m_pool)
+    , m_document(std::move(other.m_document))
+    , m_sourceGeneration(other.m_sourceGeneration)
+{
+    other.m_pool = nullptr;
+}
+
+PopplerDocumentPool::Lease &PopplerDocumentPool::Lease::operator=(Lease &&other) noexcept
+{
+    if (this != &other) {
+        release();
+        m_pool = other.m_pool;
+        m_document = std::move(other.m_document);
+        m_sourceGeneration = other.m_sourceGeneration;
+        other.m_pool = nullptr;
+    }
+    return *this;
+}
+
+PopplerDocumentPool::Lease::~Lease()
+{
+    release();
+}
+
+void PopplerDocumentPool::Lease::release()
+{
+    if (m_pool && m_document) {
+        m_pool->giveBack(std::move(m_document), m_sourceGeneration);
+    }
+    m_pool = nullptr;
+    m_document.reset();
+}
+
+PopplerDocumentPool::PopplerDocumentPool()
+    : m_fileSize(-1)
+    , m_sourceGeneration(0)
+    , m_allPagesExcluded(true)
+    , m_checkedOutDocuments(0)
+    // Every pooled document has its own xref and caches, so don't go above
+    // what the rendering threads plus text and font extraction can use
+    , m_maxDocuments(qBound(2, QThread::idealThreadCount(), 8))
+{
+}
+
+PopplerDocumentPool::~PopplerDocumentPool() = default;
+
+void PopplerDocumentPool::setSource(const QString &filePath, const QByteArray &fileData)
+{
+    const QFileInfo fileInfo(filePath);
+    QMutexLocker locker(&m_mutex);
+    m_filePath = filePath;
+    m_fileSize = filePath.isEmpty() ? -1 : fileInfo.size();
+    m_fileModified = filePath.isEmpty() ? QDateTime() : fileInfo.lastModified();
+    m_fileData = filePath.isEmpty() ? fileData : QByteArray();
+    m_password.clear();
+    m_excludedPages.clear();
+    m_allPagesExcluded = filePath.isEmpty() && fileData.isEmpty();
+    m_idleDocuments.clear();
+    ++m_sourceGeneration;
+}
+
+void PopplerDocumentPool::setPassword(const QString &password)
+{
+    QMutexLocker locker(&m_mutex);
+    m_password = password;
+}
+
+void PopplerDocumentPool::setRenderSettings(Poppler::Document::RenderHints hints, const QColor &paperColor)
+{
+    QMutexLocker locker(&m_mutex);
+    m_renderHints = hints;
+    m_paperColor = paperColor;
+}
+
+void PopplerDocumentPool::excludePage(int page)
+{
+    QMutexLocker locker(&m_mutex);
+    m_excludedPages.insert(page);
+}
+
+void PopplerDocumentPool::excludeAllPages()
+{
+    QMutexLocker locker(&m_mutex);
+    m_allPagesExcluded = true;
+    m_idleDocuments.clear();
+}
+
+void PopplerDocumentPool::clear()
+{
+    setSource(QString(), QByteArray());
+}
+
+PopplerDocumentPool::Lease PopplerDocumentPool::acquire(int page)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_allPagesExcluded || m_excludedPages.contains(page)) {
+        return Lease();
+    }
+
+    const int sourceGeneration = m_sourceGeneration;
+    std::unique_ptr<Poppler::Document> document;
+    if (!m_idleDocuments.empty()) {
+        document = std::move(m_idleDocuments.back());
+        m_idleDocuments.pop_back();
+        ++m_checkedOutDocuments;
+    } else if (m_checkedOutDocuments < m_maxDocuments) {
+        // Reserve the slot and load without holding the lock, opening a big file takes a while
+        ++m_checkedOutDocuments;
+        const QString filePath = m_filePath;
+        const QByteArray fileData = m_fileData;
+        const QString password = m_password;
+        const qint64 fileSize = m_fileSize;
+        const QDateTime fileModified = m_fileModified;
+        locker.unlock();
+        document = load(filePath, fileData, password, fileSize, fileModified);
+        locker.relock();
+        if (!document) {
+            --m_checkedOutDocuments;
+            // Something is off with the file (e.g. it changed on disk), stop trying
+            if (sourceGeneration == m_sourceGeneration) {
+                m_allPagesExcluded = true;
+            }
+            return Lease();
+        }
+    } else {
+        return Lease();
+    }
+
+    applySettings(document.get());
+    return Lease(this, std::move(document), sourceGeneration);
+}
+
+std::unique_ptr<Poppler::Document> PopplerDocumentPool::load(const QString &filePath, const QByteArray &fileData, const QString &password, qint64 fileSize, const QDateTime &fileModified)
+{
+    if (!filePath.isEmpty() && !fileUnchanged(filePath, fileSize, fileModified)) {
+        qCDebug(OkularPdfDebug) << filePath << "changed on disk, not loading it for the document pool";
+        return nullptr;
+    }
+
+    std::unique_ptr<Poppler::Document> document = !filePath.isEmpty() ? Poppler::Document::load(filePath) : Poppler::Document::loadFromData(fileData);
+    if (!document) {
+        qCDebug(OkularPdfDebug) << "Could not load an extra document for the document pool";
+        return nullptr;
+    }
+
+    // it could also have changed while it was being loaded
+    if (!filePath.isEmpty() && !fileUnchanged(filePath, fileSize, fileModified)) {
+        qCDebug(OkularPdfDebug) << filePath << "changed on disk, not loading it for the document pool";
+        return nullptr;
+    }
+
+    if (document->isLocked()) {
+        document->unlock(password.toLatin1(), password.toLatin1());
+        if (document->isLocked()) {
+            document->unlock(password.toUtf8(), password.toUtf8());
+            if (document->isLocked()) {
+                return nullptr;
+            }
+        }
+    }
+
+    return document;
+}
+
+bool PopplerDocumentPool::fileUnchanged(const QString &filePath, qint64 fileSize, const QDateTime &fileModified)
+{
+    const QFileInfo fileInfo(filePath);
+    return fileInfo.exists() && fileInfo.size() == fileSize && fileInfo.lastModified() == fileModified;
+}
+
+void PopplerDocumentPool::applySettings(Poppler::Document *document) const
+{
+    static const Poppler::Document::RenderHint hints[] = {
+        Poppler::Document::Antialiasing,
+        Poppler::Document::TextAntialiasing,
+        Poppler::Document::TextHinting,
+        Poppler::Document::TextSlightHinting,
+        Poppler::Document::ThinLineSolid,
+        Poppler::Document::ThinLineShape,
+        Poppler::Document::IgnorePaperColor,
+        Poppler::Document::HideAnnotations,
+        Poppler::Document::OverprintPreview,
+    };
+    for (const Poppler::Document::RenderHint hint : hints) {
+        document->setRenderHint(hint, m_renderHints.testFlag(hint));
+    }
+    document->setPaperColor(m_paperColor);
+}
+
+void PopplerDocumentPool::giveBack(std::unique_ptr<Poppler::Document> &&document, int sourceGeneration)
+{
+    QMutexLocker locker(&m_mutex);
+    --m_checkedOutDocuments;
+    if (sourceGeneration == m_sourceGeneration && !m_allPagesExcluded) {
+        m_idleDocuments.push_back(std::move(document));
+    }
+}
@@ -0,0 +1,137 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef POPPLERDOCUMENTPOOL_H
+#define POPPLERDOCUMENTPOOL_H
+
+#include <poppler-qt6.h>
+
+#include <QByteArray>
+#include <QColor>
+#include <QDateTime>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+#include <memory>
+#include <vector>
+
+/**
+ * A set of extra Poppler::Document instances loaded from the same file as
+ * the main document of the PDFGenerator.
+ *
+ * Poppler documents are not thread safe, so everything done on the main
+ * document is serialized through Generator::userMutex(). Rendering, text
+ * extraction and font reading only need read access to the page contents,
+ * so they can check out one of these documents instead and run concurrently.
+ *
+ * A file that changed on disk since the main document was opened from it isn't
+ * loaded again, its pages and text could differ from the ones of the main document.
+ *
+ * The pooled documents only see what is in the file: pages whose annotations
+ * or forms were changed in memory (or every page once the optional content
+ * visibility changed) are excluded and must keep using the main document.
+ */
+class PopplerDocumentPool
+{
+public:
+    /**
+     * A checked out document, given back to the pool on destruction.
+     * A null lease means the caller has to use the main document.
+     */
+    class Lease
+    {
+    public:
+        Lease() = default;
+        Lease(PopplerDocumentPool *pool, std::unique_ptr<Poppler::Document> &&document, int sourceGeneration);
+        Lease(Lease &&other) noexcept;
+        Lease &operator=(Lease &&other) noexcept;
+        ~Lease();
+
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+
+        Poppler::Document *operator->() const
+        {
+            return m_document.get();
+        }
+        explicit operator bool() const
+        {
+            return m_document != nullptr;
+        }
+
+    private:
+        void release();
+
+        PopplerDocumentPool *m_pool = nullptr;
+        std::unique_ptr<Poppler::Document> m_document;
+        int m_sourceGeneration = 0;
+    };
+
+    PopplerDocumentPool();
+    ~PopplerDocumentPool();
+
+    PopplerDocumentPool(const PopplerDocumentPool &) = delete;
+    PopplerDocumentPool &operator=(const PopplerDocumentPool &) = delete;
+
+    /**
+     * Sets where the pooled documents are loaded from, only one of @p filePath and @p fileData is used.
+     * Drops all the idle documents.
+     *
+     * Called right before the main document is loaded, the size and modification time
+     * the file has then are the ones the pooled documents are checked against.
+     */
+    void setSource(const QString &filePath, const QByteArray &fileData);
+    void setPassword(const QString &password);
+
+    /**
+     * Render hints and paper color of the main document, applied to every pooled document when it is checked out.
+     */
+    void setRenderSettings(Poppler::Document::RenderHints hints, const QColor &paperColor);
+
+    /**
+     * The page @p page differs in memory from the file, don't check out documents for it anymore.
+     */
+    void excludePage(int page);
+    /**
+     * Same as excludePage() for every page of the document.
+     */
+    void excludeAllPages();
+
+    /**
+     * Forgets the source and drops the idle documents, documents still checked out are dropped when given back.
+     */
+    void clear();
+
+    /**
+     * Checks out a document to work on @p page, @p page can be -1 for work not tied to a page.
+     * Returns a null lease if the page is excluded or if all documents are in use.
+     */
+    Lease acquire(int page);
+
+private:
+    static std::unique_ptr<Poppler::Document> load(const QString &filePath, const QByteArray &fileData, const QString &password, qint64 fileSize, const QDateTime &fileModified);
+    static bool fileUnchanged(const QString &filePath, qint64 fileSize, const QDateTime &fileModified);
+    void applySettings(Poppler::Document *document) const;
+    void giveBack(std::unique_ptr<Poppler::Document> &&document, int sourceGeneration);
+
+    QMutex m_mutex;
+    QString m_filePath;
+    qint64 m_fileSize;
+    QDateTime m_fileModified;
+    QByteArray m_fileData;
+    QString m_password;
+    Poppler::Document::RenderHints m_renderHints;
+    QColor m_paperColor;
+    int m_sourceGeneration;
+    QSet<int> m_excludedPages;
+    bool m_allPagesExcluded;
+    std::vector<std::unique_ptr<Poppler::Document>> m_idleDocuments;
+    int m_checkedOutDocuments;
+    const int m_maxDocuments;
+};
+
+#endif
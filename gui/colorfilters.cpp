@@ -0,0 +1,687 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "colorfilters.h"
+
+#include <array>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COLORFILTERS_SSE2 1
+#include <emmintrin.h>
+// GCC and Clang can compile AVX2 functions without enabling AVX2 for the whole file
+#if defined(__GNUC__)
+#define COLORFILTERS_AVX2 1
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+#define COLORFILTERS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace
+{
+#ifdef COLORFILTERS_AVX2
+bool hasAvx2()
+{
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+#endif
+
+ColorFilters::Kernels bestKernels()
+{
+#if defined(COLORFILTERS_AVX2)
+    return hasAvx2() ? ColorFilters::Avx2Kernels : ColorFilters::Sse2Kernels;
+#elif defined(COLORFILTERS_SSE2)
+    return ColorFilters::Sse2Kernels;
+#elif defined(COLORFILTERS_NEON)
+    return ColorFilters::NeonKernels;
+#else
+    return ColorFilters::PlainKernels;
+#endif
+}
+
+ColorFilters::Kernels &kernels()
+{
+    static ColorFilters::Kernels kernels = bestKernels();
+    return kernels;
+}
+
+/* The SIMD kernels process as many pixels as fit their vectors and return how many they did,
+ * the plain loops take care of the rest */
+
+void invertLumaPixels(QRgb *data, qsizetype count, float Y_R, float Y_G, float Y_B)
+{
+    for (qsizetype i = 0; i < count; ++i) {
+        uchar R = qRed(data[i]);
+        uchar G = qGreen(data[i]);
+        uchar B = qBlue(data[i]);
+
+        ColorFilters::invertLumaPixel(R, G, B, Y_R, Y_G, Y_B);
+
+        // Save new color
+        const unsigned A = qAlpha(data[i]);
+        data[i] = qRgba(R, G, B, A);
+    }
+}
+
+#ifdef COLORFILTERS_SSE2
+// Spreads the low byte of each 32 bit lane over the three color bytes
+inline __m128i spreadColor(__m128i v)
+{
+    return _mm_or_si128(v, _mm_or_si128(_mm_slli_epi32(v, 8), _mm_slli_epi32(v, 16)));
+}
+
+// qGray() of each 32 bit lane
+inline __m128i gray(__m128i v)
+{
+    const __m128i byteMask = _mm_set1_epi32(0xff);
+    const __m128i r = _mm_and_si128(_mm_srli_epi32(v, 16), byteMask);
+    const __m128i g = _mm_and_si128(_mm_srli_epi32(v, 8), byteMask);
+    const __m128i b = _mm_and_si128(v, byteMask);
+    // the products fit the low 16 bits of each lane, so a 16 bit multiply is enough
+    const __m128i sum = _mm_add_epi32(_mm_add_epi32(_mm_mullo_epi16(r, _mm_set1_epi32(11)), _mm_slli_epi32(g, 4)), _mm_mullo_epi16(b, _mm_set1_epi32(5)));
+    return _mm_srli_epi32(sum, 5);
+}
+
+qsizetype recolorSse2(QRgb *data, qsizetype count, const float scale[3], const float foreground[3])
+{
+    const __m128i alphaMask = _mm_set1_epi32(0xff000000);
+    const __m128i byteMask = _mm_set1_epi32(0xff);
+    const __m128 scaleRed = _mm_set1_ps(scale[0]), scaleGreen = _mm_set1_ps(scale[1]), scaleBlue = _mm_set1_ps(scale[2]);
+    const __m128 foregroundRed = _mm_set1_ps(foreground[0]), foregroundGreen = _mm_set1_ps(foreground[1]), foregroundBlue = _mm_set1_ps(foreground[2]);
+
+    qsizetype i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const __m128 lightness = _mm_cvtepi32_ps(gray(v));
+        const __m128i r = _mm_and_si128(_mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(scaleRed, lightness), foregroundRed)), byteMask);
+        const __m128i g = _mm_and_si128(_mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(scaleGreen, lightness), foregroundGreen)), byteMask);
+        const __m128i b = _mm_and_si128(_mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(scaleBlue, lightness), foregroundBlue)), byteMask);
+        const __m128i result = _mm_or_si128(_mm_or_si128(_mm_and_si128(v, alphaMask), _mm_slli_epi32(r, 16)), _mm_or_si128(_mm_slli_epi32(g, 8), b));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), result);
+    }
+    return i;
+}
+
+qsizetype invertLightnessSse2(QRgb *data, qsizetype count)
+{
+    const __m128i alphaMask = _mm_set1_epi32(0xff000000);
+    const __m128i colorMask = _mm_set1_epi32(0x00ffffff);
+    const __m128i byteMask = _mm_set1_epi32(0xff);
+
+    qsizetype i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const __m128i color = _mm_and_si128(v, colorMask);
+        const __m128i g = _mm_srli_epi32(color, 8);
+        const __m128i r = _mm_srli_epi32(color, 16);
+        const __m128i max = _mm_and_si128(_mm_max_epu8(_mm_max_epu8(color, g), r), byteMask);
+        const __m128i min = _mm_and_si128(_mm_min_epu8(_mm_min_epu8(color, g), r), byteMask);
+        // X' = X - m + m' with m' = 255 - C - m = 255 - max, neither step leaves 0..255
+        const __m128i result = _mm_add_epi8(_mm_sub_epi8(color, spreadColor(min)), spreadColor(_mm_sub_epi32(byteMask, max)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), _mm_or_si128(result, _mm_and_si128(v, alphaMask)));
+    }
+    return i;
+}
+
+// Inverts the run of gray pixels at the start of data, the common case on documents.
+// It stops at the first colored pixel, leaving it to the plain loop: calling that from here
+// would mix SSE and AVX code, which stalls the CPU
+qsizetype invertLumaGraySse2(QRgb *data, qsizetype count)
+{
+    const __m128i colorMask = _mm_set1_epi32(0x00ffffff);
+    const __m128i byteMask = _mm_set1_epi32(0xff);
+
+    qsizetype i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const __m128i color = _mm_and_si128(v, colorMask);
+        const __m128i isGray = _mm_cmpeq_epi32(color, spreadColor(_mm_and_si128(v, byteMask)));
+        if (_mm_movemask_epi8(isGray) != 0xffff) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), _mm_xor_si128(v, colorMask));
+    }
+    return i;
+}
+
+qsizetype hueShiftPositiveSse2(QRgb *data, qsizetype count)
+{
+    const __m128i alphaMask = _mm_set1_epi32(0xff000000);
+    const __m128i byteMask = _mm_set1_epi32(0xff);
+    const __m128i shortMask = _mm_set1_epi32(0xffff);
+
+    qsizetype i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const __m128i result = _mm_or_si128(_mm_and_si128(v, alphaMask), _mm_or_si128(_mm_slli_epi32(_mm_and_si128(v, byteMask), 16), _mm_and_si128(_mm_srli_epi32(v, 8), shortMask)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), result);
+    }
+    return i;
+}
+
+qsizetype hueShiftNegativeSse2(QRgb *data, qsizetype count)
+{
+    const __m128i alphaMask = _mm_set1_epi32(0xff000000);
+    const __m128i byteMask = _mm_set1_epi32(0xff);
+    const __m128i shortMask = _mm_set1_epi32(0xffff);
+
+    qsizetype i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const __m128i result = _mm_or_si128(_mm_and_si128(v, alphaMask), _mm_or_si128(_mm_slli_epi32(_mm_and_si128(v, shortMask), 8), _mm_and_si128(_mm_srli_epi32(v, 16), byteMask)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), result);
+    }
+    return i;
+}
+#endif
+
+#ifdef COLORFILTERS_AVX2
+#define COLORFILTERS_TARGET_AVX2 __attribute__((target("avx2")))
+
+COLORFILTERS_TARGET_AVX2 inline __m256i spreadColorAvx2(__m256i v)
+{
+    return _mm256_or_si256(v, _mm256_or_si256(_mm256_slli_epi32(v, 8), _mm256_slli_epi32(v, 16)));
+}
+
+COLORFILTERS_TARGET_AVX2 inline __m256i grayAvx2(__m256i v)
+{
+    const __m256i byteMask = _mm256_set1_epi32(0xff);
+    const __m256i r = _mm256_and_si256(_mm256_srli_epi32(v, 16), byteMask);
+    const __m256i g = _mm256_and_si256(_mm256_srli_epi32(v, 8), byteMask);
+    const __m256i b = _mm256_and_si256(v, byteMask);
+    const __m256i sum = _mm256_add_epi32(_mm256_add_epi32(_mm256_mullo_epi16(r, _mm256_set1_epi32(11)), _mm256_slli_epi32(g, 4)), _mm256_mullo_epi16(b, _mm256_set1_epi32(5)));
+    return _mm256_srli_epi32(sum, 5);
+}
+
+COLORFILTERS_TARGET_AVX2 qsizetype recolorAvx2(QRgb *data, qsizetype count, const float scale[3], const float foreground[3])
+{
+    const __m256i alphaMask = _mm256_set1_epi32(0xff000000);
+    const __m256i byteMask = _mm256_set1_epi32(0xff);
+    const __m256 scaleRed = _mm256_set1_ps(scale[0]), scaleGreen = _mm256_set1_ps(scale[1]), scaleBlue = _mm256_set1_ps(scale[2]);
+    const __m256 foregroundRed = _mm256_set1_ps(foreground[0]), foregroundGreen = _mm256_set1_ps(foreground[1]), foregroundBlue = _mm256_set1_ps(foreground[2]);
+
+    qsizetype i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        const __m256 lightness = _mm256_cvtepi32_ps(grayAvx2(v));
+        const __m256i r = _mm256_and_si256(_mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(scaleRed, lightness), foregroundRed)), byteMask);
+        const __m256i g = _mm256_and_si256(_mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(scaleGreen, lightness), foregroundGreen)), byteMask);
+        const __m256i b = _mm256_and_si256(_mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(scaleBlue, lightness), foregroundBlue)), byteMask);
+        const __m256i result = _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(v, alphaMask), _mm256_slli_epi32(r, 16)), _mm256_or_si256(_mm256_slli_epi32(g, 8), b));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + i), result);
+    }
+    return i;
+}
+
+COLORFILTERS_TARGET_AVX2 qsizetype invertLightnessAvx2(QRgb *data, qsizetype count)
+{
+    const __m256i alphaMask = _mm256_set1_epi32(0xff000000);
+    const __m256i colorMask = _mm256_set1_epi32(0x00ffffff);
+    const __m256i byteMask = _mm256_set1_epi32(0xff);
+
+    qsizetype i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        const __m256i color = _mm256_and_si256(v, colorMask);
+        const __m256i g = _mm256_srli_epi32(color, 8);
+        const __m256i r = _mm256_srli_epi32(color, 16);
+        const __m256i max = _mm256_and_si256(_mm256_max_epu8(_mm256_max_epu8(color, g), r), byteMask);
+        const __m256i min = _mm256_and_si256(_mm256_min_epu8(_mm256_min_epu8(color, g), r), byteMask);
+        const __m256i result = _mm256_add_epi8(_mm256_sub_epi8(color, spreadColorAvx2(min)), spreadColorAvx2(_mm256_sub_epi32(byteMask, max)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + i), _mm256_or_si256(result, _mm256_and_si256(v, alphaMask)));
+    }
+    return i;
+}
+
+COLORFILTERS_TARGET_AVX2 qsizetype invertLumaGrayAvx2(QRgb *data, qsizetype count)
+{
+    const __m256i colorMask = _mm256_set1_epi32(0x00ffffff);
+    const __m256i byteMask = _mm256_set1_epi32(0xff);
+
+    qsizetype i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        const __m256i color = _mm256_and_si256(v, colorMask);
+        const __m256i isGray = _mm256_cmpeq_epi32(color, spreadColorAvx2(_mm256_and_si256(v, byteMask)));
+        if (_mm256_movemask_epi8(isGray) != -1) {
+            break;
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + i), _mm256_xor_si256(v, colorMask));
+    }
+    return i;
+}
+
+COLORFILTERS_TARGET_AVX2 qsizetype hueShiftPositiveAvx2(QRgb *data, qsizetype count)
+{
+    const __m256i alphaMask = _mm256_set1_epi32(0xff000000);
+    const __m256i byteMask = _mm256_set1_epi32(0xff);
+    const __m256i shortMask = _mm256_set1_epi32(0xffff);
+
+    qsizetype i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        const __m256i result = _mm256_or_si256(_mm256_and_si256(v, alphaMask), _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(v, byteMask), 16), _mm256_and_si256(_mm256_srli_epi32(v, 8), shortMask)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + i), result);
+    }
+    return i;
+}
+
+COLORFILTERS_TARGET_AVX2 qsizetype hueShiftNegativeAvx2(QRgb *data, qsizetype count)
+{
+    const __m256i alphaMask = _mm256_set1_epi32(0xff000000);
+    const __m256i byteMask = _mm256_set1_epi32(0xff);
+    const __m256i shortMask = _mm256_set1_epi32(0xffff);
+
+    qsizetype i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        const __m256i result = _mm256_or_si256(_mm256_and_si256(v, alphaMask), _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(v, shortMask), 8), _mm256_and_si256(_mm256_srli_epi32(v, 16), byteMask)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + i), result);
+    }
+    return i;
+}
+#endif
+
+#ifdef COLORFILTERS_NEON
+// vld4q_u8 splits 16 pixels into their blue, green, red and alpha bytes
+
+qsizetype invertLightnessNeon(QRgb *data, qsizetype count)
+{
+    qsizetype i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8_t *pixels = reinterpret_cast<uint8_t *>(data + i);
+        uint8x16x4_t v = vld4q_u8(pixels);
+        const uint8x16_t max = vmaxq_u8(vmaxq_u8(v.val[0], v.val[1]), v.val[2]);
+        const uint8x16_t min = vminq_u8(vminq_u8(v.val[0], v.val[1]), v.val[2]);
+        const uint8x16_t inverseMax = vmvnq_u8(max);
+        for (int c = 0; c < 3; ++c) {
+            v.val[c] = vaddq_u8(vsubq_u8(v.val[c], min), inverseMax);
+        }
+        vst4q_u8(pixels, v);
+    }
+    return i;
+}
+
+qsizetype invertLumaGrayNeon(QRgb *data, qsizetype count)
+{
+    qsizetype i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8_t *pixels = reinterpret_cast<uint8_t *>(data + i);
+        uint8x16x4_t v = vld4q_u8(pixels);
+        const uint8x16_t isGray = vandq_u8(vceqq_u8(v.val[0], v.val[1]), vceqq_u8(v.val[1], v.val[2]));
+        if (vminvq_u8(isGray) != 0xff) {
+            break;
+        }
+        for (int c = 0; c < 3; ++c) {
+            v.val[c] = vmvnq_u8(v.val[c]);
+        }
+        vst4q_u8(pixels, v);
+    }
+    return i;
+}
+
+qsizetype hueShiftPositiveNeon(QRgb *data, qsizetype count)
+{
+    qsizetype i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8_t *pixels = reinterpret_cast<uint8_t *>(data + i);
+        const uint8x16x4_t v = vld4q_u8(pixels);
+        const uint8x16x4_t result = {{v.val[1], v.val[2], v.val[0], v.val[3]}};
+        vst4q_u8(pixels, result);
+    }
+    return i;
+}
+
+qsizetype hueShiftNegativeNeon(QRgb *data, qsizetype count)
+{
+    qsizetype i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8_t *pixels = reinterpret_cast<uint8_t *>(data + i);
+        const uint8x16x4_t v = vld4q_u8(pixels);
+        const uint8x16x4_t result = {{v.val[2], v.val[0], v.val[1], v.val[3]}};
+        vst4q_u8(pixels, result);
+    }
+    return i;
+}
+#endif
+}
+
+namespace ColorFilters
+{
+bool setKernels(Kernels newKernels)
+{
+    bool available = newKernels == PlainKernels;
+#ifdef COLORFILTERS_SSE2
+    available = available || newKernels == Sse2Kernels;
+#endif
+#ifdef COLORFILTERS_AVX2
+    available = available || (newKernels == Avx2Kernels && hasAvx2());
+#endif
+#ifdef COLORFILTERS_NEON
+    available = available || newKernels == NeonKernels;
+#endif
+    if (!available) {
+        return false;
+    }
+
+    kernels() = newKernels;
+    return true;
+}
+
+void recolor(QRgb *data, qsizetype count, const QColor &foreground, const QColor &background)
+{
+    const float scale[3] = {float(background.redF() - foreground.redF()), float(background.greenF() - foreground.greenF()), float(background.blueF() - foreground.blueF())};
+    const float foregroundColor[3] = {float(foreground.red()), float(foreground.green()), float(foreground.blue())};
+
+    qsizetype i = 0;
+    switch (kernels()) {
+#ifdef COLORFILTERS_AVX2
+    case Avx2Kernels:
+        i = recolorAvx2(data, count, scale, foregroundColor);
+        break;
+#endif
+#ifdef COLORFILTERS_SSE2
+    case Sse2Kernels:
+        i = recolorSse2(data, count, scale, foregroundColor);
+        break;
+#endif
+    default:
+        break;
+    }
+    if (i == count) {
+        return;
+    }
+
+    // the color only depends on the lightness, so compute the 256 possible ones once
+    std::array<QRgb, 256> colors;
+    for (int lightness = 0; lightness < 256; ++lightness) {
+        const float r = scale[0] * lightness + foregroundColor[0];
+        const float g = scale[1] * lightness + foregroundColor[1];
+        const float b = scale[2] * lightness + foregroundColor[2];
+        colors[lightness] = qRgba(r, g, b, 0);
+    }
+    for (; i < count; ++i) {
+        data[i] = colors[qGray(data[i])] | (data[i] & 0xff000000);
+    }
+}
+
+void blackWhite(QRgb *data, qsizetype count, int contrast, int threshold)
+{
+    const int con = contrast;
+    const int thr = 255 - threshold;
+
+    // the result only depends on the gray value, so compute the 256 possible ones once.
+    // The integer divisions don't vectorize, the table is faster than any SIMD version of them
+    std::array<QRgb, 256> colors;
+    for (int gray = 0; gray < 256; ++gray) {
+        // Piecewise linear function of val, through (0, 0), (thr, 128), (255, 255)
+        int val = gray;
+        if (val > thr) {
+            val = 128 + (127 * (val - thr)) / (255 - thr);
+        } else if (val < thr) {
+            val = (128 * val) / thr;
+        }
+
+        // Linear contrast stretching through (thr, thr)
+        if (con > 2) {
+            val = thr + (val - thr) * con / 2;
+            val = qBound(0, val, 255);
+        }
+
+        colors[gray] = qRgba(val, val, val, 0);
+    }
+
+    for (qsizetype i = 0; i < count; ++i) {
+        data[i] = colors[qGray(data[i])] | (data[i] & 0xff000000);
+    }
+}
+
+void invertLightness(QRgb *data, qsizetype count)
+{
+    qsizetype i = 0;
+    switch (kernels()) {
+#ifdef COLORFILTERS_AVX2
+    case Avx2Kernels:
+        i = invertLightnessAvx2(data, count);
+        break;
+#endif
+#ifdef COLORFILTERS_SSE2
+    case Sse2Kernels:
+        i = invertLightnessSse2(data, count);
+        break;
+#endif
+#ifdef COLORFILTERS_NEON
+    case NeonKernels:
+        i = invertLightnessNeon(data, count);
+        break;
+#endif
+    default:
+        break;
+    }
+
+    for (; i < count; ++i) {
+        // Invert lightness of the pixel using the cylindric HSL color model.
+        // Algorithm is based on https://en.wikipedia.org/wiki/HSL_and_HSV#HSL_to_RGB (2019-03-17).
+        // Important simplifications are that inverting lightness does not change chroma and hue.
+        // This means the sector (of the chroma/hue plane) is not changed,
+        // so we can use a linear calculation after determining the sector using qMin() and qMax().
+        uchar R = qRed(data[i]);
+        uchar G = qGreen(data[i]);
+        uchar B = qBlue(data[i]);
+
+        // Get only the needed HSL components. These are chroma C and the common component m.
+        // Get common component m
+        uchar m = qMin(R, qMin(G, B));
+        // Remove m from color components
+        R -= m;
+        G -= m;
+        B -= m;
+        // Get chroma C
+        uchar C = qMax(R, qMax(G, B));
+
+        // Get common component m' after inverting lightness L.
+        // Hint: Lightness L = m + C / 2; L' = 255 - L = 255 - (m + C / 2) => m' = 255 - C - m
+        uchar m_ = 255 - C - m;
+
+        // Add m' to color components
+        R += m_;
+        G += m_;
+        B += m_;
+
+        // Save new color
+        const unsigned A = qAlpha(data[i]);
+        data[i] = qRgba(R, G, B, A);
+    }
+}
+
+void invertLuma(QRgb *data, qsizetype count, float Y_R, float Y_G, float Y_B)
+{
+    qsizetype i = 0;
+    while (i < count) {
+        switch (kernels()) {
+#ifdef COLORFILTERS_AVX2
+        case Avx2Kernels:
+            i += invertLumaGrayAvx2(data + i, count - i);
+            break;
+#endif
+#ifdef COLORFILTERS_SSE2
+        case Sse2Kernels:
+            i += invertLumaGraySse2(data + i, count - i);
+            break;
+#endif
+#ifdef COLORFILTERS_NEON
+        case NeonKernels:
+            i += invertLumaGrayNeon(data + i, count - i);
+            break;
+#endif
+        default:
+            break;
+        }
+
+        // then the pixels around the colored one, or the rest
+        const qsizetype colored = qMin<qsizetype>(count - i, 16);
+        invertLumaPixels(data + i, colored, Y_R, Y_G, Y_B);
+        i += colored;
+    }
+}
+
+void invertLumaPixel(uchar &R, uchar &G, uchar &B, float Y_R, float Y_G, float Y_B)
+{
+    // Invert luma of the pixel using the bicone HCY color model, stretched to cylindric HSY.
+    // Algorithm is based on https://en.wikipedia.org/wiki/HSL_and_HSV#Luma,_chroma_and_hue_to_RGB (2019-03-19).
+    // For an illustration see https://experilous.com/1/product/make-it-colorful/ (2019-03-19).
+
+    // Special case: The algorithm does not work when hue is undefined.
+    if (R == G && G == B) {
+        R = 255 - R;
+        G = 255 - G;
+        B = 255 - B;
+        return;
+    }
+
+    // Get input and output luma Y, Y_inv in range 0..255
+    float Y = R * Y_R + G * Y_G + B * Y_B;
+    float Y_inv = 255 - Y;
+
+    // Get common component m and remove from color components.
+    // This moves us to the bottom faces of the HCY bicone, i. e. we get C and X in R, G, B.
+    uint_fast8_t m = qMin(R, qMin(G, B));
+    R -= m;
+    G -= m;
+    B -= m;
+
+    // We operate in a hue plane of the luma/chroma/hue bicone.
+    // The hue plane is a triangle.
+    // This bicone is distorted, so we can not simply mirror the triangle.
+    // We need to stretch it to a luma/saturation rectangle, so we need to stretch chroma C and the proportional X.
+
+    // First, we need to calculate luma Y_full_C for the outer corner of the triangle.
+    // Then we can interpolate the max chroma C_max, C_inv_max for our luma Y, Y_inv.
+    // Then we calculate C_inv and X_inv by scaling them by the ratio of C_max and C_inv_max.
+
+    // Calculate luma Y_full_C (in range equivalent to gray 0..255) for chroma = 1 at this hue.
+    // Piecewise linear, with the corners of the bicone at the sum of one or two luma coefficients.
+    float Y_full_C;
+    if (R >= B && B >= G) {
+        Y_full_C = 255 * Y_R + 255 * Y_B * B / R;
+    } else if (R >= G && G >= B) {
+        Y_full_C = 255 * Y_R + 255 * Y_G * G / R;
+    } else if (G >= R && R >= B) {
+        Y_full_C = 255 * Y_G + 255 * Y_R * R / G;
+    } else if (G >= B && B >= R) {
+        Y_full_C = 255 * Y_G + 255 * Y_B * B / G;
+    } else if (B >= G && G >= R) {
+        Y_full_C = 255 * Y_B + 255 * Y_G * G / B;
+    } else {
+        Y_full_C = 255 * Y_B + 255 * Y_R * R / B;
+    }
+
+    // Calculate C_max, C_inv_max, to scale C and X.
+    float C_max, C_inv_max;
+    if (Y >= Y_full_C) {
+        C_max = Y_inv / (255 - Y_full_C);
+    } else {
+        C_max = Y / Y_full_C;
+    }
+    if (Y_inv >= Y_full_C) {
+        C_inv_max = Y / (255 - Y_full_C);
+    } else {
+        C_inv_max = Y_inv / Y_full_C;
+    }
+
+    // Scale C and X. C and X already lie in R, G, B.
+    float C_scale = C_inv_max / C_max;
+    float R_ = R * C_scale;
+    float G_ = G * C_scale;
+    float B_ = B * C_scale;
+
+    // Calculate missing luma (in range 0..255), to get common component m_inv
+    float m_inv = Y_inv - (Y_R * R_ + Y_G * G_ + Y_B * B_);
+
+    // Add m_inv to color components
+    R_ += m_inv;
+    G_ += m_inv;
+    B_ += m_inv;
+
+    // Return colors rounded
+    R = R_ + 0.5;
+    G = G_ + 0.5;
+    B = B_ + 0.5;
+}
+
+void hueShiftPositive(QRgb *data, qsizetype count)
+{
+    qsizetype i = 0;
+    switch (kernels()) {
+#ifdef COLORFILTERS_AVX2
+    case Avx2Kernels:
+        i = hueShiftPositiveAvx2(data, count);
+        break;
+#endif
+#ifdef COLORFILTERS_SSE2
+    case Sse2Kernels:
+        i = hueShiftPositiveSse2(data, count);
+        break;
+#endif
+#ifdef COLORFILTERS_NEON
+    case NeonKernels:
+        i = hueShiftPositiveNeon(data, count);
+        break;
+#endif
+    default:
+        break;
+    }
+
+    for (; i < count; ++i) {
+        uchar R = qRed(data[i]);
+        uchar G = qGreen(data[i]);
+        uchar B = qBlue(data[i]);
+
+        // Save new color
+        const unsigned A = qAlpha(data[i]);
+        data[i] = qRgba(B, R, G, A);
+    }
+}
+
+void hueShiftNegative(QRgb *data, qsizetype count)
+{
+    qsizetype i = 0;
+    switch (kernels()) {
+#ifdef COLORFILTERS_AVX2
+    case Avx2Kernels:
+        i = hueShiftNegativeAvx2(data, count);
+        break;
+#endif
+#ifdef COLORFILTERS_SSE2
+    case Sse2Kernels:
+        i = hueShiftNegativeSse2(data, count);
+        break;
+#endif
+#ifdef COLORFILTERS_NEON
+    case NeonKernels:
+        i = hueShiftNegativeNeon(data, count);
+        break;
+#endif
+    default:
+        break;
+    }
+
+    for (; i < count; ++i) {
+        uchar R = qRed(data[i]);
+        uchar G = qGreen(data[i]);
+        uchar B = qBlue(data[i]);
+
+        // Save new color
+        const unsigned A = qAlpha(data[i]);
+        data[i] = qRgba(G, B, R, A);
+    }
+}
+}
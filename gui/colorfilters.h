@@ -0,0 +1,78 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef OKULAR_COLORFILTERS_H
+#define OKULAR_COLORFILTERS_H
+
+#include <QColor>
+#include <QRgb>
+
+/**
+ * The pixel kernels of the Change Colors accessibility feature.
+ *
+ * They work in place on @p count pixels of an ARGB32_Premultiplied image, keeping the alpha channel.
+ * Where the CPU allows it they process several pixels at a time with SSE2, AVX2 (chosen at runtime)
+ * or NEON, see setKernels(), and fall back to plain loops for the rest. The results are the same as the plain loops.
+ */
+namespace ColorFilters
+{
+/**
+ * The kernels the filters use, by default the best ones the build and the CPU have.
+ */
+enum Kernels {
+    PlainKernels, ///< only the plain loops
+    Sse2Kernels,
+    Avx2Kernels,
+    NeonKernels,
+};
+
+/**
+ * Use @p kernels from now on, so the tests can check all of them on one machine.
+ * Returns false and changes nothing if the build or the CPU doesn't have them.
+ */
+bool setKernels(Kernels kernels);
+
+/**
+ * Collapse color space (from white to black) to a line from @p foreground to @p background.
+ */
+void recolor(QRgb *data, qsizetype count, const QColor &foreground, const QColor &background);
+
+/**
+ * Collapse color space to a line from white to black,
+ * then move from @p threshold to 128 and stretch the line by @p contrast.
+ */
+void blackWhite(QRgb *data, qsizetype count, int contrast, int threshold);
+
+/**
+ * Invert the lightness axis of the HSL color cone.
+ */
+void invertLightness(QRgb *data, qsizetype count);
+
+/**
+ * Inverts luma using the luma coefficients @p Y_R, @p Y_G, @p Y_B (should sum up to 1),
+ * and assuming linear 8bit RGB color space.
+ */
+void invertLuma(QRgb *data, qsizetype count, float Y_R, float Y_G, float Y_B);
+
+/**
+ * Inverts luma of a pixel given in @p R, @p G, @p B,
+ * using the luma coefficients @p Y_R, @p Y_G, @p Y_B (should sum up to 1),
+ * and assuming linear 8bit RGB color space.
+ */
+void invertLumaPixel(uchar &R, uchar &G, uchar &B, float Y_R, float Y_G, float Y_B);
+
+/**
+ * Shifts hue of each pixel by 120 degrees, by simply swapping channels.
+ */
+void hueShiftPositive(QRgb *data, qsizetype count);
+
+/**
+ * Shifts hue of each pixel by 240 degrees, by simply swapping channels.
+ */
+void hueShiftNegative(QRgb *data, qsizetype count);
+}
+
+#endif
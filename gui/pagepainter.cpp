@@ -8,7 +8,9 @@
 
 // qt / kde includes
 #include <QApplication>
+#include <QCache>
 #include <QDebug>
+#include <QHash>
 #include <QIcon>
 #include <QPainter>
 #include <QPalette>
@@ -22,6 +24,7 @@
 #include <memory>
 
 // local includes
+#include "colorfilters.h"
 #include "core/annotations.h"
 #include "core/observer.h"
 #include "core/page.h"
@@ -36,6 +39,32 @@
 
 Q_GLOBAL_STATIC_WITH_ARGS(QPixmap, busyPixmap, (QIcon::fromTheme(QLatin1String("okular")).pixmap(48)))
 
+// Pixmaps with the color mode applied, keyed by the cache key of the original pixmap.
+// A new or changed pixmap gets a new cache key, the entries of the pixmaps the pages
+// deleted are never looked up again and go as the least recently used ones
+struct ColorModeCache {
+    // cost in KiB
+    QCache<qint64, QPixmap> pixmaps {0};
+    size_t settingsHash = 0;
+};
+Q_GLOBAL_STATIC(ColorModeCache, colorModeCache)
+
+// in KiB, the filtered pixmaps come on top of the pixmaps the document keeps, so follow its memory profile
+static qint64 colorModeCacheSize()
+{
+    switch (Okular::SettingsCore::memoryLevel()) {
+    case Okular::SettingsCore::EnumMemoryLevel::Low:
+        return 0;
+    case Okular::SettingsCore::EnumMemoryLevel::Normal:
+        return 64 * 1024;
+    case Okular::SettingsCore::EnumMemoryLevel::Aggressive:
+        return 128 * 1024;
+    case Okular::SettingsCore::EnumMemoryLevel::Greedy:
+        return 256 * 1024;
+    }
+    return 64 * 1024;
+}
+
 #define TEXTANNOTATION_ICONSIZE 24
 
 inline QPen buildPen(const Okular::Annotation *ann, double width, const QColor &color)
@@ -253,10 +282,11 @@ void PagePainter::paintCroppedPageOnPainter(QPainter *destPainter,
     }
     /** 4B -- BUFFERED FLOW. IMAGE PAINTING + OPERATIONS. QPAINTER OVER PIXMAP  **/
     else {
-        // the image over which we are going to draw
+        // the image over which we are going to draw. The pixmaps come with the color
+        // mode already applied, and the backgroundColor is the paper color after it
         QImage backImage = QImage(dLimits.width(), dLimits.height(), QImage::Format_ARGB32_Premultiplied);
         backImage.setDevicePixelRatio(dpr);
-        backImage.fill(paperColor);
+        backImage.fill(bufferAccessibility ? backgroundColor : paperColor);
         QPainter p(&backImage);
 
         if (hasTilesManager) {
@@ -269,57 +299,27 @@ void PagePainter::paintCroppedPageOnPainter(QPainter *destPainter,
                 const QRect dLimitsInTile = dLimits & dTileRect;
 
                 if (!limitsInTile.isEmpty()) {
-                    QPixmap *tilePixmap = tile.pixmap();
+                    const QPixmap tilePixmap = bufferAccessibility ? colorModePixmap(*tile.pixmap()) : *tile.pixmap();
 
-                    if (tilePixmap->width() == dTileRect.width() && tilePixmap->height() == dTileRect.height()) {
-                        p.drawPixmap(limitsInTile.translated(-limits.topLeft()), *tilePixmap, dLimitsInTile.translated(-dTileRect.topLeft()));
+                    if (tilePixmap.width() == dTileRect.width() && tilePixmap.height() == dTileRect.height()) {
+                        p.drawPixmap(limitsInTile.translated(-limits.topLeft()), tilePixmap, dLimitsInTile.translated(-dTileRect.topLeft()));
                     } else {
-                        const double xScale = tilePixmap->width() / (double)dTileRect.width();
-                        const double yScale = tilePixmap->height() / (double)dTileRect.height();
+                        const double xScale = tilePixmap.width() / (double)dTileRect.width();
+                        const double yScale = tilePixmap.height() / (double)dTileRect.height();
                         const QTransform transform(xScale, 0, 0, yScale, 0, 0);
-                        p.drawPixmap(limitsInTile.translated(-limits.topLeft()), *tilePixmap, transform.mapRect(dLimitsInTile).translated(-transform.mapRect(dTileRect).topLeft()));
+                        p.drawPixmap(limitsInTile.translated(-limits.topLeft()), tilePixmap, transform.mapRect(dLimitsInTile).translated(-transform.mapRect(dTileRect).topLeft()));
                     }
                 }
             }
         } else {
             // 4B.1. draw the page pixmap: normal or scaled
-
-            p.drawPixmap(QRectF(0, 0, limits.width(), limits.height()), pixmap.scaled(dScaledWidth, dScaledHeight), dLimitsInPixmap);
+            // 4B.2. with the accessibility settings applied, see colorModePixmap()
+            const QPixmap pagePixmap = bufferAccessibility ? colorModePixmap(pixmap) : pixmap;
+            p.drawPixmap(QRectF(0, 0, limits.width(), limits.height()), pagePixmap.scaled(dScaledWidth, dScaledHeight), dLimitsInPixmap);
         }
 
         p.end();
 
-        // 4B.2. modify pixmap following accessibility settings
-        if (bufferAccessibility) {
-            switch (Okular::SettingsCore::renderMode()) {
-            case Okular::SettingsCore::EnumRenderMode::Inverted:
-                // Invert image pixels using QImage internal function
-                backImage.invertPixels(QImage::InvertRgb);
-                break;
-            case Okular::SettingsCore::EnumRenderMode::Recolor:
-                recolor(&backImage, Okular::Settings::recolorForeground(), Okular::Settings::recolorBackground());
-                break;
-            case Okular::SettingsCore::EnumRenderMode::BlackWhite:
-                blackWhite(&backImage, Okular::Settings::bWContrast(), Okular::Settings::bWThreshold());
-                break;
-            case Okular::SettingsCore::EnumRenderMode::InvertLightness:
-                invertLightness(&backImage);
-                break;
-            case Okular::SettingsCore::EnumRenderMode::InvertLuma:
-                invertLuma(&backImage, 0.2126, 0.7152, 0.0722); // sRGB / Rec. 709 luma coefficients
-                break;
-            case Okular::SettingsCore::EnumRenderMode::InvertLumaSymmetric:
-                invertLuma(&backImage, 0.3333, 0.3334, 0.3333); // Symmetric coefficients, to keep colors saturated.
-                break;
-            case Okular::SettingsCore::EnumRenderMode::HueShiftPositive:
-                hueShiftPositive(&backImage);
-                break;
-            case Okular::SettingsCore::EnumRenderMode::HueShiftNegative:
-                hueShiftNegative(&backImage);
-                break;
-            }
-        }
-
         // 4B.3. highlight rects in page
         // draw highlights that are inside the 'limits' paint region
         for (const auto &highlight : std::as_const(bufferedHighlights)) {
@@ -708,66 +708,81 @@ void PagePainter::paintCroppedPageOnPainter(QPainter *destPainter,
     }
 }
 
-void PagePainter::recolor(QImage *image, const QColor &foreground, const QColor &background)
+void PagePainter::changeImageColors(QImage *image)
 {
-    if (image->format() != QImage::Format_ARGB32_Premultiplied) {
-        qCWarning(OkularUiDebug) << "Wrong image format! Converting...";
-        *image = image->convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    switch (Okular::SettingsCore::renderMode()) {
+    case Okular::SettingsCore::EnumRenderMode::Inverted:
+        // Invert image pixels using QImage internal function
+        image->invertPixels(QImage::InvertRgb);
+        break;
+    case Okular::SettingsCore::EnumRenderMode::Recolor:
+        recolor(image, Okular::Settings::recolorForeground(), Okular::Settings::recolorBackground());
+        break;
+    case Okular::SettingsCore::EnumRenderMode::BlackWhite:
+        blackWhite(image, Okular::Settings::bWContrast(), Okular::Settings::bWThreshold());
+        break;
+    case Okular::SettingsCore::EnumRenderMode::InvertLightness:
+        invertLightness(image);
+        break;
+    case Okular::SettingsCore::EnumRenderMode::InvertLuma:
+        invertLuma(image, 0.2126, 0.7152, 0.0722); // sRGB / Rec. 709 luma coefficients
+        break;
+    case Okular::SettingsCore::EnumRenderMode::InvertLumaSymmetric:
+        invertLuma(image, 0.3333, 0.3334, 0.3333); // Symmetric coefficients, to keep colors saturated.
+        break;
+    case Okular::SettingsCore::EnumRenderMode::HueShiftPositive:
+        hueShiftPositive(image);
+        break;
+    case Okular::SettingsCore::EnumRenderMode::HueShiftNegative:
+        hueShiftNegative(image);
+        break;
     }
+}
 
-    Q_ASSERT(image->format() == QImage::Format_ARGB32_Premultiplied);
-
-    const float scaleRed = background.redF() - foreground.redF();
-    const float scaleGreen = background.greenF() - foreground.greenF();
-    const float scaleBlue = background.blueF() - foreground.blueF();
-
-    const int foreground_red = foreground.red();
-    const int foreground_green = foreground.green();
-    const int foreground_blue = foreground.blue();
-
-    QRgb *data = reinterpret_cast<QRgb *>(image->bits());
-    const int pixels = image->width() * image->height();
-
-    for (int i = 0; i < pixels; ++i) {
-        const int lightness = qGray(data[i]);
+QPixmap PagePainter::colorModePixmap(const QPixmap &pixmap)
+{
+    const size_t settingsHash = qHashMulti(0,
+                                           Okular::SettingsCore::renderMode(),
+                                           Okular::Settings::recolorForeground().rgba(),
+                                           Okular::Settings::recolorBackground().rgba(),
+                                           Okular::Settings::bWContrast(),
+                                           Okular::Settings::bWThreshold());
+    if (settingsHash != colorModeCache->settingsHash) {
+        colorModeCache->pixmaps.clear();
+        colorModeCache->settingsHash = settingsHash;
+    }
+    colorModeCache->pixmaps.setMaxCost(colorModeCacheSize());
 
-        const float r = scaleRed * lightness + foreground_red;
-        const float g = scaleGreen * lightness + foreground_green;
-        const float b = scaleBlue * lightness + foreground_blue;
+    if (const QPixmap *cached = colorModeCache->pixmaps.object(pixmap.cacheKey())) {
+        return *cached;
+    }
 
-        const unsigned a = qAlpha(data[i]);
-        data[i] = qRgba(r, g, b, a);
+    // the filters run over the page as painted on white paper, like it is without a color mode
+    QImage image(pixmap.size(), QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(pixmap.devicePixelRatio());
+    image.fill(Qt::white);
+    QPainter p(&image);
+    p.drawPixmap(0, 0, pixmap);
+    p.end();
+    changeImageColors(&image);
+
+    const QPixmap result = QPixmap::fromImage(image);
+    if (colorModeCache->pixmaps.maxCost() > 0) {
+        colorModeCache->pixmaps.insert(pixmap.cacheKey(), new QPixmap(result), qMax<qint64>(1, image.sizeInBytes() / 1024));
     }
+    return result;
 }
 
-void PagePainter::blackWhite(QImage *image, int contrast, int threshold)
+void PagePainter::releaseColorModePixmaps()
 {
-    unsigned int *data = reinterpret_cast<unsigned int *>(image->bits());
-    int con = contrast;
-    int thr = 255 - threshold;
-
-    int pixels = image->width() * image->height();
-    for (int i = 0; i < pixels; ++i) {
-        // Piecewise linear function of val, through (0, 0), (thr, 128), (255, 255)
-        int val = qGray(data[i]);
-        if (val > thr) {
-            val = 128 + (127 * (val - thr)) / (255 - thr);
-        } else if (val < thr) {
-            val = (128 * val) / thr;
-        }
-
-        // Linear contrast stretching through (thr, thr)
-        if (con > 2) {
-            val = thr + (val - thr) * con / 2;
-            val = qBound(0, val, 255);
-        }
-
-        const unsigned a = qAlpha(data[i]);
-        data[i] = qRgba(val, val, val, a);
+    if (!colorModeCache.exists()) {
+        return;
     }
+
+    colorModeCache->pixmaps.clear();
 }
 
-void PagePainter::invertLightness(QImage *image)
+void PagePainter::recolor(QImage *image, const QColor &foreground, const QColor &background)
 {
     if (image->format() != QImage::Format_ARGB32_Premultiplied) {
         qCWarning(OkularUiDebug) << "Wrong image format! Converting...";
@@ -777,43 +792,18 @@ void PagePainter::invertLightness(QImage *image)
     Q_ASSERT(image->format() == QImage::Format_ARGB32_Premultiplied);
 
     QRgb *data = reinterpret_cast<QRgb *>(image->bits());
-    int pixels = image->width() * image->height();
-    for (int i = 0; i < pixels; ++i) {
-        // Invert lightness of the pixel using the cylindric HSL color model.
-        // Algorithm is based on https://en.wikipedia.org/wiki/HSL_and_HSV#HSL_to_RGB (2019-03-17).
-        // Important simplifications are that inverting lightness does not change chroma and hue.
-        // This means the sector (of the chroma/hue plane) is not changed,
-        // so we can use a linear calculation after determining the sector using qMin() and qMax().
-        uchar R = qRed(data[i]);
-        uchar G = qGreen(data[i]);
-        uchar B = qBlue(data[i]);
-
-        // Get only the needed HSL components. These are chroma C and the common component m.
-        // Get common component m
-        uchar m = qMin(R, qMin(G, B));
-        // Remove m from color components
-        R -= m;
-        G -= m;
-        B -= m;
-        // Get chroma C
-        uchar C = qMax(R, qMax(G, B));
-
-        // Get common component m' after inverting lightness L.
-        // Hint: Lightness L = m + C / 2; L' = 255 - L = 255 - (m + C / 2) => m' = 255 - C - m
-        uchar m_ = 255 - C - m;
-
-        // Add m' to color components
-        R += m_;
-        G += m_;
-        B += m_;
-
-        // Save new color
-        const unsigned A = qAlpha(data[i]);
-        data[i] = qRgba(R, G, B, A);
-    }
+    const qsizetype pixels = qsizetype(image->width()) * image->height();
+    ColorFilters::recolor(data, pixels, foreground, background);
 }
 
-void PagePainter::invertLuma(QImage *image, float Y_R, float Y_G, float Y_B)
+void PagePainter::blackWhite(QImage *image, int contrast, int threshold)
+{
+    QRgb *data = reinterpret_cast<QRgb *>(image->bits());
+    const qsizetype pixels = qsizetype(image->width()) * image->height();
+    ColorFilters::blackWhite(data, pixels, contrast, threshold);
+}
+
+void PagePainter::invertLightness(QImage *image)
 {
     if (image->format() != QImage::Format_ARGB32_Premultiplied) {
         qCWarning(OkularUiDebug) << "Wrong image format! Converting...";
@@ -823,102 +813,22 @@ void PagePainter::invertLuma(QImage *image, float Y_R, float Y_G, float Y_B)
     Q_ASSERT(image->format() == QImage::Format_ARGB32_Premultiplied);
 
     QRgb *data = reinterpret_cast<QRgb *>(image->bits());
-    int pixels = image->width() * image->height();
-    for (int i = 0; i < pixels; ++i) {
-        uchar R = qRed(data[i]);
-        uchar G = qGreen(data[i]);
-        uchar B = qBlue(data[i]);
-
-        invertLumaPixel(R, G, B, Y_R, Y_G, Y_B);
-
-        // Save new color
-        const unsigned A = qAlpha(data[i]);
-        data[i] = qRgba(R, G, B, A);
-    }
+    const qsizetype pixels = qsizetype(image->width()) * image->height();
+    ColorFilters::invertLightness(data, pixels);
 }
 
-void PagePainter::invertLumaPixel(uchar &R, uchar &G, uchar &B, float Y_R, float Y_G, float Y_B)
+void PagePainter::invertLuma(QImage *image, float Y_R, float Y_G, float Y_B)
 {
-    // Invert luma of the pixel using the bicone HCY color model, stretched to cylindric HSY.
-    // Algorithm is based on https://en.wikipedia.org/wiki/HSL_and_HSV#Luma,_chroma_and_hue_to_RGB (2019-03-19).
-    // For an illustration see https://experilous.com/1/product/make-it-colorful/ (2019-03-19).
-
-    // Special case: The algorithm does not work when hue is undefined.
-    if (R == G && G == B) {
-        R = 255 - R;
-        G = 255 - G;
-        B = 255 - B;
-        return;
-    }
-
-    // Get input and output luma Y, Y_inv in range 0..255
-    float Y = R * Y_R + G * Y_G + B * Y_B;
-    float Y_inv = 255 - Y;
-
-    // Get common component m and remove from color components.
-    // This moves us to the bottom faces of the HCY bicone, i. e. we get C and X in R, G, B.
-    uint_fast8_t m = qMin(R, qMin(G, B));
-    R -= m;
-    G -= m;
-    B -= m;
-
-    // We operate in a hue plane of the luma/chroma/hue bicone.
-    // The hue plane is a triangle.
-    // This bicone is distorted, so we can not simply mirror the triangle.
-    // We need to stretch it to a luma/saturation rectangle, so we need to stretch chroma C and the proportional X.
-
-    // First, we need to calculate luma Y_full_C for the outer corner of the triangle.
-    // Then we can interpolate the max chroma C_max, C_inv_max for our luma Y, Y_inv.
-    // Then we calculate C_inv and X_inv by scaling them by the ratio of C_max and C_inv_max.
-
-    // Calculate luma Y_full_C (in range equivalent to gray 0..255) for chroma = 1 at this hue.
-    // Piecewise linear, with the corners of the bicone at the sum of one or two luma coefficients.
-    float Y_full_C;
-    if (R >= B && B >= G) {
-        Y_full_C = 255 * Y_R + 255 * Y_B * B / R;
-    } else if (R >= G && G >= B) {
-        Y_full_C = 255 * Y_R + 255 * Y_G * G / R;
-    } else if (G >= R && R >= B) {
-        Y_full_C = 255 * Y_G + 255 * Y_R * R / G;
-    } else if (G >= B && B >= R) {
-        Y_full_C = 255 * Y_G + 255 * Y_B * B / G;
-    } else if (B >= G && G >= R) {
-        Y_full_C = 255 * Y_B + 255 * Y_G * G / B;
-    } else {
-        Y_full_C = 255 * Y_B + 255 * Y_R * R / B;
-    }
-
-    // Calculate C_max, C_inv_max, to scale C and X.
-    float C_max, C_inv_max;
-    if (Y >= Y_full_C) {
-        C_max = Y_inv / (255 - Y_full_C);
-    } else {
-        C_max = Y / Y_full_C;
-    }
-    if (Y_inv >= Y_full_C) {
-        C_inv_max = Y / (255 - Y_full_C);
-    } else {
-        C_inv_max = Y_inv / Y_full_C;
+    if (image->format() != QImage::Format_ARGB32_Premultiplied) {
+        qCWarning(OkularUiDebug) << "Wrong image format! Converting...";
+        *image = image->convertToFormat(QImage::Format_ARGB32_Premultiplied);
     }
 
-    // Scale C and X. C and X already lie in R, G, B.
-    float C_scale = C_inv_max / C_max;
-    float R_ = R * C_scale;
-    float G_ = G * C_scale;
-    float B_ = B * C_scale;
-
-    // Calculate missing luma (in range 0..255), to get common component m_inv
-    float m_inv = Y_inv - (Y_R * R_ + Y_G * G_ + Y_B * B_);
-
-    // Add m_inv to color components
-    R_ += m_inv;
-    G_ += m_inv;
-    B_ += m_inv;
+    Q_ASSERT(image->format() == QImage::Format_ARGB32_Premultiplied);
 
-    // Return colors rounded
-    R = R_ + 0.5;
-    G = G_ + 0.5;
-    B = B_ + 0.5;
+    QRgb *data = reinterpret_cast<QRgb *>(image->bits());
+    const qsizetype pixels = qsizetype(image->width()) * image->height();
+    ColorFilters::invertLuma(data, pixels, Y_R, Y_G, Y_B);
 }
 
 void PagePainter::hueShiftPositive(QImage *image)
@@ -931,16 +841,8 @@ void PagePainter::hueShiftPositive(QImage *image)
     Q_ASSERT(image->format() == QImage::Format_ARGB32_Premultiplied);
 
     QRgb *data = reinterpret_cast<QRgb *>(image->bits());
-    int pixels = image->width() * image->height();
-    for (int i = 0; i < pixels; ++i) {
-        uchar R = qRed(data[i]);
-        uchar G = qGreen(data[i]);
-        uchar B = qBlue(data[i]);
-
-        // Save new color
-        const unsigned A = qAlpha(data[i]);
-        data[i] = qRgba(B, R, G, A);
-    }
+    const qsizetype pixels = qsizetype(image->width()) * image->height();
+    ColorFilters::hueShiftPositive(data, pixels);
 }
 
 void PagePainter::hueShiftNegative(QImage *image)
@@ -953,16 +855,8 @@ void PagePainter::hueShiftNegative(QImage *image)
     Q_ASSERT(image->format() == QImage::Format_ARGB32_Premultiplied);
 
     QRgb *data = reinterpret_cast<QRgb *>(image->bits());
-    int pixels = image->width() * image->height();
-    for (int i = 0; i < pixels; ++i) {
-        uchar R = qRed(data[i]);
-        uchar G = qGreen(data[i]);
-        uchar B = qBlue(data[i]);
-
-        // Save new color
-        const unsigned A = qAlpha(data[i]);
-        data[i] = qRgba(G, B, R, A);
-    }
+    const qsizetype pixels = qsizetype(image->width()) * image->height();
+    ColorFilters::hueShiftNegative(data, pixels);
 }
 
 void PagePainter::drawShapeOnImage(QImage &image, const NormalizedPath &normPath, bool closeShape, const QPen &pen, const QBrush &brush, double penWidthMultiplier, RasterOperation op
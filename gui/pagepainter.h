@@ -15,6 +15,7 @@
 #include "core/area.h" // for NormalizedPoint
 
 class QPainter;
+class QPixmap;
 class QRect;
 namespace Okular
 {
@@ -68,8 +69,27 @@ public:
                                           const Okular::NormalizedRect &crop,
                                           Okular::NormalizedPoint *viewPortPoint);
 
+    /**
+     * Drop the cached color mode pixmaps, e.g. when a document is closed or
+     * its pixmaps are cleared.
+     */
+    static void releaseColorModePixmaps();
+
 private:
     // BEGIN Change Colors feature
+    /**
+     * Apply the color mode of the accessibility settings to @p image.
+     */
+    static void changeImageColors(QImage *image);
+
+    /**
+     * Return @p pixmap, drawn over white, with the color mode applied.
+     * The result is cached by the cache key of @p pixmap, so every rendered pixmap or tile
+     * is filtered once instead of on every paint. Changing the color settings drops the cache.
+     * The cache size follows the memory profile, nothing is cached with the low one.
+     */
+    static QPixmap colorModePixmap(const QPixmap &pixmap);
+
     /**
      * Collapse color space (from white to black) to a line from @p foreground to @p background.
      */
@@ -88,12 +108,6 @@ private:
      * and assuming linear 8bit RGB color space.
      */
     static void invertLuma(QImage *image, float Y_R, float Y_G, float Y_B);
-    /**
-     * Inverts luma of a pixel given in @p R, @p G, @p B,
-     * using the luma coefficients @p Y_R, @p Y_G, @p Y_B (should sum up to 1),
-     * and assuming linear 8bit RGB color space.
-     */
-    static void invertLumaPixel(uchar &R, uchar &G, uchar &B, float Y_R, float Y_G, float Y_B);
     /**
      * Shifts hue of each pixel by 120 degrees, by simply swapping channels.
      */
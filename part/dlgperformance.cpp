@@ -12,6 +12,7 @@
 #include <QComboBox>
 #include <QFormLayout>
 #include <QLabel>
+#include <QSpinBox>
 
 #include "settings_core.h"
 
@@ -49,6 +50,31 @@ DlgPerformance::DlgPerformance(QWidget *parent)
 
     layout->addRow(new QLabel(this));
 
+    // BEGIN Checkbox and spinbox: rendered pages cache
+    QCheckBox *usePersistentPageCache = new QCheckBox(this);
+    usePersistentPageCache->setText(i18nc("@option:check Config dialog, performance page", "Keep rendered pages on disk"));
+    usePersistentPageCache->setToolTip(i18nc("@info:tooltip Config dialog, performance page", "Reopening a document shows the pages already rendered once without rendering them again."));
+    usePersistentPageCache->setObjectName(QStringLiteral("kcfg_PersistentPageCache"));
+    layout->addRow(i18nc("@label Config dialog, performance page", "Disk cache:"), usePersistentPageCache);
+
+    QSpinBox *persistentPageCacheSize = new QSpinBox(this);
+    persistentPageCacheSize->setSuffix(i18nc("@item:valuesuffix Config dialog, performance page, size of the rendered pages cache", " MiB"));
+    persistentPageCacheSize->setObjectName(QStringLiteral("kcfg_PersistentPageCacheSize"));
+    persistentPageCacheSize->setEnabled(false);
+    connect(usePersistentPageCache, &QCheckBox::toggled, persistentPageCacheSize, &QSpinBox::setEnabled);
+    layout->addRow(i18nc("@label:spinbox Config dialog, performance page", "Disk cache size:"), persistentPageCacheSize);
+    // END Checkbox and spinbox: rendered pages cache
+
+    // BEGIN Checkbox: search index
+    QCheckBox *usePersistentSearchIndex = new QCheckBox(this);
+    usePersistentSearchIndex->setText(i18nc("@option:check Config dialog, performance page", "Index the text of documents on disk"));
+    usePersistentSearchIndex->setToolTip(i18nc("@info:tooltip Config dialog, performance page", "The text of documents is indexed in the background, so searching the whole document only searches the pages that can have a match."));
+    usePersistentSearchIndex->setObjectName(QStringLiteral("kcfg_PersistentSearchIndex"));
+    layout->addRow(i18nc("@label Config dialog, performance page", "Search index:"), usePersistentSearchIndex);
+    // END Checkbox: search index
+
+    layout->addRow(new QLabel(this));
+
     // BEGIN Checkboxes: rendering options
     QCheckBox *useTextAntialias = new QCheckBox(this);
     useTextAntialias->setText(i18nc("@option:check Config dialog, performance page", "Enable text antialias"));
@@ -252,8 +252,28 @@ Okular::Document *FormWidgetsController::document() const
     return m_doc;
 }
 
+bool FormWidgetFactory::hasWidget(const Okular::FormField *ff)
+{
+    switch (ff->type()) {
+    case Okular::FormField::FormButton:
+    case Okular::FormField::FormText:
+    case Okular::FormField::FormChoice:
+        return true;
+    case Okular::FormField::FormSignature: {
+        const Okular::FormFieldSignature *ffs = static_cast<const Okular::FormFieldSignature *>(ff);
+        return ffs->isVisible() && ffs->signatureType() != Okular::FormFieldSignature::UnknownType;
+    }
+    default:
+        return false;
+    }
+}
+
 FormWidgetIface *FormWidgetFactory::createWidget(Okular::FormField *ff, PageView *pageView)
 {
+    if (!hasWidget(ff)) {
+        return nullptr;
+    }
+
     FormWidgetIface *widget = nullptr;
 
     switch (ff->type()) {
@@ -302,9 +322,7 @@ FormWidgetIface *FormWidgetFactory::createWidget(Okular::FormField *ff, PageView
     }
     case Okular::FormField::FormSignature: {
         Okular::FormFieldSignature *ffs = static_cast<Okular::FormFieldSignature *>(ff);
-        if (ffs->isVisible() && ffs->signatureType() != Okular::FormFieldSignature::UnknownType) {
-            widget = new SignatureEdit(ffs, pageView);
-        }
+        widget = new SignatureEdit(ffs, pageView);
         break;
     }
     default:;
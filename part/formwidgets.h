@@ -119,6 +119,11 @@ private:
 class FormWidgetFactory
 {
 public:
+    /**
+     * Whether createWidget() creates a widget for @p ff
+     */
+    static bool hasWidget(const Okular::FormField *ff);
+
     static FormWidgetIface *createWidget(Okular::FormField *ff, PageView *pageView);
 };
 
@@ -63,6 +63,7 @@
 #include <kwidgetsaddons_version.h>
 
 // system includes
+#include <algorithm>
 #include <array>
 #include <math.h>
 #include <stdlib.h>
@@ -82,6 +83,7 @@
 #include "pageviewannotator.h"
 #include "pageviewmouseannotation.h"
 #include "pageviewutils.h"
+#include "prefetchplanner.h"
 #include "toggleactionmenu.h"
 #if HAVE_SPEECH
 #include "tts.h"
@@ -124,6 +126,15 @@ static const int searchTextPreviewLength = 21;
 // When following a link, only a preview of this length will be used to set the text of the action.
 static const int linkTextPreviewLength = 30;
 
+// Documents with more pages than this only have the form and video widgets of the pages near the viewport.
+static const int lazyWidgetsPageCount = 200;
+
+static inline bool isLazyFormField(const Okular::FormField *ff)
+{
+    // radio button groups span pages and undo/redo needs all of their buttons, so buttons are always created
+    return ff->type() != Okular::FormField::FormButton;
+}
+
 static inline double normClamp(double value, double def)
 {
     return (value < 0.0 || value > 1.0) ? def : value;
@@ -155,12 +166,27 @@ public:
     OkularTTS *tts();
 #endif
     QString selectedText() const;
+    QList<PageViewItem *> itemsIntersecting(const QRect &rect) const;
 
     // the document, pageviewItems and the 'visible cache'
     PageView *q;
     Okular::Document *document = nullptr;
     QList<PageViewItem *> items;
     QList<PageViewItem *> visibleItems;
+    // the rows of items of the layout, from top to bottom, to find the items in a rect
+    // without going through all of them. Rebuilt by slotRelayoutPages()
+    struct ItemRow {
+        int top;
+        int bottom;
+        int firstItem;
+        int lastItem;
+    };
+    QList<ItemRow> itemRows;
+    // the form and video widgets of all items need to be moved, not only the visible ones
+    bool itemWidgetsDirty = true;
+    // huge document, the items only have widgets while near the viewport
+    bool lazyItemWidgets = false;
+    QSet<PageViewItem *> itemsWithLazyWidgets;
     MagnifierView *magnifierView = nullptr;
 
     // view layout (columns in Settings), zoom and mouse
@@ -284,6 +310,10 @@ public:
 
     QScroller *scroller = nullptr;
 
+    // Scroll velocity, used to preload the pages the view is scrolling to
+    PrefetchPlanner prefetchPlanner;
+    QElapsedTimer prefetchClock;
+
     bool pinchZoomActive = false;
     // The remaining scroll from the previous zoom event
     QPointF remainingScroll;
@@ -298,6 +328,32 @@ PageViewPrivate::PageViewPrivate(PageView *qq)
 {
 }
 
+QList<PageViewItem *> PageViewPrivate::itemsIntersecting(const QRect &rect) const
+{
+    QList<PageViewItem *> result;
+    if (itemRows.isEmpty()) {
+        // not laid out yet
+        for (PageViewItem *item : std::as_const(items)) {
+            if (item->isVisible() && item->croppedGeometry().intersects(rect)) {
+                result.push_back(item);
+            }
+        }
+        return result;
+    }
+
+    // both the tops and the bottoms of the rows are sorted
+    auto row = std::ranges::partition_point(itemRows, [&rect](const ItemRow &r) { return r.bottom <= rect.top(); });
+    for (; row != itemRows.cend() && row->top <= rect.bottom(); ++row) {
+        for (int i = row->firstItem; i <= row->lastItem; ++i) {
+            PageViewItem *item = items[i];
+            if (item->isVisible() && item->croppedGeometry().intersects(rect)) {
+                result.push_back(item);
+            }
+        }
+    }
+    return result;
+}
+
 FormWidgetsController *PageViewPrivate::formWidgetsController()
 {
     if (!formsWidgetController) {
@@ -1128,32 +1184,115 @@ void PageView::selectAll()
     }
 }
 
+bool PageView::createFormWidget(PageViewItem *item, Okular::FormField *ff, bool canBeFilled)
+{
+    FormWidgetIface *w = FormWidgetFactory::createWidget(ff, this);
+    if (!w) {
+        return false;
+    }
+
+    w->setPageItem(item);
+    w->setFormWidgetsController(d->formWidgetsController());
+    w->setVisibility(false);
+    w->setCanBeFilled(canBeFilled);
+    item->formWidgets().insert(w);
+    return true;
+}
+
+bool PageView::createLazyItemWidgets(PageViewItem *item)
+{
+    if (!d->lazyItemWidgets || d->itemsWithLazyWidgets.contains(item)) {
+        return false;
+    }
+    d->itemsWithLazyWidgets.insert(item);
+
+    const bool allowfillforms = d->document->isAllowed(Okular::AllowFillForms);
+    const QList<Okular::FormField *> pageFields = item->page()->formFields();
+    for (Okular::FormField *ff : pageFields) {
+        if (isLazyFormField(ff)) {
+            createFormWidget(item, ff, allowfillforms);
+        }
+    }
+    item->setFormWidgetsVisible(d->m_formsVisible);
+
+    createAnnotationsVideoWidgets(item, item->page()->annotations());
+    return true;
+}
+
+bool PageView::deleteLazyItemWidgets(PageViewItem *item)
+{
+    // keep the widgets the user is interacting with
+    const QWidget *focusWidget = QApplication::focusWidget();
+    QSet<FormWidgetIface *> &formWidgets = item->formWidgets();
+    for (FormWidgetIface *fwi : std::as_const(formWidgets)) {
+        const QWidget *widget = dynamic_cast<QWidget *>(fwi);
+        if (widget && focusWidget && (widget == focusWidget || widget->isAncestorOf(focusWidget))) {
+            return false;
+        }
+    }
+    const QHash<const Okular::Movie *, VideoWidget *> videoWidgets = item->videoWidgets();
+    for (const VideoWidget *vw : videoWidgets) {
+        if (vw->isPlaying()) {
+            return false;
+        }
+    }
+
+    for (auto it = formWidgets.begin(); it != formWidgets.end();) {
+        if (isLazyFormField((*it)->formField())) {
+            delete *it;
+            it = formWidgets.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    qDeleteAll(videoWidgets);
+    item->videoWidgets().clear();
+
+    d->itemsWithLazyWidgets.remove(item);
+    return true;
+}
+
 void PageView::createAnnotationsVideoWidgets(PageViewItem *item, const QList<Okular::Annotation *> &annotations)
 {
     qDeleteAll(item->videoWidgets());
     item->videoWidgets().clear();
 
+    addAnnotationsVideoWidgets(item, annotations);
+}
+
+bool PageView::addAnnotationsVideoWidgets(PageViewItem *item, const QList<Okular::Annotation *> &annotations)
+{
+    QHash<const Okular::Movie *, VideoWidget *> &videoWidgets = item->videoWidgets();
+    bool added = false;
     for (Okular::Annotation *a : annotations) {
         if (a->subType() == Okular::Annotation::AMovie) {
             Okular::MovieAnnotation *movieAnn = static_cast<Okular::MovieAnnotation *>(a);
-            VideoWidget *vw = new VideoWidget(movieAnn, movieAnn->movie(), d->document, viewport());
-            item->videoWidgets().insert(movieAnn->movie(), vw);
-            vw->pageInitialized();
+            if (!videoWidgets.contains(movieAnn->movie())) {
+                VideoWidget *vw = new VideoWidget(movieAnn, movieAnn->movie(), d->document, viewport());
+                videoWidgets.insert(movieAnn->movie(), vw);
+                vw->pageInitialized();
+                added = true;
+            }
         } else if (a->subType() == Okular::Annotation::ARichMedia) {
             Okular::RichMediaAnnotation *richMediaAnn = static_cast<Okular::RichMediaAnnotation *>(a);
-            VideoWidget *vw = new VideoWidget(richMediaAnn, richMediaAnn->movie(), d->document, viewport());
-            item->videoWidgets().insert(richMediaAnn->movie(), vw);
-            vw->pageInitialized();
+            if (!videoWidgets.contains(richMediaAnn->movie())) {
+                VideoWidget *vw = new VideoWidget(richMediaAnn, richMediaAnn->movie(), d->document, viewport());
+                videoWidgets.insert(richMediaAnn->movie(), vw);
+                vw->pageInitialized();
+                added = true;
+            }
         } else if (a->subType() == Okular::Annotation::AScreen) {
             const Okular::ScreenAnnotation *screenAnn = static_cast<Okular::ScreenAnnotation *>(a);
             Okular::Movie *movie = GuiUtils::renditionMovieFromScreenAnnotation(screenAnn);
-            if (movie) {
+            if (movie && !videoWidgets.contains(movie)) {
                 VideoWidget *vw = new VideoWidget(screenAnn, movie, d->document, viewport());
-                item->videoWidgets().insert(movie, vw);
+                videoWidgets.insert(movie, vw);
                 vw->pageInitialized();
+                added = true;
             }
         }
     }
+    return added;
 }
 
 // BEGIN DocumentObserver inherited methods
@@ -1162,6 +1301,10 @@ void PageView::notifySetup(const QList<Okular::Page *> &pageSet, int setupFlags)
     bool documentChanged = setupFlags & Okular::DocumentObserver::DocumentChanged;
     const bool allowfillforms = d->document->isAllowed(Okular::AllowFillForms);
 
+    if (documentChanged) {
+        PagePainter::releaseColorModePixmaps();
+    }
+
     // reuse current pages if nothing new
     if ((pageSet.count() == d->items.count()) && !documentChanged && !(setupFlags & Okular::DocumentObserver::NewLayoutForPages)) {
         int count = pageSet.count();
@@ -1208,6 +1351,9 @@ void PageView::notifySetup(const QList<Okular::Page *> &pageSet, int setupFlags)
 
                     // For the video widgets we don't really care about reusing them since they don't contain much info so just
                     // create them again
+                    if (d->lazyItemWidgets && !d->itemsWithLazyWidgets.contains(item)) {
+                        continue;
+                    }
                     createAnnotationsVideoWidgets(item, pageSet[i]->annotations());
                     const QHash<const Okular::Movie *, VideoWidget *> videoWidgets = item->videoWidgets();
                     for (VideoWidget *vw : videoWidgets) {
@@ -1235,6 +1381,8 @@ void PageView::notifySetup(const QList<Okular::Page *> &pageSet, int setupFlags)
     qDeleteAll(d->items);
     d->items.clear();
     d->visibleItems.clear();
+    d->itemRows.clear();
+    d->itemsWithLazyWidgets.clear();
     d->pagesWithTextSelection.clear();
     toggleFormWidgets(false);
     if (d->formsWidgetController) {
@@ -1243,6 +1391,7 @@ void PageView::notifySetup(const QList<Okular::Page *> &pageSet, int setupFlags)
 
     bool haspages = !pageSet.isEmpty();
     bool hasformwidgets = false;
+    d->lazyItemWidgets = pageSet.count() > lazyWidgetsPageCount;
     // create children widgets
     for (const Okular::Page *page : pageSet) {
         PageViewItem *item = new PageViewItem(page);
@@ -1252,18 +1401,16 @@ void PageView::notifySetup(const QList<Okular::Page *> &pageSet, int setupFlags)
 #endif
         const QList<Okular::FormField *> pageFields = page->formFields();
         for (Okular::FormField *ff : pageFields) {
-            FormWidgetIface *w = FormWidgetFactory::createWidget(ff, this);
-            if (w) {
-                w->setPageItem(item);
-                w->setFormWidgetsController(d->formWidgetsController());
-                w->setVisibility(false);
-                w->setCanBeFilled(allowfillforms);
-                item->formWidgets().insert(w);
+            if (d->lazyItemWidgets && isLazyFormField(ff)) {
+                hasformwidgets = hasformwidgets || FormWidgetFactory::hasWidget(ff);
+            } else if (createFormWidget(item, ff, allowfillforms)) {
                 hasformwidgets = true;
             }
         }
 
-        createAnnotationsVideoWidgets(item, page->annotations());
+        if (!d->lazyItemWidgets) {
+            createAnnotationsVideoWidgets(item, page->annotations());
+        }
     }
 
     // invalidate layout so relayout/repaint will happen on next viewport change
@@ -1484,6 +1631,10 @@ void PageView::notifyPageChanged(int pageNumber, int changedFlags)
 
     if (changedFlags & DocumentObserver::Annotations) {
         const QList<Okular::Annotation *> annots = d->document->page(pageNumber)->annotations();
+        // the annotations may be loaded after the widgets of the page were created
+        if (pageNumber >= 0 && pageNumber < d->items.count()) {
+            updateAnnotationsVideoWidgets(d->items[pageNumber], annots);
+        }
         const QList<Okular::Annotation *>::ConstIterator annItEnd = annots.end();
         QSet<AnnotWindow *>::Iterator it = d->m_annowindows.begin();
         for (; it != d->m_annowindows.end();) {
@@ -1541,6 +1692,7 @@ void PageView::notifyContentsCleared(int changedFlags)
 {
     // if pixmaps were cleared, re-ask them
     if (changedFlags & DocumentObserver::Pixmap) {
+        PagePainter::releaseColorModePixmaps();
         QMetaObject::invokeMethod(this, "slotRequestVisiblePixmaps", Qt::QueuedConnection);
     }
 }
@@ -1600,6 +1752,7 @@ void PageView::notifyCurrentPageChanged(int previous, int current)
     if (current != -1) {
         PageViewItem *item = d->items.at(current);
         if (item) {
+            ensureLazyItemWidgets(item);
             const QHash<const Okular::Movie *, VideoWidget *> videoWidgetsList = item->videoWidgets();
             for (VideoWidget *videoWidget : videoWidgetsList) {
                 videoWidget->pageEntered();
@@ -3691,13 +3844,9 @@ void PageView::drawDocumentOnPainter(const QRect contentsRect, QPainter *p)
     QRegion remainingArea(contentsRect);
 
     // This loop draws the actual pages
-    // iterate over all items painting the ones intersecting contentsRect
-    for (const PageViewItem *item : std::as_const(d->items)) {
-        // check if a piece of the page intersects the contents rect
-        if (!item->isVisible() || !item->croppedGeometry().intersects(contentsRect)) {
-            continue;
-        }
-
+    // iterate over the items intersecting contentsRect
+    const QList<PageViewItem *> contentsItems = d->itemsIntersecting(contentsRect);
+    for (const PageViewItem *item : contentsItems) {
         // get item and item's outline geometries
         const QRect itemGeometry = item->croppedGeometry();
 
@@ -3736,13 +3885,9 @@ void PageView::drawDocumentOnPainter(const QRect contentsRect, QPainter *p)
     // width of the shadow in device pixels
     static const int shadowWidth = 2 * dpr;
 
-    // iterate over all items painting a black outline and a simple bottom/right gradient
-    for (const PageViewItem *item : std::as_const(d->items)) {
-        // check if a piece of the page intersects the contents rect
-        if (!item->isVisible() || !item->croppedGeometry().intersects(checkRect)) {
-            continue;
-        }
-
+    // iterate over the items intersecting checkRect painting a black outline and a simple bottom/right gradient
+    const QList<PageViewItem *> outlinedItems = d->itemsIntersecting(checkRect);
+    for (const PageViewItem *item : outlinedItems) {
         // get item and item's outline geometries
         const QRect itemGeometry = item->croppedGeometry();
 
@@ -4879,9 +5024,19 @@ void PageView::slotRelayoutPages()
             insertX += colWidth[i];
         }
     }
+    d->itemRows.clear();
+    d->itemWidgetsDirty = true;
+    int indexedRow = -1;
     for (PageViewItem *item : std::as_const(d->items)) {
         int cWidth = colWidth[cIdx], rHeight = rowHeight[rIdx];
         if (continuousView || rIdx == pageRowIdx) {
+            const int rowTop = continuousView ? insertY : origInsertY;
+            if (rIdx != indexedRow) {
+                d->itemRows.push_back({rowTop, rowTop + rHeight, item->pageNumber(), item->pageNumber()});
+                indexedRow = rIdx;
+            } else {
+                d->itemRows.last().lastItem = item->pageNumber();
+            }
             const bool reallyDoCenterFirst = item->pageNumber() == 0 && centerFirstPage;
             const bool reallyDoCenterLast = item->pageNumber() == pageCount - 1 && centerLastPage;
             int actualX = 0;
@@ -4905,7 +5060,7 @@ void PageView::slotRelayoutPages()
                     actualX = insertX + (cWidth - item->croppedWidth()) / 2;
                 }
             }
-            item->moveTo(actualX, (continuousView ? insertY : origInsertY) + (rHeight - item->croppedHeight()) / 2);
+            item->moveTo(actualX, rowTop + (rHeight - item->croppedHeight()) / 2);
             item->setVisible(true);
         } else {
             item->moveTo(0, 0);
@@ -5005,6 +5160,69 @@ static void slotRequestPreloadPixmap(PageView *pageView, const PageViewItem *i,
     }
 }
 
+static void moveItemWidgets(PageViewItem *i, const QRectF &viewportRect)
+{
+    const QRectF viewportRectAtZeroZero(0, 0, viewportRect.width(), viewportRect.height());
+    const QSet<FormWidgetIface *> formWidgetsList = i->formWidgets();
+    for (FormWidgetIface *fwi : formWidgetsList) {
+        Okular::NormalizedRect r = fwi->rect();
+        fwi->moveTo(qRound(i->uncroppedGeometry().left() + i->uncroppedWidth() * r.left) + 1 - viewportRect.left(), qRound(i->uncroppedGeometry().top() + i->uncroppedHeight() * r.top) + 1 - viewportRect.top());
+    }
+    const QHash<const Okular::Movie *, VideoWidget *> videoWidgets = i->videoWidgets();
+    for (VideoWidget *vw : videoWidgets) {
+        const Okular::NormalizedRect r = vw->normGeometry();
+        vw->move(qRound(i->uncroppedGeometry().left() + i->uncroppedWidth() * r.left) + 1 - viewportRect.left(), qRound(i->uncroppedGeometry().top() + i->uncroppedHeight() * r.top) + 1 - viewportRect.top());
+
+        if (vw->isPlaying() && viewportRectAtZeroZero.intersected(vw->geometry()).isEmpty()) {
+            vw->stop();
+            vw->pageLeft();
+        }
+    }
+}
+
+void PageView::updateLazyItemWidgets(const QRectF &viewportRect)
+{
+    // create the widgets of the pages within a viewport height of the viewport, and
+    // recycle the ones of the pages more than three viewport heights away
+    const QRect rect = viewportRect.toRect();
+    const QList<PageViewItem *> nearItems = d->itemsIntersecting(rect.adjusted(0, -rect.height(), 0, rect.height()));
+    const QList<PageViewItem *> keptItemsList = d->itemsIntersecting(rect.adjusted(0, -3 * rect.height(), 0, 3 * rect.height()));
+    const QSet<PageViewItem *> keptItems(keptItemsList.cbegin(), keptItemsList.cend());
+
+    const QSet<PageViewItem *> itemsWithLazyWidgets = d->itemsWithLazyWidgets;
+    for (PageViewItem *item : itemsWithLazyWidgets) {
+        if (!keptItems.contains(item)) {
+            deleteLazyItemWidgets(item);
+        }
+    }
+    for (PageViewItem *item : nearItems) {
+        if (createLazyItemWidgets(item)) {
+            moveItemWidgets(item, viewportRect);
+        }
+    }
+}
+
+void PageView::ensureLazyItemWidgets(PageViewItem *item)
+{
+    if (createLazyItemWidgets(item)) {
+        moveItemWidgets(item, QRectF(horizontalScrollBar()->value(), verticalScrollBar()->value(), viewport()->width(), viewport()->height()));
+    }
+}
+
+void PageView::updateAnnotationsVideoWidgets(PageViewItem *item, const QList<Okular::Annotation *> &annotations)
+{
+    // the lazy widgets of the item are created with the annotations it has then
+    if (d->lazyItemWidgets && !d->itemsWithLazyWidgets.contains(item)) {
+        return;
+    }
+
+    if (addAnnotationsVideoWidgets(item, annotations)) {
+        // size and place the new widgets like the others of the item
+        item->setWHZC(item->croppedWidth(), item->croppedHeight(), item->zoomFactor(), item->crop());
+        moveItemWidgets(item, QRectF(horizontalScrollBar()->value(), verticalScrollBar()->value(), viewport()->width(), viewport()->height()));
+    }
+}
+
 void PageView::slotRequestVisiblePixmaps(int newValue)
 {
     // if requests are blocked (because raised by an unwanted event), exit
@@ -5015,7 +5233,6 @@ void PageView::slotRequestVisiblePixmaps(int newValue)
     // precalc view limits for intersecting with page coords inside the loop
     const bool isEvent = newValue != -1 && !d->blockViewport;
     const QRectF viewportRect(horizontalScrollBar()->value(), verticalScrollBar()->value(), viewport()->width(), viewport()->height());
-    const QRectF viewportRectAtZeroZero(0, 0, viewport()->width(), viewport()->height());
 
     // some variables used to determine the viewport
     int nearPageNumber = -1;
@@ -5025,30 +5242,49 @@ void PageView::slotRequestVisiblePixmaps(int newValue)
     // Margin (in pixels) around the viewport to preload
     const int pixelsToExpand = 512;
 
-    // iterate over all items
-    d->visibleItems.clear();
-    QList<Okular::PixmapRequest *> requestedPixmaps;
-    QList<Okular::VisiblePageRect *> visibleRects;
-    for (PageViewItem *i : std::as_const(d->items)) {
-        const QSet<FormWidgetIface *> formWidgetsList = i->formWidgets();
-        for (FormWidgetIface *fwi : formWidgetsList) {
-            Okular::NormalizedRect r = fwi->rect();
-            fwi->moveTo(qRound(i->uncroppedGeometry().left() + i->uncroppedWidth() * r.left) + 1 - viewportRect.left(), qRound(i->uncroppedGeometry().top() + i->uncroppedHeight() * r.top) + 1 - viewportRect.top());
-        }
-        const QHash<const Okular::Movie *, VideoWidget *> videoWidgets = i->videoWidgets();
-        for (VideoWidget *vw : videoWidgets) {
-            const Okular::NormalizedRect r = vw->normGeometry();
-            vw->move(qRound(i->uncroppedGeometry().left() + i->uncroppedWidth() * r.left) + 1 - viewportRect.left(), qRound(i->uncroppedGeometry().top() + i->uncroppedHeight() * r.top) + 1 - viewportRect.top());
-
-            if (vw->isPlaying() && viewportRectAtZeroZero.intersected(vw->geometry()).isEmpty()) {
-                vw->stop();
-                vw->pageLeft();
-            }
+    // while scrolling, preload more in the direction the view is going and less behind it
+    if (isEvent) {
+        if (!d->prefetchClock.isValid()) {
+            d->prefetchClock.start();
         }
+        d->prefetchPlanner.update(verticalScrollBar()->value(), d->prefetchClock.elapsed());
+    } else {
+        d->prefetchPlanner.reset();
+    }
+    const int marginBefore = d->prefetchPlanner.marginBefore(pixelsToExpand);
+    const int marginAfter = d->prefetchPlanner.marginAfter(pixelsToExpand);
 
-        if (!i->isVisible()) {
-            continue;
+    // only look at the items in the viewport
+    const QList<PageViewItem *> previouslyVisibleItems = d->visibleItems;
+    const QList<PageViewItem *> viewportItems = d->itemsIntersecting(viewportRect.toRect());
+
+    if (d->lazyItemWidgets) {
+        updateLazyItemWidgets(viewportRect);
+    }
+
+    // the form and video widgets move with their pages. After a relayout all of them
+    // need to be moved, otherwise only the ones of the items in the viewport and of
+    // the items that just left it
+    if (d->itemWidgetsDirty) {
+        for (PageViewItem *i : std::as_const(d->items)) {
+            moveItemWidgets(i, viewportRect);
+        }
+        d->itemWidgetsDirty = false;
+    } else {
+        for (PageViewItem *i : previouslyVisibleItems) {
+            if (!viewportItems.contains(i)) {
+                moveItemWidgets(i, viewportRect);
+            }
         }
+        for (PageViewItem *i : viewportItems) {
+            moveItemWidgets(i, viewportRect);
+        }
+    }
+
+    d->visibleItems.clear();
+    QList<Okular::PixmapRequest *> requestedPixmaps;
+    QList<Okular::VisiblePageRect *> visibleRects;
+    for (PageViewItem *i : viewportItems) {
 #ifdef PAGEVIEW_DEBUG
         qWarning() << "checking page" << i->pageNumber();
         qWarning().nospace() << "viewportRect is " << viewportRect << ", page item is " << i->croppedGeometry() << " intersect : " << viewportRect.intersects(i->croppedGeometry());
@@ -5074,11 +5310,11 @@ void PageView::slotRequestVisiblePixmaps(int newValue)
 
         Okular::NormalizedRect expandedVisibleRect = vItem->rect;
         if (i->page()->hasTilesManager(this) && Okular::Settings::memoryLevel() != Okular::Settings::EnumMemoryLevel::Low) {
-            double rectMargin = pixelsToExpand / (double)i->uncroppedHeight();
+            const double rectMargin = pixelsToExpand / (double)i->uncroppedHeight();
             expandedVisibleRect.left = qMax(0.0, vItem->rect.left - rectMargin);
-            expandedVisibleRect.top = qMax(0.0, vItem->rect.top - rectMargin);
+            expandedVisibleRect.top = qMax(0.0, vItem->rect.top - marginBefore / (double)i->uncroppedHeight());
             expandedVisibleRect.right = qMin(1.0, vItem->rect.right + rectMargin);
-            expandedVisibleRect.bottom = qMin(1.0, vItem->rect.bottom + rectMargin);
+            expandedVisibleRect.bottom = qMin(1.0, vItem->rect.bottom + marginAfter / (double)i->uncroppedHeight());
         }
 
         // if the item has not the right pixmap, add a request for it
@@ -5127,30 +5363,46 @@ void PageView::slotRequestVisiblePixmaps(int newValue)
         int pagesToPreload = viewColumns();
 
         // if the greedy option is set, preload all pages
-        if (Okular::SettingsCore::memoryLevel() == Okular::SettingsCore::EnumMemoryLevel::Greedy) {
+        const bool greedy = Okular::SettingsCore::memoryLevel() == Okular::SettingsCore::EnumMemoryLevel::Greedy;
+        if (greedy) {
             pagesToPreload = d->items.count();
         }
 
-        const QRectF adjustedViewportRect = viewportRect.adjusted(0, -pixelsToExpand, 0, pixelsToExpand);
+        // pages behind a fast scrolling view are not preloaded, requests still
+        // queued for them are dropped by requestPixmaps()
+        const int pagesBefore = (greedy || marginBefore > 0) ? pagesToPreload : 0;
+        const int pagesAfter = (greedy || marginAfter > 0) ? pagesToPreload : 0;
+        // in continuous mode, also preload the pages within the margins
+        const bool continuous = getContinuousMode();
+        const bool scrollingUp = d->prefetchPlanner.velocity() < 0;
+
+        const QRectF adjustedViewportRect = viewportRect.adjusted(0, -marginBefore, 0, marginAfter);
         const QRect expandedViewportRect(adjustedViewportRect.x(), adjustedViewportRect.y(), adjustedViewportRect.width(), adjustedViewportRect.height());
 
-        for (int j = 1; j <= pagesToPreload; j++) {
-            // add the page after the 'visible series' in preload
+        for (int j = 1;; j++) {
+            // the page after the 'visible series'
             const int tailRequest = d->visibleItems.last()->pageNumber() + j;
-            if (tailRequest < (int)d->items.count()) {
-                slotRequestPreloadPixmap(this, d->items[tailRequest], expandedViewportRect, &requestedPixmaps);
-            }
+            const bool preloadTail = tailRequest < (int)d->items.count() && (j <= pagesAfter || (continuous && d->items[tailRequest]->croppedGeometry().top() < expandedViewportRect.bottom()));
 
-            // add the page before the 'visible series' in preload
+            // the page before the 'visible series'
             const int headRequest = d->visibleItems.first()->pageNumber() - j;
-            if (headRequest >= 0) {
-                slotRequestPreloadPixmap(this, d->items[headRequest], expandedViewportRect, &requestedPixmaps);
-            }
+            const bool preloadHead = headRequest >= 0 && (j <= pagesBefore || (continuous && d->items[headRequest]->croppedGeometry().bottom() > expandedViewportRect.top()));
 
-            // stop if we've already reached both ends of the document
-            if (headRequest < 0 && tailRequest >= (int)d->items.count()) {
+            // stop when there's nothing left to preload on either side
+            if (!preloadTail && !preloadHead) {
                 break;
             }
+
+            // the page in the scrolling direction goes first
+            if (preloadHead && scrollingUp) {
+                slotRequestPreloadPixmap(this, d->items[headRequest], expandedViewportRect, &requestedPixmaps);
+            }
+            if (preloadTail) {
+                slotRequestPreloadPixmap(this, d->items[tailRequest], expandedViewportRect, &requestedPixmaps);
+            }
+            if (preloadHead && !scrollingUp) {
+                slotRequestPreloadPixmap(this, d->items[headRequest], expandedViewportRect, &requestedPixmaps);
+            }
         }
     }
 
@@ -5816,6 +6068,7 @@ void PageView::slotProcessMovieAction(const Okular::MovieAction *action)
     if (!item) {
         return;
     }
+    ensureLazyItemWidgets(item);
 
     VideoWidget *vw = item->videoWidgets().value(movie);
     if (!vw) {
@@ -5854,6 +6107,7 @@ void PageView::slotProcessRenditionAction(const Okular::RenditionAction *action)
     if (!item) {
         return;
     }
+    ensureLazyItemWidgets(item);
 
     VideoWidget *vw = item->videoWidgets().value(movie);
     if (!vw) {
@@ -5927,12 +6181,16 @@ void PageView::highlightSignatureFormWidget(const Okular::FormFieldSignature *fo
 {
     QList<PageViewItem *>::const_iterator dIt = d->items.constBegin(), dEnd = d->items.constEnd();
     for (; dIt != dEnd; ++dIt) {
+        if (d->lazyItemWidgets && (*dIt)->page()->formFields().contains(form)) {
+            ensureLazyItemWidgets(*dIt);
+        }
         const QSet<FormWidgetIface *> fwi = (*dIt)->formWidgets();
         for (FormWidgetIface *fw : fwi) {
             if (fw->formField() == form) {
                 SignatureEdit *widget = static_cast<SignatureEdit *>(fw);
                 widget->setDummyMode(true);
-                QTimer::singleShot(250, this, [=] { widget->setDummyMode(false); });
+                // the widget may be recycled when its page scrolls away
+                QTimer::singleShot(250, widget, [widget] { widget->setDummyMode(false); });
                 return;
             }
         }
@@ -275,6 +275,17 @@ private:
     bool mouseReleaseOverLink(const Okular::ObjectRect *rect) const;
 
     void createAnnotationsVideoWidgets(PageViewItem *item, const QList<Okular::Annotation *> &annotations);
+    bool addAnnotationsVideoWidgets(PageViewItem *item, const QList<Okular::Annotation *> &annotations);
+    // for the annotations loaded after the widgets of the item
+    void updateAnnotationsVideoWidgets(PageViewItem *item, const QList<Okular::Annotation *> &annotations);
+    bool createFormWidget(PageViewItem *item, Okular::FormField *ff, bool canBeFilled);
+
+    // widgets of huge documents, created only for the pages near the viewport
+    bool createLazyItemWidgets(PageViewItem *item);
+    bool deleteLazyItemWidgets(PageViewItem *item);
+    void updateLazyItemWidgets(const QRectF &viewportRect);
+    // for the actions on the widgets of a page that may not have been near the viewport yet
+    void ensureLazyItemWidgets(PageViewItem *item);
 
     // Update speed of animated smooth scroll transitions
     void updateSmoothScrollAnimationSpeed();
@@ -0,0 +1,98 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#include "prefetchplanner.h"
+
+#include <QtMath>
+
+// Samples further apart than this mean the view stopped in between
+static const qint64 maximumSampleInterval = 250;
+// Below this velocity (pixels per msec) the view is considered still
+static const double idleVelocity = 0.05;
+// At this velocity nothing behind the viewport is preloaded anymore
+static const double fastVelocity = 2.0;
+// How far ahead of the viewport pages are preloaded, in msecs of scrolling
+static const double lookAheadTime = 500.0;
+// The margin ahead never gets bigger than this many times the base margin
+static const int maximumMarginFactor = 10;
+
+PrefetchPlanner::PrefetchPlanner()
+{
+    reset();
+}
+
+void PrefetchPlanner::reset()
+{
+    m_hasPosition = false;
+    m_position = 0;
+    m_time = 0;
+    m_velocity = 0.0;
+}
+
+void PrefetchPlanner::update(int position, qint64 msecs)
+{
+    const qint64 interval = msecs - m_time;
+    if (!m_hasPosition || interval > maximumSampleInterval || interval < 0) {
+        m_hasPosition = true;
+        m_position = position;
+        m_time = msecs;
+        m_velocity = 0.0;
+        return;
+    }
+
+    // Several scroll events in the same msec, wait for the next one to measure them together
+    if (interval == 0) {
+        return;
+    }
+
+    const double sample = double(position - m_position) / interval;
+    if (m_velocity == 0.0 || sample * m_velocity < 0) {
+        // Follow a start or a change of direction immediately
+        m_velocity = sample;
+    } else {
+        m_velocity = (m_velocity + sample) / 2.0;
+    }
+    m_position = position;
+    m_time = msecs;
+}
+
+double PrefetchPlanner::velocity() const
+{
+    return m_velocity;
+}
+
+int PrefetchPlanner::marginBefore(int baseMargin) const
+{
+    if (!isMoving()) {
+        return baseMargin;
+    }
+    return m_velocity < 0 ? marginAhead(baseMargin) : marginBehind(baseMargin);
+}
+
+int PrefetchPlanner::marginAfter(int baseMargin) const
+{
+    if (!isMoving()) {
+        return baseMargin;
+    }
+    return m_velocity > 0 ? marginAhead(baseMargin) : marginBehind(baseMargin);
+}
+
+bool PrefetchPlanner::isMoving() const
+{
+    return qAbs(m_velocity) >= idleVelocity;
+}
+
+int PrefetchPlanner::marginAhead(int baseMargin) const
+{
+    const double extra = qMin(qAbs(m_velocity) * lookAheadTime, double(maximumMarginFactor * baseMargin));
+    return baseMargin + qRound(extra);
+}
+
+int PrefetchPlanner::marginBehind(int baseMargin) const
+{
+    const double factor = qMax(0.0, 1.0 - qAbs(m_velocity) / fastVelocity);
+    return qRound(baseMargin * factor);
+}
@@ -0,0 +1,65 @@
+/*
+    SPDX-FileCopyrightText: 2026 Okular developers
+
+    SPDX-License-Identifier: GPL-2.0-or-later
+*/
+
+#ifndef PREFETCHPLANNER_H
+#define PREFETCHPLANNER_H
+
+#include <QtGlobal>
+
+/**
+ * Decides how far around the viewport pages are preloaded, depending on how
+ * the view is scrolling.
+ *
+ * The planner follows the vertical scroll position and keeps a smoothed
+ * scroll velocity. While the view is still the preload margin is the same
+ * on both sides. While scrolling, the margin in the direction of travel grows
+ * with the velocity, so pages are requested before they come into view,
+ * and the margin behind shrinks, so no time is spent on pages the view is
+ * leaving.
+ */
+class PrefetchPlanner
+{
+public:
+    PrefetchPlanner();
+
+    /**
+     * Forgets the scroll history, e.g. because the layout changed and
+     * the positions aren't comparable anymore.
+     */
+    void reset();
+
+    /**
+     * Records the vertical scroll @p position (in pixels) at time @p msecs.
+     */
+    void update(int position, qint64 msecs);
+
+    /**
+     * The smoothed scroll velocity in pixels per millisecond, positive when scrolling down.
+     */
+    double velocity() const;
+
+    /**
+     * The margin to preload above the viewport, for a @p baseMargin used when not scrolling.
+     */
+    int marginBefore(int baseMargin) const;
+
+    /**
+     * The margin to preload below the viewport, for a @p baseMargin used when not scrolling.
+     */
+    int marginAfter(int baseMargin) const;
+
+private:
+    bool isMoving() const;
+    int marginAhead(int baseMargin) const;
+    int marginBehind(int baseMargin) const;
+
+    bool m_hasPosition;
+    int m_position;
+    qint64 m_time;
+    double m_velocity;
+};
+
+#endif